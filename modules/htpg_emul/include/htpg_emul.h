@@ -0,0 +1,61 @@
+#ifndef HTPG_EMUL_H
+#define HTPG_EMUL_H
+
+#include <stdint.h>
+
+/**
+ * @file htpg_emul.h
+ * @brief Waveform control of the emulated HT, pressure and IMU sensors.
+ *
+ * Each emulated channel is a function of uptime:
+ * @code
+ *  value(t) = offset + amplitude * sin(2 pi t / period) + noise + pulse
+ * @endcode
+ * with uniform noise in [-noise, +noise] and an optional one-shot pulse
+ * added for a given duration (e.g. to fire the burst trigger). Values are
+ * micro-units of the Zephyr channel (µ°C, µ%RH, µkPa, µm/s^2, µrad/s), as
+ * in sensor_fixp.h. The emulators convert them to register counts with the
+ * scale the driver programmed, so the driver's own conversion is exercised.
+ */
+
+/** @brief Emulated channels. */
+enum htpg_emul_chan {
+	HTPG_EMUL_TEMP,		/**< HTS221 temperature, µ°C. */
+	HTPG_EMUL_HUM,		/**< HTS221 humidity, µ%RH. */
+	HTPG_EMUL_PRESS,	/**< LPS22HB pressure, µkPa. */
+	HTPG_EMUL_AX,		/**< LSM6DSL accel X, µm/s^2. */
+	HTPG_EMUL_AY,		/**< LSM6DSL accel Y, µm/s^2. */
+	HTPG_EMUL_AZ,		/**< LSM6DSL accel Z, µm/s^2. */
+	HTPG_EMUL_GX,		/**< LSM6DSL gyro X, µrad/s. */
+	HTPG_EMUL_GY,		/**< LSM6DSL gyro Y, µrad/s. */
+	HTPG_EMUL_GZ,		/**< LSM6DSL gyro Z, µrad/s. */
+	HTPG_EMUL_CHAN_COUNT
+};
+
+/** @brief Waveform of one channel. */
+struct htpg_emul_wave {
+	int32_t		offset;		/**< Constant part. */
+	int32_t		amplitude;	/**< Sine amplitude (0: none). */
+	uint32_t	period_ms;	/**< Sine period (0: none). */
+	int32_t		noise;		/**< Uniform noise half-width (0: none). */
+};
+
+/** @brief Replace the waveform of @p ch. */
+void htpg_emul_wave_set(enum htpg_emul_chan ch, const struct htpg_emul_wave *w);
+
+/** @brief Current waveform of @p ch. */
+void htpg_emul_wave_get(enum htpg_emul_chan ch, struct htpg_emul_wave *w);
+
+/**
+ * @brief Add @p delta to @p ch for the next @p ms milliseconds.
+ */
+void htpg_emul_pulse(enum htpg_emul_chan ch, int32_t delta, uint32_t ms);
+
+/**
+ * @brief Evaluate @p ch at uptime @p t_us.
+ *
+ * @return Value in micro-units.
+ */
+int32_t htpg_emul_value(enum htpg_emul_chan ch, int64_t t_us);
+
+#endif /* HTPG_EMUL_H */
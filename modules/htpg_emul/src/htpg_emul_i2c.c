@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief Register-file I2C transfer shared by the sensor emulators.
+ */
+
+#include "htpg_emul_i2c.h"
+
+#include <errno.h>
+#include <string.h>
+
+uint32_t htpg_emul_read_plain(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++) {
+		buf[i] = regs->r[(reg + i) % HTPG_EMUL_NREGS];
+	}
+	return len;
+}
+
+int htpg_emul_i2c_transfer(struct htpg_emul_regs *regs, struct i2c_msg *msgs, int num_msgs)
+{
+	uint8_t reg;
+
+	if (num_msgs < 1 || (msgs[0].flags & I2C_MSG_READ) || msgs[0].len < 1) {
+		return -EIO;
+	}
+
+	reg = msgs[0].buf[0] & 0x7F;
+	for (uint32_t i = 1; i < msgs[0].len; i++) {
+		regs->write(regs, reg, msgs[0].buf[i]);
+		reg = (reg + 1) % HTPG_EMUL_NREGS;
+	}
+
+	for (int m = 1; m < num_msgs; m++) {
+		struct i2c_msg *msg = &msgs[m];
+
+		if (msg->flags & I2C_MSG_READ) {
+			reg = (reg + regs->read(regs, reg, msg->buf, msg->len)) % HTPG_EMUL_NREGS;
+		} else {
+			for (uint32_t i = 0; i < msg->len; i++) {
+				regs->write(regs, reg, msg->buf[i]);
+				reg = (reg + 1) % HTPG_EMUL_NREGS;
+			}
+		}
+	}
+	return 0;
+}
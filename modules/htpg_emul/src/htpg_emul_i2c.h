@@ -0,0 +1,55 @@
+#ifndef HTPG_EMUL_I2C_H
+#define HTPG_EMUL_I2C_H
+
+#include <zephyr/drivers/i2c.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file htpg_emul_i2c.h
+ * @brief Register-file plumbing shared by the sensor emulators (private).
+ */
+
+#define HTPG_EMUL_NREGS		0x80	/**< 7-bit register space of the ST parts. */
+
+/** @brief Register file plus the hooks of one emulated device. */
+struct htpg_emul_regs {
+	uint8_t	r[HTPG_EMUL_NREGS];	/**< Register contents. */
+	/**
+	 * @brief Serve a read of @p len bytes from @p reg into @p buf.
+	 * @return Registers consumed (auto-increment step), normally @p len.
+	 */
+	uint32_t (*read)(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len);
+	/** @brief Apply a write of @p val to @p reg. */
+	void (*write)(struct htpg_emul_regs *regs, uint8_t reg, uint8_t val);
+};
+
+/**
+ * @brief Run an I2C message list against a register file.
+ *
+ * The first message must be a write whose first byte is the register
+ * address (bit 7, the ST auto-increment flag, is ignored); further bytes
+ * and messages read or write consecutive registers.
+ *
+ * @retval 0 on success, -EIO on a malformed transfer.
+ */
+int htpg_emul_i2c_transfer(struct htpg_emul_regs *regs, struct i2c_msg *msgs, int num_msgs);
+
+/** @brief Plain register-file read (no side effects). */
+uint32_t htpg_emul_read_plain(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len);
+
+/** @brief True if [@p reg, @p reg + @p len) touches [@p lo, @p hi]. */
+static inline bool htpg_emul_overlaps(uint8_t reg, uint32_t len, uint8_t lo, uint8_t hi)
+{
+	return reg <= hi && reg + len > lo;
+}
+
+/** @brief Store a little-endian 16-bit value at @p reg. */
+static inline void htpg_emul_put16(struct htpg_emul_regs *regs, uint8_t reg, int32_t v)
+{
+	v = CLAMP(v, INT16_MIN, INT16_MAX);
+	regs->r[reg] = (uint8_t)v;
+	regs->r[reg + 1] = (uint8_t)(v >> 8);
+}
+
+#endif /* HTPG_EMUL_I2C_H */
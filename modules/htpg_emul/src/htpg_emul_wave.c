@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @brief Channel waveforms of the sensor emulators and the `emul` shell command.
+ */
+
+#include "htpg_emul.h"
+#include "sensor_cordic.h"
+#include "sensor_fixp.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Power-on waveforms: a quiet room, board lying flat. */
+static struct htpg_emul_wave waves[HTPG_EMUL_CHAN_COUNT] = {
+	[HTPG_EMUL_TEMP]	= { 22500000,  500000, 60000, 20000 },
+	[HTPG_EMUL_HUM]		= { 45000000, 2000000, 120000, 100000 },
+	[HTPG_EMUL_PRESS]	= { 101325000,  50000, 300000, 2000 },
+	[HTPG_EMUL_AX]		= { 0,         200000, 2000, 20000 },
+	[HTPG_EMUL_AY]		= { 0,              0, 0,    20000 },
+	[HTPG_EMUL_AZ]		= { 9806650,        0, 0,    20000 },
+	[HTPG_EMUL_GX]		= { 0,              0, 0,    1000 },
+	[HTPG_EMUL_GY]		= { 0,              0, 0,    1000 },
+	[HTPG_EMUL_GZ]		= { 0,              0, 0,    1000 },
+};
+
+/** @brief One-shot pulse per channel. */
+static struct {
+	int32_t		delta;		/**< Added while active. */
+	int64_t		until_us;	/**< End of the pulse (uptime). */
+} pulses[HTPG_EMUL_CHAN_COUNT];
+
+static struct k_spinlock	wave_lock;	/**< Guards @ref waves and @ref pulses. */
+static uint32_t			rng = 0x2545F491;	/**< xorshift32 state. */
+
+/** @brief Shell names of the channels. */
+static const char *const chan_name[HTPG_EMUL_CHAN_COUNT] = {
+	"temp", "hum", "press", "ax", "ay", "az", "gx", "gy", "gz",
+};
+
+void htpg_emul_wave_set(enum htpg_emul_chan ch, const struct htpg_emul_wave *w)
+{
+	k_spinlock_key_t key = k_spin_lock(&wave_lock);
+
+	waves[ch] = *w;
+	k_spin_unlock(&wave_lock, key);
+}
+
+void htpg_emul_wave_get(enum htpg_emul_chan ch, struct htpg_emul_wave *w)
+{
+	k_spinlock_key_t key = k_spin_lock(&wave_lock);
+
+	*w = waves[ch];
+	k_spin_unlock(&wave_lock, key);
+}
+
+void htpg_emul_pulse(enum htpg_emul_chan ch, int32_t delta, uint32_t ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&wave_lock);
+
+	pulses[ch].delta = delta;
+	pulses[ch].until_us = k_ticks_to_us_floor64(k_uptime_ticks()) + (int64_t)ms * 1000;
+	k_spin_unlock(&wave_lock, key);
+}
+
+int32_t htpg_emul_value(enum htpg_emul_chan ch, int64_t t_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&wave_lock);
+	struct htpg_emul_wave w = waves[ch];
+	int64_t v = w.offset;
+
+	if (t_us < pulses[ch].until_us) {
+		v += pulses[ch].delta;
+	}
+	if (w.noise > 0) {
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		v += (int64_t)(rng % (2U * (uint32_t)w.noise + 1U)) - w.noise;
+	}
+	k_spin_unlock(&wave_lock, key);
+
+	if (w.amplitude != 0 && w.period_ms != 0) {
+		int64_t per_us = (int64_t)w.period_ms * 1000;
+		int64_t ang = (t_us % per_us) * (2 * SENSOR_CORDIC_PI) / per_us;
+		int32_t s, c;
+
+		sensor_cordic_sincos(sensor_cordic_wrap(ang), &s, &c);
+		v += ((int64_t)w.amplitude * s) >> 30;
+	}
+
+	return (int32_t)CLAMP(v, INT32_MIN, INT32_MAX);
+}
+
+/** @brief Channel id from its shell name, or -1. */
+static int chan_from_name(const char *name)
+{
+	for (int i = 0; i < HTPG_EMUL_CHAN_COUNT; i++) {
+		if (strcmp(name, chan_name[i]) == 0) return i;
+	}
+	return -1;
+}
+
+/**
+ * @brief Shell cmd: `emul wave <chan> <offset> [amplitude] [period_ms] [noise]`.
+ *
+ * Values are in the channel's unit (°C, %RH, kPa, m/s^2, rad/s).
+ */
+static int cmd_wave(const struct shell *sh, size_t argc, char **argv)
+{
+	int ch = chan_from_name(argv[1]);
+	struct htpg_emul_wave w = {0};
+
+	if (ch < 0 || sensor_fixp_parse(argv[2], &w.offset) < 0 ||
+	    (argc > 3 && sensor_fixp_parse(argv[3], &w.amplitude) < 0) ||
+	    (argc > 5 && (sensor_fixp_parse(argv[5], &w.noise) < 0 || w.noise < 0))) {
+		shell_error(sh, "usage: emul wave temp|hum|press|ax..gz <offset> [amp] [period_ms] [noise]");
+		return -EINVAL;
+	}
+	w.period_ms = (argc > 4) ? strtoul(argv[4], NULL, 10) : 0;
+
+	htpg_emul_wave_set(ch, &w);
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `emul pulse <chan> <delta> <ms>`.
+ */
+static int cmd_pulse(const struct shell *sh, size_t argc, char **argv)
+{
+	int ch = chan_from_name(argv[1]);
+	int32_t delta;
+
+	ARG_UNUSED(argc);
+
+	if (ch < 0 || sensor_fixp_parse(argv[2], &delta) < 0) {
+		shell_error(sh, "usage: emul pulse <chan> <delta> <ms>");
+		return -EINVAL;
+	}
+	htpg_emul_pulse(ch, delta, strtoul(argv[3], NULL, 10));
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `emul show` - waveforms and current values.
+ */
+static int cmd_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	int64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	for (int i = 0; i < HTPG_EMUL_CHAN_COUNT; i++) {
+		struct htpg_emul_wave w;
+		int32_t v = htpg_emul_value(i, now);
+
+		htpg_emul_wave_get(i, &w);
+		shell_print(sh, "%-5s " SENSOR_FIXP_FMT " (offset " SENSOR_FIXP_FMT " amp "
+			    SENSOR_FIXP_FMT " period %u ms noise " SENSOR_FIXP_FMT ")",
+			    chan_name[i], SENSOR_FIXP_ARG(v, 3), SENSOR_FIXP_ARG(w.offset, 3),
+			    SENSOR_FIXP_ARG(w.amplitude, 3), w.period_ms, SENSOR_FIXP_ARG(w.noise, 3));
+	}
+	return 0;
+}
+
+/** @brief `emul` subcommands. */
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_emul,
+	SHELL_CMD_ARG(wave,	NULL, "Set waveform <chan> <offset> [amp] [period_ms] [noise]",
+		      cmd_wave, 3, 3),
+	SHELL_CMD_ARG(pulse,	NULL, "One-shot step <chan> <delta> <ms>",	cmd_pulse, 4, 0),
+	SHELL_CMD(show,		NULL, "Waveforms and current values",		cmd_show),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(emul, &sub_emul, "Emulated sensor waveforms", NULL);
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @brief HTS221 humidity/temperature I2C emulator.
+ *
+ * The calibration registers describe a linear sensor (0..50 °C over
+ * 0..5000 counts, 0..100 %RH over 0..20000 counts), so the driver's
+ * interpolation maps the output registers back to the waveform values.
+ */
+
+#define DT_DRV_COMPAT st_hts221
+
+#include "htpg_emul.h"
+#include "htpg_emul_i2c.h"
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <string.h>
+
+#define REG_WHO_AM_I		0x0F
+#define WHO_AM_I_VAL		0xBC
+#define REG_CTRL_REG2		0x21	/**< BOOT (7) and ONE_SHOT (0) self-clear. */
+#define REG_STATUS		0x27
+#define REG_HUMIDITY_OUT_L	0x28
+#define REG_TEMP_OUT_L		0x2A
+#define REG_TEMP_OUT_H		0x2B
+#define REG_H1_RH_X2		0x31
+#define REG_T1_DEGC_X8		0x33
+#define REG_T1_T0_MSB		0x35
+#define REG_H1_T0_OUT		0x3A
+#define REG_T1_OUT		0x3E
+
+#define UC_PER_COUNT		10000	/**< µ°C per temperature count. */
+#define URH_PER_COUNT		5000	/**< µ%RH per humidity count. */
+
+/** @brief Per-instance state. */
+struct hts221_emul_data {
+	struct htpg_emul_regs	regs;	/**< Register file. */
+};
+
+/** @brief Latch fresh samples into the output registers. */
+static void refresh(struct htpg_emul_regs *regs)
+{
+	int64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	htpg_emul_put16(regs, REG_HUMIDITY_OUT_L, htpg_emul_value(HTPG_EMUL_HUM, now) / URH_PER_COUNT);
+	htpg_emul_put16(regs, REG_TEMP_OUT_L, htpg_emul_value(HTPG_EMUL_TEMP, now) / UC_PER_COUNT);
+}
+
+static uint32_t hts221_emul_read(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+	if (htpg_emul_overlaps(reg, len, REG_HUMIDITY_OUT_L, REG_TEMP_OUT_H)) {
+		refresh(regs);
+	}
+	return htpg_emul_read_plain(regs, reg, buf, len);
+}
+
+static void hts221_emul_write(struct htpg_emul_regs *regs, uint8_t reg, uint8_t val)
+{
+	switch (reg) {
+	case REG_WHO_AM_I:
+	case REG_STATUS:
+		break;			/* read-only */
+	case REG_CTRL_REG2:
+		regs->r[reg] = val & ~(BIT(7) | BIT(0));
+		break;
+	default:
+		regs->r[reg] = val;
+		break;
+	}
+}
+
+static int hts221_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+				int addr)
+{
+	struct hts221_emul_data *data = target->data;
+
+	ARG_UNUSED(addr);
+	return htpg_emul_i2c_transfer(&data->regs, msgs, num_msgs);
+}
+
+static struct i2c_emul_api hts221_emul_api = {
+	.transfer = hts221_emul_transfer,
+};
+
+static int hts221_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct hts221_emul_data *data = target->data;
+	struct htpg_emul_regs *regs = &data->regs;
+
+	ARG_UNUSED(parent);
+
+	memset(regs->r, 0, sizeof(regs->r));
+	regs->read = hts221_emul_read;
+	regs->write = hts221_emul_write;
+
+	regs->r[REG_WHO_AM_I] = WHO_AM_I_VAL;
+	regs->r[REG_STATUS] = 0x03;			/* T_DA | H_DA: always ready */
+	regs->r[REG_H1_RH_X2] = 200;			/* H0 = 0 %RH, H1 = 100 %RH */
+	regs->r[REG_T1_DEGC_X8] = 400 & 0xFF;		/* T0 = 0 °C, T1 = 50 °C */
+	regs->r[REG_T1_T0_MSB] = (400 >> 8) << 2;
+	htpg_emul_put16(regs, REG_H1_T0_OUT, 20000);	/* H0_T0_OUT = 0 */
+	htpg_emul_put16(regs, REG_T1_OUT, 5000);	/* T0_OUT = 0 */
+	return 0;
+}
+
+#define HTS221_EMUL(n)								\
+	static struct hts221_emul_data hts221_emul_data_##n;			\
+	EMUL_DT_INST_DEFINE(n, hts221_emul_init, &hts221_emul_data_##n, NULL,	\
+			    &hts221_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(HTS221_EMUL)
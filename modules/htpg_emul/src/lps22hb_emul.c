@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief LPS22HB pressure I2C emulator.
+ */
+
+#define DT_DRV_COMPAT st_lps22hb_press
+
+#include "htpg_emul.h"
+#include "htpg_emul_i2c.h"
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <string.h>
+
+#define REG_WHO_AM_I		0x0F
+#define WHO_AM_I_VAL		0xB1
+#define REG_CTRL_REG2		0x11	/**< BOOT (7), SWRESET (2), ONE_SHOT (0) self-clear. */
+#define CTRL_REG2_DEFAULT	0x10	/**< IF_ADD_INC. */
+#define REG_STATUS		0x27
+#define REG_PRESS_OUT_XL	0x28
+#define REG_TEMP_OUT_L		0x2B
+#define REG_TEMP_OUT_H		0x2C
+
+/** @brief Per-instance state. */
+struct lps22hb_emul_data {
+	struct htpg_emul_regs	regs;	/**< Register file. */
+};
+
+/** @brief Latch fresh samples into the output registers. */
+static void refresh(struct htpg_emul_regs *regs)
+{
+	int64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+	/* 4096 counts per hPa = 40960 per kPa */
+	int32_t p = (int32_t)((int64_t)htpg_emul_value(HTPG_EMUL_PRESS, now) * 4096 / 100000);
+
+	p = CLAMP(p, -(1 << 23), (1 << 23) - 1);
+	regs->r[REG_PRESS_OUT_XL] = (uint8_t)p;
+	regs->r[REG_PRESS_OUT_XL + 1] = (uint8_t)(p >> 8);
+	regs->r[REG_PRESS_OUT_XL + 2] = (uint8_t)(p >> 16);
+	/* 100 counts per °C */
+	htpg_emul_put16(regs, REG_TEMP_OUT_L, htpg_emul_value(HTPG_EMUL_TEMP, now) / 10000);
+}
+
+static uint32_t lps22hb_emul_read(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+	if (htpg_emul_overlaps(reg, len, REG_PRESS_OUT_XL, REG_TEMP_OUT_H)) {
+		refresh(regs);
+	}
+	return htpg_emul_read_plain(regs, reg, buf, len);
+}
+
+static void lps22hb_emul_write(struct htpg_emul_regs *regs, uint8_t reg, uint8_t val)
+{
+	switch (reg) {
+	case REG_WHO_AM_I:
+	case REG_STATUS:
+		break;			/* read-only */
+	case REG_CTRL_REG2:
+		regs->r[reg] = val & ~(BIT(7) | BIT(2) | BIT(0));
+		break;
+	default:
+		regs->r[reg] = val;
+		break;
+	}
+}
+
+static int lps22hb_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+				 int addr)
+{
+	struct lps22hb_emul_data *data = target->data;
+
+	ARG_UNUSED(addr);
+	return htpg_emul_i2c_transfer(&data->regs, msgs, num_msgs);
+}
+
+static struct i2c_emul_api lps22hb_emul_api = {
+	.transfer = lps22hb_emul_transfer,
+};
+
+static int lps22hb_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct lps22hb_emul_data *data = target->data;
+	struct htpg_emul_regs *regs = &data->regs;
+
+	ARG_UNUSED(parent);
+
+	memset(regs->r, 0, sizeof(regs->r));
+	regs->read = lps22hb_emul_read;
+	regs->write = lps22hb_emul_write;
+
+	regs->r[REG_WHO_AM_I] = WHO_AM_I_VAL;
+	regs->r[REG_CTRL_REG2] = CTRL_REG2_DEFAULT;
+	regs->r[REG_STATUS] = 0x03;			/* P_DA | T_DA: always ready */
+	return 0;
+}
+
+#define LPS22HB_EMUL(n)								\
+	static struct lps22hb_emul_data lps22hb_emul_data_##n;			\
+	EMUL_DT_INST_DEFINE(n, lps22hb_emul_init, &lps22hb_emul_data_##n, NULL,	\
+			    &lps22hb_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(LPS22HB_EMUL)
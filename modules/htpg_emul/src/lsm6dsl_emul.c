@@ -0,0 +1,268 @@
+/**
+ * @file
+ * @brief LSM6DSL accelerometer/gyroscope I2C emulator with FIFO.
+ *
+ * Output registers are converted with the full scale currently programmed
+ * in CTRL1_XL/CTRL2_G. In FIFO continuous mode, sample sets accumulate at
+ * the FIFO ODR from the time the mode was entered (up to the 341-set
+ * capacity, then the overrun flag is raised). Each set is evaluated at its
+ * own sample instant, so drained blocks carry the waveform at full rate.
+ */
+
+#define DT_DRV_COMPAT st_lsm6dsl
+
+#include "htpg_emul.h"
+#include "htpg_emul_i2c.h"
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <string.h>
+
+#define REG_FIFO_CTRL5		0x0A
+#define REG_WHO_AM_I		0x0F
+#define WHO_AM_I_VAL		0x6A
+#define REG_CTRL1_XL		0x10
+#define REG_CTRL2_G		0x11
+#define REG_CTRL3_C		0x12	/**< BOOT (7) and SW_RESET (0) self-clear. */
+#define CTRL3_C_DEFAULT		0x04	/**< IF_INC. */
+#define REG_STATUS		0x1E
+#define REG_OUT_TEMP_L		0x20
+#define REG_OUTX_L_G		0x22
+#define REG_OUTX_L_XL		0x28
+#define REG_OUTZ_H_XL		0x2D
+#define REG_FIFO_STATUS1	0x3A
+#define REG_FIFO_STATUS4	0x3D
+#define REG_FIFO_DATA_OUT_L	0x3E
+
+#define FIFO_MODE_CONTINUOUS	0x06
+#define FIFO_SETS_MAX		341	/**< 4 KiB FIFO / 12 bytes per set. */
+#define WORDS_PER_SET		6	/**< Gx Gy Gz Ax Ay Az. */
+
+/** @brief ODR codes 1..8 in mHz (index code - 1). */
+static const uint32_t odr_mhz_tbl[] = {
+	12500, 26000, 52000, 104000, 208000, 416000, 833000, 1666000,
+};
+
+/** @brief Accel µg/LSB indexed by FS_XL[1:0] (±2, ±16, ±4, ±8 g). */
+static const uint32_t accel_ug_tbl[] = { 61, 488, 122, 244 };
+
+/** @brief Gyro µdps/LSB indexed by FS_G[1:0] (245, 500, 1000, 2000 dps). */
+static const uint32_t gyro_udps_tbl[] = { 8750, 17500, 35000, 70000 };
+
+/** @brief Per-instance state. */
+struct lsm6dsl_emul_data {
+	struct htpg_emul_regs	regs;		/**< Register file (first member). */
+	int64_t			fifo_t_ns;	/**< Instant of the newest set. */
+	uint32_t		fifo_sets;	/**< Sets not completely read. */
+	uint32_t		fifo_word;	/**< Words of the oldest set already read. */
+	bool			fifo_ovr;	/**< Overrun since the last data read. */
+};
+
+static inline int64_t now_ns(void)
+{
+	return k_ticks_to_ns_floor64(k_uptime_ticks());
+}
+
+/** @brief Raw accel counts of @p ch at @p t_us with the programmed full scale. */
+static int32_t accel_raw(const struct htpg_emul_regs *regs, enum htpg_emul_chan ch, int64_t t_us)
+{
+	int64_t ug = (int64_t)htpg_emul_value(ch, t_us) * 100000 / 980665;
+
+	return (int32_t)(ug / accel_ug_tbl[(regs->r[REG_CTRL1_XL] >> 2) & 0x3]);
+}
+
+/** @brief Raw gyro counts of @p ch at @p t_us with the programmed full scale. */
+static int32_t gyro_raw(const struct htpg_emul_regs *regs, enum htpg_emul_chan ch, int64_t t_us)
+{
+	uint8_t ctrl2 = regs->r[REG_CTRL2_G];
+	uint32_t udps_lsb = (ctrl2 & BIT(1)) ? 4375 : gyro_udps_tbl[(ctrl2 >> 2) & 0x3];
+	int64_t udps = (int64_t)htpg_emul_value(ch, t_us) * 1000000000 / 17453293;
+
+	return (int32_t)(udps / udps_lsb);
+}
+
+/** @brief Clamp to int16 (the output registers saturate). */
+static inline int16_t sat16(int32_t v)
+{
+	return (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+}
+
+/** @brief Latch fresh samples into the output registers. */
+static void refresh(struct htpg_emul_regs *regs)
+{
+	int64_t t = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	/* 256 counts per °C, 0 at 25 °C */
+	htpg_emul_put16(regs, REG_OUT_TEMP_L,
+			(int32_t)(((int64_t)htpg_emul_value(HTPG_EMUL_TEMP, t) - 25000000) * 256 / 1000000));
+	for (int k = 0; k < 3; k++) {
+		htpg_emul_put16(regs, REG_OUTX_L_G + 2 * k, gyro_raw(regs, HTPG_EMUL_GX + k, t));
+		htpg_emul_put16(regs, REG_OUTX_L_XL + 2 * k, accel_raw(regs, HTPG_EMUL_AX + k, t));
+	}
+}
+
+/** @brief FIFO set period in ns, or 0 while the FIFO is not collecting. */
+static int64_t fifo_period_ns(const struct htpg_emul_regs *regs)
+{
+	uint8_t ctrl5 = regs->r[REG_FIFO_CTRL5];
+	uint8_t code = (ctrl5 >> 3) & 0xF;
+
+	if ((ctrl5 & 0x7) != FIFO_MODE_CONTINUOUS || code == 0 || code > ARRAY_SIZE(odr_mhz_tbl)) {
+		return 0;
+	}
+	return 1000000000000LL / odr_mhz_tbl[code - 1];
+}
+
+/** @brief Add the sets produced since the last update. */
+static void fifo_update(struct lsm6dsl_emul_data *d)
+{
+	int64_t per = fifo_period_ns(&d->regs);
+	int64_t now = now_ns();
+
+	if (per == 0) {
+		d->fifo_t_ns = now;
+		return;
+	}
+
+	int64_t n = (now - d->fifo_t_ns) / per;
+
+	d->fifo_t_ns += n * per;
+	if (d->fifo_sets + n > FIFO_SETS_MAX) {
+		d->fifo_sets = FIFO_SETS_MAX;
+		d->fifo_word = 0;
+		d->fifo_ovr = true;
+	} else {
+		d->fifo_sets += (uint32_t)n;
+	}
+}
+
+/** @brief Fill FIFO_STATUS1..4 (unread words, overrun/empty, pattern). */
+static void fifo_status(struct lsm6dsl_emul_data *d)
+{
+	uint32_t words = d->fifo_sets * WORDS_PER_SET - d->fifo_word;
+	uint8_t *r = &d->regs.r[REG_FIFO_STATUS1];
+
+	r[0] = (uint8_t)words;
+	r[1] = ((words >> 8) & 0x07) | (d->fifo_ovr ? BIT(6) : 0) | (words == 0 ? BIT(4) : 0);
+	r[2] = (uint8_t)d->fifo_word;
+	r[3] = 0;
+}
+
+/** @brief Pop @p len bytes of FIFO words; the address does not advance. */
+static void fifo_read(struct lsm6dsl_emul_data *d, uint8_t *buf, uint32_t len)
+{
+	int64_t per = fifo_period_ns(&d->regs);
+
+	fifo_update(d);
+	d->fifo_ovr = false;
+
+	for (uint32_t i = 0; i + 1 < len; i += 2) {
+		int32_t v = 0;
+
+		if (d->fifo_sets > 0) {
+			int64_t t_us = (d->fifo_t_ns - (int64_t)(d->fifo_sets - 1) * per) / 1000;
+			uint32_t w = d->fifo_word;
+
+			v = (w < 3) ? gyro_raw(&d->regs, HTPG_EMUL_GX + w, t_us)
+				    : accel_raw(&d->regs, HTPG_EMUL_AX + (w - 3), t_us);
+			if (++d->fifo_word == WORDS_PER_SET) {
+				d->fifo_word = 0;
+				d->fifo_sets--;
+			}
+		}
+		v = sat16(v);
+		buf[i] = (uint8_t)v;
+		buf[i + 1] = (uint8_t)(v >> 8);
+	}
+}
+
+static uint32_t lsm6dsl_emul_read(struct htpg_emul_regs *regs, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+	struct lsm6dsl_emul_data *d = CONTAINER_OF(regs, struct lsm6dsl_emul_data, regs);
+
+	if (reg == REG_FIFO_DATA_OUT_L) {
+		fifo_read(d, buf, len);
+		return 0;
+	}
+	if (htpg_emul_overlaps(reg, len, REG_FIFO_STATUS1, REG_FIFO_STATUS4)) {
+		fifo_update(d);
+		fifo_status(d);
+	}
+	if (htpg_emul_overlaps(reg, len, REG_OUT_TEMP_L, REG_OUTZ_H_XL)) {
+		refresh(regs);
+	}
+	return htpg_emul_read_plain(regs, reg, buf, len);
+}
+
+/** @brief Power-on register values. */
+static void reset_regs(struct lsm6dsl_emul_data *d)
+{
+	memset(d->regs.r, 0, sizeof(d->regs.r));
+	d->regs.r[REG_WHO_AM_I] = WHO_AM_I_VAL;
+	d->regs.r[REG_CTRL3_C] = CTRL3_C_DEFAULT;
+	d->regs.r[REG_STATUS] = 0x07;		/* TDA | GDA | XLDA: always ready */
+	d->fifo_sets = d->fifo_word = 0;
+	d->fifo_ovr = false;
+	d->fifo_t_ns = now_ns();
+}
+
+static void lsm6dsl_emul_write(struct htpg_emul_regs *regs, uint8_t reg, uint8_t val)
+{
+	struct lsm6dsl_emul_data *d = CONTAINER_OF(regs, struct lsm6dsl_emul_data, regs);
+
+	switch (reg) {
+	case REG_WHO_AM_I:
+	case REG_STATUS:
+		break;			/* read-only */
+	case REG_CTRL3_C:
+		if (val & BIT(0)) {
+			reset_regs(d);
+		} else {
+			regs->r[reg] = val & ~BIT(7);
+		}
+		break;
+	case REG_FIFO_CTRL5:
+		/* any reconfiguration (bypass in particular) empties the FIFO */
+		regs->r[reg] = val;
+		d->fifo_sets = d->fifo_word = 0;
+		d->fifo_ovr = false;
+		d->fifo_t_ns = now_ns();
+		break;
+	default:
+		regs->r[reg] = val;
+		break;
+	}
+}
+
+static int lsm6dsl_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+				 int addr)
+{
+	struct lsm6dsl_emul_data *data = target->data;
+
+	ARG_UNUSED(addr);
+	return htpg_emul_i2c_transfer(&data->regs, msgs, num_msgs);
+}
+
+static struct i2c_emul_api lsm6dsl_emul_api = {
+	.transfer = lsm6dsl_emul_transfer,
+};
+
+static int lsm6dsl_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct lsm6dsl_emul_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->regs.read = lsm6dsl_emul_read;
+	data->regs.write = lsm6dsl_emul_write;
+	reset_regs(data);
+	return 0;
+}
+
+#define LSM6DSL_EMUL(n)								\
+	static struct lsm6dsl_emul_data lsm6dsl_emul_data_##n;			\
+	EMUL_DT_INST_DEFINE(n, lsm6dsl_emul_init, &lsm6dsl_emul_data_##n, NULL,	\
+			    &lsm6dsl_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(LSM6DSL_EMUL)
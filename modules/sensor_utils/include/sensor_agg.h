@@ -0,0 +1,64 @@
+#ifndef SENSOR_AGG_H
+#define SENSOR_AGG_H
+
+#include <stdint.h>
+
+/**
+ * @file sensor_agg.h
+ * @brief Incremental min/max/mean/variance of a micro-unit channel.
+ *
+ * Welford's online update in integer arithmetic: the running mean is kept
+ * in Q@ref SENSOR_AGG_FRAC micro-units and the sum of squared deviations
+ * (M2) in micro-units squared, so no sample buffer and no FPU is needed
+ * and adding a sample is O(1). Unlike a sum / sum-of-squares pair, M2 only
+ * grows with the spread of the data, not its magnitude, so a 100 kPa
+ * pressure channel does not overflow.
+ *
+ * Example:
+ * @code
+ *  struct sensor_agg a;
+ *
+ *  sensor_agg_reset(&a);
+ *  sensor_agg_add(&a, temp_micro);
+ *  ...
+ *  int32_t mean = sensor_agg_mean(&a);
+ *  int32_t sd   = sensor_agg_stddev(&a);
+ * @endcode
+ */
+
+#define SENSOR_AGG_FRAC		8	/**< Fractional bits of the running mean. */
+
+/** @brief Running statistics of one channel; reset before first use. */
+struct sensor_agg {
+	uint32_t	n;		/**< Samples added. */
+	int32_t		min;		/**< Smallest sample. */
+	int32_t		max;		/**< Largest sample. */
+	int64_t		mean_q;		/**< Running mean, Q@ref SENSOR_AGG_FRAC. */
+	uint64_t	m2;		/**< Sum of squared deviations (saturating). */
+};
+
+/** @brief Start a new window. */
+void sensor_agg_reset(struct sensor_agg *a);
+
+/** @brief Add one sample (micro-units). */
+void sensor_agg_add(struct sensor_agg *a, int32_t x);
+
+/** @brief Mean of the window in micro-units (0 when empty). */
+static inline int32_t sensor_agg_mean(const struct sensor_agg *a)
+{
+	int64_t half = (a->mean_q < 0) ? -(1LL << (SENSOR_AGG_FRAC - 1))
+				       : (1LL << (SENSOR_AGG_FRAC - 1));
+
+	return (int32_t)((a->mean_q + half) / (1LL << SENSOR_AGG_FRAC));
+}
+
+/** @brief Sample variance (n - 1) in micro-units squared (0 below 2 samples). */
+static inline uint64_t sensor_agg_variance(const struct sensor_agg *a)
+{
+	return (a->n > 1) ? a->m2 / (a->n - 1) : 0;
+}
+
+/** @brief Sample standard deviation in micro-units. */
+int32_t sensor_agg_stddev(const struct sensor_agg *a);
+
+#endif /* SENSOR_AGG_H */
@@ -0,0 +1,102 @@
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_bus.h
+ * @brief Single acquisition service publishing samples on a zbus channel.
+ *
+ * One thread fetches the board sensors once per period (see
+ * sensor_period.h) and publishes a @ref sensor_bus_sample on
+ * @c sensor_bus_chan. Consumers attach as zbus observers in their own file
+ * and never touch the sensor drivers:
+ *
+ *  - a listener runs in the acquisition thread, so it must be O(1) and
+ *    non-blocking (e.g. push into a RAM ring, submit a work item);
+ *  - a subscriber is notified through its queue and reads the latest
+ *    sample with zbus_chan_read(); a slow one simply skips samples;
+ *  - a message subscriber gets its own copy of every sample from the zbus
+ *    buffer pool, so it sees all samples as long as it keeps up on average.
+ *
+ * Publication waits at most @c CONFIG_SENSOR_UTILS_BUS_PUB_TIMEOUT_MS for
+ * the channel lock (readers hold it while copying a sample) and again for
+ * the notifications, so a slow consumer cannot delay the next fetch by
+ * more than that. A sample that could not be stored counts as lost; one
+ * whose notification failed for some observer (full subscriber queue,
+ * exhausted buffer pool) counts as dropped.
+ *
+ * Sources are taken from devicetree aliases and are optional: @c ht-sensor
+ * (or @c ambient-temp0) for temperature/humidity, @c pressure-sensor and
+ * @c imu-sensor.
+ *
+ * Example:
+ * @code
+ *  ZBUS_SUBSCRIBER_DEFINE(lcd_sub, 4);
+ *  ZBUS_CHAN_ADD_OBS(sensor_bus_chan, lcd_sub, 0);
+ *
+ *  sensor_bus_start(1000);
+ *  while (zbus_sub_wait(&lcd_sub, &chan, K_FOREVER) == 0) {
+ *          struct sensor_bus_sample s;
+ *
+ *          zbus_chan_read(&sensor_bus_chan, &s, K_MSEC(10));
+ *          render(&s);
+ *  }
+ * @endcode
+ */
+
+/** @name Channels present in a sample (@ref sensor_bus_sample.valid). */
+/** @{ */
+#define SENSOR_BUS_TEMP		BIT(0)
+#define SENSOR_BUS_HUM		BIT(1)
+#define SENSOR_BUS_PRESS	BIT(2)
+#define SENSOR_BUS_ACCEL	BIT(3)
+/** @} */
+
+/** @brief One acquisition; values in micro-units (see sensor_fixp.h). */
+struct sensor_bus_sample {
+	uint32_t	seq;		/**< Publication counter, starts at 1. */
+	int64_t		t_ms;		/**< Uptime of the fetch. */
+	uint32_t	valid;		/**< SENSOR_BUS_* channels read successfully. */
+	int32_t		temp;		/**< °C. */
+	int32_t		hum;		/**< %RH. */
+	int32_t		press;		/**< hPa. */
+	int32_t		accel[3];	/**< m/s^2. */
+};
+
+ZBUS_CHAN_DECLARE(sensor_bus_chan);
+
+/**
+ * @brief Check the sources and start periodic acquisition.
+ *
+ * @param period_ms Acquisition period (> 0).
+ *
+ * @retval 0 on success.
+ * @retval -ENODEV if no source is ready.
+ * @retval -EALREADY if already running.
+ */
+int sensor_bus_start(uint32_t period_ms);
+
+/** @brief Channels whose source device was ready at start (SENSOR_BUS_* mask). */
+uint32_t sensor_bus_present(void);
+
+/** @brief Change the acquisition period from any thread. */
+void sensor_bus_set_period_ms(uint32_t ms);
+
+/** @brief Current acquisition period. */
+uint32_t sensor_bus_get_period_ms(void);
+
+/** @brief Counters since start. */
+struct sensor_bus_stats {
+	uint32_t	published;	/**< Samples stored in the channel. */
+	uint32_t	lost;		/**< Samples not stored (channel lock timed out). */
+	uint32_t	dropped;	/**< Published samples some observer missed. */
+	uint32_t	overruns;	/**< Periods missed by the acquisition thread. */
+};
+
+/** @brief Snapshot of the counters. */
+void sensor_bus_get_stats(struct sensor_bus_stats *st);
+
+#endif /* SENSOR_BUS_H */
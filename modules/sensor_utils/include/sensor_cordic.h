@@ -0,0 +1,51 @@
+#ifndef SENSOR_CORDIC_H
+#define SENSOR_CORDIC_H
+
+#include <stdint.h>
+
+/**
+ * @file sensor_cordic.h
+ * @brief Integer CORDIC: atan2/magnitude and sine/cosine.
+ *
+ * Shift-and-add only (no multiplier in the loop, no FPU, no tables beyond
+ * the 21 arctangent constants). Angles are micro-radians, matching the
+ * micro-unit convention of sensor_fixp.h; sine and cosine are Q30.
+ * Accuracy is about 1 µrad.
+ */
+
+#define SENSOR_CORDIC_PI	3141593		/**< pi in µrad. */
+#define SENSOR_CORDIC_ONE	(1 << 30)	/**< 1.0 in Q30. */
+
+/**
+ * @brief Angle of the vector (@p x, @p y).
+ *
+ * Any int32 inputs: the magnitude is at most sqrt(2) * 2^31, which fits
+ * @p mag, but only magnitudes up to INT32_MAX can be fed back as an
+ * int32 component (as sensor_fusion.c does with the accelerometer).
+ *
+ * @param y   Y component (any unit).
+ * @param x   X component (same unit).
+ * @param mag If not NULL, receives sqrt(x^2 + y^2) in that unit.
+ *
+ * @return Angle in µrad, in [-pi, pi].
+ */
+int32_t sensor_cordic_atan2(int32_t y, int32_t x, uint32_t *mag);
+
+/**
+ * @brief Sine and cosine of an angle.
+ *
+ * @param angle Angle in µrad, in [-pi, pi].
+ * @param s     Sine, Q30.
+ * @param c     Cosine, Q30.
+ */
+void sensor_cordic_sincos(int32_t angle, int32_t *s, int32_t *c);
+
+/** @brief Wrap an angle in µrad to [-pi, pi]. */
+static inline int32_t sensor_cordic_wrap(int64_t angle)
+{
+	while (angle > SENSOR_CORDIC_PI) angle -= 2 * SENSOR_CORDIC_PI;
+	while (angle < -SENSOR_CORDIC_PI) angle += 2 * SENSOR_CORDIC_PI;
+	return (int32_t)angle;
+}
+
+#endif /* SENSOR_CORDIC_H */
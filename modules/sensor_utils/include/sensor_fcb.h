@@ -0,0 +1,191 @@
+#ifndef SENSOR_FCB_H
+#define SENSOR_FCB_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_fcb.h
+ * @brief Append-only log on a raw flash partition (flash circular buffer).
+ *
+ * The file-system-free counterpart of sensor_sink.h for telemetry that is
+ * only ever appended, read in order and cleared. Records are collected in
+ * a RAM buffer the same way (size trigger, @c flush_ms time trigger,
+ * sensor_fcb_flush()), and each buffer becomes one FCB entry: a length,
+ * the records and a CRC, programmed once. There is no metadata to rewrite,
+ * so the only erases are the ones that make room: when the partition is
+ * full, the oldest sector is erased (fcb_rotate()) and its entries are
+ * lost, keeping the newest data in a fixed budget.
+ *
+ * An entry never splits a record, so an entry decodes alone. Entries carry
+ * no header, so sensor_fcb_init() takes a magic identifying the record
+ * layout (e.g. a CRC of the sensor_rec.h header): a partition holding
+ * anything else (another layout, a file system) is erased.
+ *
+ * Example:
+ * @code
+ *  SENSOR_FCB_DEFINE(log_fcb, FIXED_PARTITION_ID(app_lfs), 1024, 5000, 64);
+ *
+ *  sensor_fcb_init(&log_fcb, crc32_ieee(hdr, hdr_len));
+ *  sensor_fcb_append(&log_fcb, rec, len);
+ *  ...
+ *  sensor_fcb_for_each(&log_fcb, buf, sizeof(buf), print_entry, sh);	// oldest first
+ * @endcode
+ */
+
+/** @brief Counters since boot; take copies with sensor_fcb_get_stats(). */
+struct sensor_fcb_stats {
+	uint32_t	appends;	/**< Records appended. */
+	uint32_t	bytes;		/**< Bytes appended. */
+	uint32_t	entries;	/**< FCB entries written (one per buffer). */
+	uint32_t	rotations;	/**< Oldest sectors erased to make room. */
+	uint32_t	formats;	/**< Partition erased on init (foreign content). */
+	uint32_t	errors;		/**< Failed append/write/rotate. */
+	uint32_t	dropped;	/**< Bytes discarded after a failed write. */
+};
+
+/** @brief Log state; define with @ref SENSOR_FCB_DEFINE. */
+struct sensor_fcb {
+	int				area_id;	/**< Flash map partition. */
+	uint8_t				*buf;		/**< Record buffer (one entry). */
+	size_t				size;		/**< Capacity of @ref buf. */
+	uint32_t			flush_ms;	/**< Time trigger, 0 = off. */
+	struct flash_sector		*sectors;	/**< Sector table of the partition. */
+	uint32_t			sector_max;	/**< Entries in @ref sectors. */
+	size_t				budget;		/**< Bytes of leading sectors used, 0 = all. */
+	struct k_mutex			*lock;		/**< Guards everything below. */
+	struct k_work_delayable		*timer;		/**< Time trigger. */
+	struct fcb			fcb;		/**< Zephyr FCB instance. */
+	uint32_t			align;		/**< Flash write block. */
+	bool				ready;		/**< Initialised and not closed. */
+	size_t				fill;		/**< Bytes in @ref buf. */
+	struct sensor_fcb_stats		stats;		/**< Counters. */
+};
+
+/** @cond INTERNAL_HIDDEN */
+void sensor_fcb_timeout(struct sensor_fcb *f);
+/** @endcond */
+
+/**
+ * @brief Statically allocate a flash log named @p _name.
+ *
+ * @param _name       Log variable.
+ * @param _area_id    Partition, e.g. @c FIXED_PARTITION_ID(app_lfs).
+ * @param _size       Buffer bytes = largest entry, a multiple of the flash
+ *                    write block and well under one sector.
+ * @param _flush_ms   Longest time a record stays in RAM, 0 for no time trigger.
+ * @param _sector_max Most sectors the partition may have.
+ */
+#define SENSOR_FCB_DEFINE(_name, _area_id, _size, _flush_ms, _sector_max)		\
+	BUILD_ASSERT((_size) > 0 && (_size) < FCB_MAX_LEN, "entry too long for an FCB");	\
+	BUILD_ASSERT((_sector_max) > 1 && (_sector_max) <= UINT8_MAX,			\
+		     "an FCB spans 2..255 sectors");					\
+	static struct sensor_fcb _name;							\
+	static void _name##_timeout(struct k_work *work)				\
+	{										\
+		ARG_UNUSED(work);							\
+		sensor_fcb_timeout(&_name);						\
+	}										\
+	static K_MUTEX_DEFINE(_name##_lock);						\
+	static K_WORK_DELAYABLE_DEFINE(_name##_timer, _name##_timeout);		\
+	static uint8_t _name##_buf[_size];						\
+	static struct flash_sector _name##_sectors[_sector_max];			\
+	static struct sensor_fcb _name = {						\
+		.area_id = (_area_id), .buf = _name##_buf, .size = (_size),		\
+		.flush_ms = (_flush_ms), .sectors = _name##_sectors,			\
+		.sector_max = (_sector_max), .lock = &_name##_lock,			\
+		.timer = &_name##_timer,						\
+	}
+
+/**
+ * @brief Attach the log to its partition (again after sensor_fcb_close()).
+ *
+ * Reads the sector layout and resumes after the newest entry. A partition
+ * whose sectors carry another magic is erased first and counted in
+ * @c formats. Discards anything still buffered.
+ *
+ * @param f     Log.
+ * @param magic Record layout identifier (not 0xffffffff, which reads as erased).
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the buffer is not a multiple of the write block or
+ *         does not fit a sector with its entry header, or if fewer than
+ *         two sectors fit the budget.
+ * @retval negative errno from the flash map or the FCB.
+ */
+int sensor_fcb_init(struct sensor_fcb *f, uint32_t magic);
+
+/**
+ * @brief Limit the log to the leading sectors of the partition that fit
+ *        in @p bytes (0: the whole partition, the default).
+ *
+ * Takes effect at the next sensor_fcb_init(); e.g. to compare with a
+ * sensor_sink.h log under the same budget.
+ */
+void sensor_fcb_set_budget(struct sensor_fcb *f, size_t bytes);
+
+/**
+ * @brief Append one record.
+ *
+ * Copies @p data into the buffer; a record that does not fit behind the
+ * buffered ones first writes those as one entry.
+ *
+ * @retval 0 on success (the record may still be in RAM).
+ * @retval -ENODEV if the log is not initialised.
+ * @retval -EMSGSIZE if @p len exceeds the buffer.
+ * @retval negative errno from writing the buffered records; they are
+ *         dropped, and so is @p data.
+ */
+int sensor_fcb_append(struct sensor_fcb *f, const void *data, size_t len);
+
+/**
+ * @brief Write the buffered records as one entry.
+ *
+ * @retval 0 on success or if nothing was pending.
+ * @retval negative errno otherwise.
+ */
+int sensor_fcb_flush(struct sensor_fcb *f);
+
+/** @brief Flush, then detach; appends fail with -ENODEV until sensor_fcb_init(). */
+int sensor_fcb_close(struct sensor_fcb *f);
+
+/** @brief Drop the buffer and erase every sector of the log. */
+int sensor_fcb_clear(struct sensor_fcb *f);
+
+/**
+ * @brief Called by sensor_fcb_for_each() with the records of one entry.
+ * @return 0 to go on, nonzero to stop the walk.
+ */
+typedef int (*sensor_fcb_entry_cb)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Call @p cb for every entry, oldest first.
+ *
+ * Each entry is read into @p buf (at least the log's buffer size). Appends
+ * go on meanwhile; entries failing their CRC (cut by a reset, or in a
+ * sector rotated out during the walk) are skipped. Flush first to include
+ * buffered records.
+ *
+ * @retval 0 after the last entry or when @p cb stops the walk.
+ * @retval negative errno from the flash or the FCB.
+ */
+int sensor_fcb_for_each(struct sensor_fcb *f, uint8_t *buf, size_t len,
+			sensor_fcb_entry_cb cb, void *ctx);
+
+/**
+ * @brief Sectors holding entries.
+ *
+ * @param f     Log.
+ * @param total Set to the sectors of the partition (may be NULL).
+ *
+ * @return sectors in use, 0 if empty or not initialised.
+ */
+int sensor_fcb_sectors(struct sensor_fcb *f, uint32_t *total);
+
+/** @brief Copy the counters of @p f; @p fill gets the bytes still in RAM (may be NULL). */
+void sensor_fcb_get_stats(struct sensor_fcb *f, struct sensor_fcb_stats *out, size_t *fill);
+
+#endif /* SENSOR_FCB_H */
@@ -0,0 +1,134 @@
+#ifndef SENSOR_FIXP_H
+#define SENSOR_FIXP_H
+
+#include <zephyr/drivers/sensor.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_fixp.h
+ * @brief Integer-only micro-unit representation of sensor readings.
+ *
+ * A reading is carried as a signed integer in millionths of its SI unit
+ * (e.g. 23.45 °C is 23450000). Conversion from @c sensor_value is exact
+ * and formatting never touches the FPU or the cbprintf float code.
+ *
+ * Formatting is done through a format/argument macro pair so the value
+ * can be embedded in any printk/snprintk/LOG_* call:
+ * @code
+ *  LOG_INF("T=" SENSOR_FIXP_FMT " C", SENSOR_FIXP_ARG(t_micro, 2));
+ * @endcode
+ */
+
+/** @brief One unit expressed in micro-units. */
+#define SENSOR_FIXP_ONE		1000000
+
+/** @brief printf-style format matching @ref SENSOR_FIXP_ARG. */
+#define SENSOR_FIXP_FMT		"%s%u.%0*u"
+
+/**
+ * @brief Argument list for @ref SENSOR_FIXP_FMT.
+ *
+ * @param micro Value in micro-units (int64_t range).
+ * @param dec   Number of decimals to print, 1..6 (rounded half away from zero).
+ */
+#define SENSOR_FIXP_ARG(micro, dec)					\
+	sensor_fixp_sign((micro), (dec)),				\
+	sensor_fixp_int((micro), (dec)),				\
+	(int)(dec),							\
+	sensor_fixp_frac((micro), (dec))
+
+/**
+ * @brief Convert a driver value to micro-units.
+ *
+ * @c val2 carries the same sign as @c val1, so the sum is exact.
+ */
+static inline int32_t sensor_fixp_from_value(const struct sensor_value *v)
+{
+	return (int32_t)((int64_t)v->val1 * SENSOR_FIXP_ONE + v->val2);
+}
+
+/**
+ * @brief Convert a decoded Q31 reading (value, shift) to micro-units.
+ *
+ * The real value is @p value * 2^(shift - 31), as produced by the sensor
+ * decoder API.
+ */
+static inline int32_t sensor_fixp_from_q31(int32_t value, int8_t shift)
+{
+	int64_t scaled = (int64_t)value * SENSOR_FIXP_ONE;
+
+	return (int32_t)((shift <= 31) ? (scaled >> (31 - shift)) : (scaled << (shift - 31)));
+}
+
+/** @brief 10^dec for dec in 0..6. */
+static inline uint32_t sensor_fixp_pow10(unsigned int dec)
+{
+	static const uint32_t p[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+	return p[dec > 6U ? 6U : dec];
+}
+
+/** @brief Magnitude of @p micro rounded to @p dec decimals, in 10^-dec units. */
+static inline uint64_t sensor_fixp_round(int64_t micro, unsigned int dec)
+{
+	uint64_t mag = (micro < 0) ? (uint64_t)(-micro) : (uint64_t)micro;
+	uint32_t div = sensor_fixp_pow10(6U - (dec > 6U ? 6U : dec));
+
+	return (mag + div / 2U) / div;
+}
+
+/** @brief Sign prefix ("-" or "") of the rounded value. */
+static inline const char *sensor_fixp_sign(int64_t micro, unsigned int dec)
+{
+	return (micro < 0 && sensor_fixp_round(micro, dec) != 0U) ? "-" : "";
+}
+
+/** @brief Integer part of the rounded magnitude. */
+static inline unsigned int sensor_fixp_int(int64_t micro, unsigned int dec)
+{
+	return (unsigned int)(sensor_fixp_round(micro, dec) / sensor_fixp_pow10(dec));
+}
+
+/** @brief Fractional digits of the rounded magnitude. */
+static inline unsigned int sensor_fixp_frac(int64_t micro, unsigned int dec)
+{
+	return (unsigned int)(sensor_fixp_round(micro, dec) % sensor_fixp_pow10(dec));
+}
+
+/**
+ * @brief Parse a decimal string such as "-12.345" into micro-units.
+ *
+ * Digits past the sixth decimal are ignored (truncated).
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL on malformed input or a value outside int32 micro-units.
+ */
+static inline int sensor_fixp_parse(const char *str, int32_t *out)
+{
+	bool		neg = false;
+	bool		digits = false;
+	int64_t		mag = 0;
+	uint32_t	scale = SENSOR_FIXP_ONE;
+
+	if (*str == '-' || *str == '+') {
+		neg = (*str++ == '-');
+	}
+	for (; *str >= '0' && *str <= '9'; str++, digits = true) {
+		mag = mag * 10 + (*str - '0') * (int64_t)SENSOR_FIXP_ONE;
+		if (mag > INT32_MAX) return -EINVAL;
+	}
+	if (*str == '.') {
+		for (str++; *str >= '0' && *str <= '9'; str++, digits = true) {
+			scale /= 10U;
+			mag += (*str - '0') * (int64_t)scale;
+		}
+	}
+	if (!digits || *str != '\0' || mag > INT32_MAX) return -EINVAL;
+
+	*out = (int32_t)(neg ? -mag : mag);
+	return 0;
+}
+
+#endif /* SENSOR_FIXP_H */
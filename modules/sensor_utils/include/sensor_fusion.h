@@ -0,0 +1,72 @@
+#ifndef SENSOR_FUSION_H
+#define SENSOR_FUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_fusion.h
+ * @brief Fixed-point complementary filter: accel + gyro to roll/pitch/yaw.
+ *
+ * Gyro rates are integrated through the Euler-angle kinematics; roll and
+ * pitch are then pulled towards the accelerometer tilt by (1 - alpha) of
+ * the error each update. The correction is skipped while the measured
+ * acceleration is more than @ref SENSOR_FUSION_GATE away from 1 g, so
+ * shocks and sustained linear acceleration do not tilt the estimate. Yaw
+ * has no absolute reference (no magnetometer) and is gyro-only.
+ *
+ * All arithmetic is integer (CORDIC for atan2/sin/cos, see
+ * sensor_cordic.h): inputs in µm/s^2 and µrad/s, angles in µrad,
+ * quaternion in Q30.
+ *
+ * Example:
+ * @code
+ *  struct sensor_fusion f;
+ *
+ *  sensor_fusion_init(&f, 32112);	// alpha 0.98 in Q15
+ *  sensor_fusion_update(&f, imu.accel, imu.gyro, dt_us);
+ *  sensor_fusion_quat(&f, q);
+ * @endcode
+ */
+
+#define SENSOR_FUSION_G		9806650		/**< Standard gravity, µm/s^2. */
+#define SENSOR_FUSION_GATE	1961330		/**< Accel correction gate: +-0.2 g. */
+
+/** @brief Filter state; initialise with sensor_fusion_init(). */
+struct sensor_fusion {
+	int32_t		roll;		/**< Rotation about X, µrad. */
+	int32_t		pitch;		/**< Rotation about Y, µrad. */
+	int32_t		yaw;		/**< Rotation about Z, µrad (gyro-only). */
+	uint16_t	alpha;		/**< Gyro weight, Q15 (0.98 = 32112). */
+	bool		valid;		/**< Angles seeded from the accelerometer. */
+	uint32_t	gated;		/**< Updates without accel correction. */
+};
+
+/**
+ * @brief Reset the filter; the next update seeds roll/pitch from gravity.
+ *
+ * @param f     Filter.
+ * @param alpha Gyro weight in Q15; 1 - alpha is the accel correction gain.
+ */
+void sensor_fusion_init(struct sensor_fusion *f, uint16_t alpha);
+
+/**
+ * @brief Advance the filter by one IMU sample.
+ *
+ * @param f     Filter.
+ * @param accel Accelerometer X/Y/Z in µm/s^2.
+ * @param gyro  Gyroscope X/Y/Z in µrad/s.
+ * @param dt_us Time since the previous sample.
+ */
+void sensor_fusion_update(struct sensor_fusion *f, const int32_t accel[3],
+			  const int32_t gyro[3], uint32_t dt_us);
+
+/**
+ * @brief Orientation as a unit quaternion (ZYX Euler convention).
+ *
+ * @param f Filter.
+ * @param q Destination w, x, y, z in Q30.
+ */
+void sensor_fusion_quat(const struct sensor_fusion *f, int32_t q[4]);
+
+#endif /* SENSOR_FUSION_H */
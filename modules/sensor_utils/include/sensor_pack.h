@@ -0,0 +1,141 @@
+#ifndef SENSOR_PACK_H
+#define SENSOR_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sensor_rec.h"
+
+/**
+ * @file sensor_pack.h
+ * @brief Streaming compression of sensor_rec.h records, per log segment.
+ *
+ * Consecutive records differ little, so each record is packed in two
+ * stages before it reaches the file:
+ * 1. Delta: the tag, then the zig-zag varint of the timestamp difference
+ *    to the previous record and of every channel's difference to the
+ *    previous record of the same type (a steady channel costs one byte).
+ * 2. LZSS (heatshrink-style) over those bytes, with a 256-byte window of
+ *    the preceding delta bytes: a 1 flag bit then 8 literal bits, or a 0
+ *    flag bit, 8 bits of distance - 1 and 4 bits of length - 3 (3..18).
+ *    Each record ends on a byte boundary, so a record is never split
+ *    between a flushed and a buffered part.
+ *
+ * The state restarts with every segment (sensor_sink_set_filter()), whose
+ * header carries @ref SENSOR_PACK_MAGIC instead of @ref SENSOR_REC_MAGIC;
+ * the rest of the header is the plain sensor_rec.h one. All state is
+ * static (about 0.8 KiB per packer, plus 8 bytes per type and
+ * @ref SENSOR_PACK_MAX_CHAN); matching is a brute-force window scan, so
+ * the cost per record is bounded by its length times the window.
+ * `scripts/srec2csv.py` reads packed logs too.
+ *
+ * Example:
+ * @code
+ *  SENSOR_PACK_DEFINE(log_pack, types);
+ *
+ *  hdr_len = sensor_pack_header(&log_pack, hdr, sizeof(hdr));
+ *  sensor_sink_set_header(&log_sink, hdr, hdr_len);
+ *  sensor_sink_set_filter(&log_sink, sensor_pack_filter, &log_pack);
+ *  ...
+ *  n = sensor_rec_encode(&types[0], t_ms, v, rec);
+ *  sensor_sink_append(&log_sink, rec, n);	// packed under the sink lock
+ * @endcode
+ */
+
+#define SENSOR_PACK_MAGIC	0x5a455253	/**< "SREZ" read as a little-endian u32. */
+#define SENSOR_PACK_WINDOW	256		/**< LZ window (bytes of history). */
+#define SENSOR_PACK_MIN_MATCH	3		/**< Shortest match worth a token. */
+#define SENSOR_PACK_MAX_MATCH	18		/**< Longest match (4-bit length). */
+
+/** @brief Largest channel count of one record type. */
+#define SENSOR_PACK_MAX_CHAN	CONFIG_SENSOR_UTILS_PACK_MAX_CHAN
+
+/** @brief Delta bytes of the largest record: tag, then up to 5 per varint. */
+#define SENSOR_PACK_DELTA_MAX	(1 + 5 * (1 + SENSOR_PACK_MAX_CHAN))
+
+/** @brief Packed bytes of the largest record (9 bits per literal). */
+#define SENSOR_PACK_OUT_MAX	((SENSOR_PACK_DELTA_MAX * 9 + 7) / 8)
+
+/** @brief Counters since boot; take copies with sensor_pack_get_stats(). */
+struct sensor_pack_stats {
+	uint32_t	records;	/**< Records packed. */
+	uint32_t	in;		/**< Record bytes in (sensor_rec_encode() size). */
+	uint32_t	delta;		/**< Bytes after the delta/varint stage. */
+	uint32_t	out;		/**< Bytes after LZSS. */
+	uint32_t	restarts;	/**< Segment starts. */
+	uint64_t	cycles;		/**< Packing time, in @c k_cycle_get_32() cycles. */
+	uint32_t	max_cycles;	/**< Slowest record. */
+};
+
+/** @brief Packer state; define with @ref SENSOR_PACK_DEFINE. */
+struct sensor_pack {
+	const struct sensor_rec_type	*types;		/**< Record types. */
+	size_t				ntypes;		/**< Entries in @ref types. */
+	int32_t				*prev;		/**< Last values, per type. */
+	int32_t				*dump_prev;	/**< Same, for sensor_pack_dump(). */
+	uint32_t			prev_t;		/**< Last timestamp. */
+	uint8_t				hist[SENSOR_PACK_WINDOW + SENSOR_PACK_DELTA_MAX];
+							/**< Window, then the record. */
+	size_t				hist_len;	/**< Window bytes in @ref hist. */
+	uint8_t				out[SENSOR_PACK_OUT_MAX];	/**< Last packed record. */
+	struct sensor_pack_stats	stats;		/**< Counters. */
+};
+
+/**
+ * @brief Statically allocate a packer named @p _name for the type array
+ *        @p _types (SENSOR_PACK_MAX_CHAN channels per type at most).
+ */
+#define SENSOR_PACK_DEFINE(_name, _types)						\
+	static int32_t _name##_prev[2][ARRAY_SIZE(_types) * SENSOR_PACK_MAX_CHAN];	\
+	static struct sensor_pack _name = {						\
+		.types = (_types), .ntypes = ARRAY_SIZE(_types),			\
+		.prev = _name##_prev[0], .dump_prev = _name##_prev[1],			\
+	}
+
+/**
+ * @brief Build the segment header of a packed log (see sensor_rec_header()).
+ *
+ * @return header bytes, or 0 if @p out is too small or a type has more
+ *         than @ref SENSOR_PACK_MAX_CHAN channels.
+ */
+size_t sensor_pack_header(const struct sensor_pack *pk, uint8_t *out, size_t len);
+
+/** @brief Forget all history; the next record is packed as a segment's first. */
+void sensor_pack_restart(struct sensor_pack *pk);
+
+/**
+ * @brief Pack one record.
+ *
+ * @param pk  Packer.
+ * @param rec Record from sensor_rec_encode().
+ * @param len Bytes in @p rec.
+ * @param out Set to the packed bytes (valid until the next call).
+ *
+ * @return packed bytes.
+ * @retval -EINVAL if the tag or the length does not match a type.
+ */
+int sensor_pack_record(struct sensor_pack *pk, const uint8_t *rec, size_t len,
+		       const uint8_t **out);
+
+/** @brief sensor_sink_filter_t adapter, @p ctx is the @ref sensor_pack. */
+int sensor_pack_filter(void *ctx, bool restart, const void *in, size_t len, const void **out);
+
+/** @brief Copy the counters of @p pk (may tear while the sink appends). */
+void sensor_pack_get_stats(const struct sensor_pack *pk, struct sensor_pack_stats *out);
+
+/**
+ * @brief Print a packed log as CSV (packed counterpart of sensor_rec_dump()).
+ *
+ * Unpacks with the types of @p pk and its own scratch values, so it runs
+ * beside the appends, but only one dump per packer at a time. @p hdr must
+ * be the header from sensor_pack_header(); @p max_bytes counts unpacked
+ * record bytes, as for sensor_rec_dump(). Uses about 1.4 KiB of stack.
+ *
+ * @return records printed, or a negative errno (-EBADMSG: header mismatch
+ *         or corrupt stream).
+ */
+int sensor_pack_dump(struct sensor_pack *pk, const char *path, const uint8_t *hdr,
+		     size_t hdr_len, size_t *max_bytes, sensor_rec_print_t print, void *ctx);
+
+#endif /* SENSOR_PACK_H */
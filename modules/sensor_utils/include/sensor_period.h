@@ -0,0 +1,125 @@
+#ifndef SENSOR_PERIOD_H
+#define SENSOR_PERIOD_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_period.h
+ * @brief Drift-free periodic wake-ups on a @c k_timer, re-ratable at runtime.
+ *
+ * The kernel re-arms a periodic @c k_timer from its previous deadline, so
+ * the time spent working between two wake-ups does not push the schedule
+ * (unlike @c k_msleep(period) after the work). Missed periods are counted
+ * instead of being replayed, and another thread (e.g. the shell) may change
+ * the period while the owner is blocked in sensor_period_wait().
+ *
+ * Owners that must not block (e.g. a work item) initialise the schedule
+ * with sensor_period_init_notify(), get called from the timer on every
+ * deadline, and collect the elapsed periods with sensor_period_poll().
+ *
+ * Example:
+ * @code
+ *  static struct sensor_period tick;
+ *
+ *  sensor_period_init(&tick, 1000);
+ *  sensor_period_start(&tick);
+ *  while (sensor_period_wait(&tick) > 0) {
+ *          sample();
+ *  }
+ * @endcode
+ */
+
+/** @brief Periodic schedule state; one owner thread waits on it. */
+struct sensor_period {
+	struct k_timer	timer;		/**< Kernel timer providing the deadlines. */
+	atomic_t	period_ms;	/**< Current period. */
+	atomic_t	rerate;		/**< Set when @ref period_ms changed. */
+	atomic_t	running;	/**< Cleared by sensor_period_stop(). */
+	atomic_t	expiries;	/**< Periods elapsed since start/reset. */
+	atomic_t	overruns;	/**< Periods missed by the owner since start/reset. */
+	bool		notify;		/**< Owner is notified by an expiry callback. */
+};
+
+/**
+ * @brief Initialise a (stopped) periodic schedule.
+ *
+ * @param sp        Schedule.
+ * @param period_ms Initial period in milliseconds (> 0).
+ */
+void sensor_period_init(struct sensor_period *sp, uint32_t period_ms);
+
+/**
+ * @brief Initialise a (stopped) schedule that notifies its owner.
+ *
+ * @param sp        Schedule.
+ * @param period_ms Initial period in milliseconds (> 0).
+ * @param expiry    Called in ISR context on every deadline; typically
+ *                  submits a work item that calls sensor_period_poll().
+ */
+void sensor_period_init_notify(struct sensor_period *sp, uint32_t period_ms,
+			       k_timer_expiry_t expiry);
+
+/** @brief Start (or restart) the schedule; the first wake-up is one period away. */
+void sensor_period_start(struct sensor_period *sp);
+
+/** @brief Stop the schedule; a blocked sensor_period_wait() returns 0. */
+void sensor_period_stop(struct sensor_period *sp);
+
+/**
+ * @brief Change the period from any thread.
+ *
+ * Takes effect immediately: a blocked waiter is released, re-arms the timer
+ * with the new period and keeps waiting (it does not see an extra wake-up).
+ *
+ * @param sp        Schedule.
+ * @param period_ms New period in milliseconds (> 0).
+ */
+void sensor_period_set(struct sensor_period *sp, uint32_t period_ms);
+
+/**
+ * @brief Block until the next deadline.
+ *
+ * @retval >0 Number of periods elapsed since the previous return; anything
+ *            above 1 means the owner overran and was added to the overrun
+ *            counter.
+ * @retval 0  The schedule was stopped.
+ */
+uint32_t sensor_period_wait(struct sensor_period *sp);
+
+/**
+ * @brief Collect the deadlines passed since the previous poll (non-blocking).
+ *
+ * For schedules created with sensor_period_init_notify().
+ *
+ * @return Number of periods elapsed; above 1 counts as overrun.
+ */
+uint32_t sensor_period_poll(struct sensor_period *sp);
+
+/** @brief Current period in milliseconds. */
+static inline uint32_t sensor_period_get(const struct sensor_period *sp)
+{
+	return (uint32_t)atomic_get(&sp->period_ms);
+}
+
+/** @brief Periods missed by the owner since start or the last reset. */
+static inline uint32_t sensor_period_overruns(const struct sensor_period *sp)
+{
+	return (uint32_t)atomic_get(&sp->overruns);
+}
+
+/** @brief Periods elapsed since start or the last reset. */
+static inline uint32_t sensor_period_expiries(const struct sensor_period *sp)
+{
+	return (uint32_t)atomic_get(&sp->expiries);
+}
+
+/** @brief Clear the expiry and overrun counters. */
+static inline void sensor_period_reset_stats(struct sensor_period *sp)
+{
+	atomic_clear(&sp->expiries);
+	atomic_clear(&sp->overruns);
+}
+
+#endif /* SENSOR_PERIOD_H */
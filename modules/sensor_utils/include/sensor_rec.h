@@ -0,0 +1,170 @@
+#ifndef SENSOR_REC_H
+#define SENSOR_REC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @file sensor_rec.h
+ * @brief Versioned, self-describing binary record log.
+ *
+ * A log file starts with a header that describes every record type it may
+ * contain; each record is then a fixed-width packed struct of the type's
+ * channels. All fields are little-endian:
+ *
+ * @code
+ *  header    u32 magic "SREC"   u8 version   u8 types   u16 header bytes
+ *  per type  u8 tag   u8 channels   u16 record bytes   char name[8]
+ *  per chan  char name[8]   char unit[6]   u8 width (1/2/4, signed)   i8 exp
+ *  record    u8 tag   u32 t_ms   channel values
+ * @endcode
+ *
+ * A stored channel value @c s means @c s * 10^exp in the channel's unit
+ * (exp from -9 to 9); the most negative value of its width marks a
+ * missing sample. Names and units are NUL-padded and not NUL-terminated
+ * when they fill their field.
+ * A reader needs nothing but the header, so a new channel or record type
+ * is a new header, not a new decoder; a layout change bumps
+ * @ref SENSOR_REC_VERSION. `scripts/srec2csv.py` converts a log to CSV on
+ * the host.
+ *
+ * Encoding is a divide and a store per channel, so a record costs a
+ * fraction of a formatted text line and a few times less flash.
+ *
+ * Example:
+ * @code
+ *  static const struct sensor_rec_chan ch[] = {
+ *      SENSOR_REC_CHAN("temp", "C", 2, -2),	// 0.01 C in an int16
+ *  };
+ *  static const struct sensor_rec_type types[] = { SENSOR_REC_TYPE(0, "row", ch) };
+ *  uint8_t hdr[64], rec[8];
+ *  int32_t v[] = { temp_micro };
+ *
+ *  len = sensor_rec_header(types, 1, hdr, sizeof(hdr));
+ *  n = sensor_rec_encode(&types[0], k_uptime_get_32(), v, rec);
+ * @endcode
+ */
+
+#define SENSOR_REC_MAGIC	0x43455253	/**< "SREC" read as a little-endian u32. */
+#define SENSOR_REC_VERSION	1		/**< Layout version of this file format. */
+#define SENSOR_REC_NAME_LEN	8		/**< Bytes of a type or channel name. */
+#define SENSOR_REC_UNIT_LEN	6		/**< Bytes of a channel unit. */
+#define SENSOR_REC_HDR_LEN	8		/**< Fixed part of the header. */
+#define SENSOR_REC_TYPE_LEN	12		/**< Bytes per type descriptor. */
+#define SENSOR_REC_CHAN_LEN	16		/**< Bytes per channel descriptor. */
+#define SENSOR_REC_PREFIX	5		/**< Tag + timestamp of every record. */
+
+/** @brief Encoder input of a missing value. */
+#define SENSOR_REC_NONE		INT32_MIN
+
+/** @brief One channel of a record type. */
+struct sensor_rec_chan {
+	const char	*name;		/**< Column name, up to 8 chars. */
+	const char	*unit;		/**< Unit, up to 6 chars. */
+	uint8_t		width;		/**< Stored bytes: 1, 2 or 4 (signed). */
+	int8_t		exp;		/**< Decimal exponent of the stored LSB. */
+	int8_t		src_exp;	/**< Decimal exponent of the encoder input. */
+};
+
+/**
+ * @brief Channel fed with micro-units (sensor_fixp.h), stored as
+ *        @p _width bytes of 10^@p _exp units.
+ */
+#define SENSOR_REC_CHAN(_name, _unit, _width, _exp)					\
+	{ .name = (_name), .unit = (_unit), .width = (_width), .exp = (_exp), .src_exp = -6 }
+
+/** @brief Channel stored as given (counts, milliseconds, bit masks). */
+#define SENSOR_REC_CHAN_RAW(_name, _unit, _width)					\
+	{ .name = (_name), .unit = (_unit), .width = (_width), .exp = 0, .src_exp = 0 }
+
+/** @brief One record type. */
+struct sensor_rec_type {
+	uint8_t				tag;	/**< First byte of its records. */
+	const char			*name;	/**< Type name, up to 8 chars. */
+	const struct sensor_rec_chan	*chan;	/**< Channels, in record order. */
+	uint8_t				nchan;	/**< Entries in @ref chan. */
+};
+
+/** @brief @ref sensor_rec_type initialiser from a channel array. */
+#define SENSOR_REC_TYPE(_tag, _name, _chans)						\
+	{ .tag = (_tag), .name = (_name), .chan = (_chans), .nchan = ARRAY_SIZE(_chans) }
+
+/** @brief Bytes of one record of @p t, tag and timestamp included. */
+size_t sensor_rec_size(const struct sensor_rec_type *t);
+
+/**
+ * @brief Build the file header describing @p types.
+ *
+ * @param types  Record types.
+ * @param ntypes Entries in @p types.
+ * @param out    Destination.
+ * @param len    Size of @p out.
+ *
+ * @return header bytes, or 0 if @p out is too small.
+ */
+size_t sensor_rec_header(const struct sensor_rec_type *types, size_t ntypes,
+			 uint8_t *out, size_t len);
+
+/**
+ * @brief Pack one record.
+ *
+ * Values are rounded to the channel's resolution and saturated to its
+ * width; @ref SENSOR_REC_NONE is stored as the missing-value marker.
+ *
+ * @param t    Record type.
+ * @param t_ms Timestamp (uptime) in ms.
+ * @param v    One value per channel, in the channel's input unit.
+ * @param out  Destination, sensor_rec_size() bytes.
+ *
+ * @return bytes written.
+ */
+size_t sensor_rec_encode(const struct sensor_rec_type *t, uint32_t t_ms, const int32_t *v,
+			 uint8_t *out);
+
+/**
+ * @brief Format the CSV column header of @p t: `type,t_ms,name[unit],...`.
+ *
+ * @return characters written (snprintk semantics).
+ */
+int sensor_rec_csv_header(const struct sensor_rec_type *t, char *out, size_t len);
+
+/**
+ * @brief Format one record as a CSV line: `type,t_ms,value,...`.
+ *
+ * Missing values are empty fields.
+ *
+ * @return characters written (snprintk semantics).
+ */
+int sensor_rec_csv(const struct sensor_rec_type *t, const uint8_t *rec, char *out, size_t len);
+
+/** @brief Line sink of sensor_rec_dump(). */
+typedef void (*sensor_rec_print_t)(void *ctx, const char *line);
+
+/**
+ * @brief Print a record log as CSV.
+ *
+ * The file header must be byte-identical to @p hdr (the header this build
+ * writes); a log written with another layout is left to the host decoder.
+ * Uses about 1 KiB of stack for the record and line buffers; a record
+ * cut short at the end of the file (reset during a write) ends the dump.
+ *
+ * @param path      Log file.
+ * @param hdr       Expected header.
+ * @param hdr_len   Bytes in @p hdr.
+ * @param types     Record types described by @p hdr.
+ * @param ntypes    Entries in @p types.
+ * @param max_bytes Record bytes left to print; decremented, the dump stops
+ *                  at 0 (lets several segments share one limit).
+ * @param print     Called with the column headers, then once per record.
+ * @param ctx       Passed to @p print.
+ *
+ * @return records printed.
+ * @retval -EBADMSG if the header does not match or a record tag is unknown.
+ * @retval negative errno from the file system.
+ */
+int sensor_rec_dump(const char *path, const uint8_t *hdr, size_t hdr_len,
+		    const struct sensor_rec_type *types, size_t ntypes, size_t *max_bytes,
+		    sensor_rec_print_t print, void *ctx);
+
+#endif /* SENSOR_REC_H */
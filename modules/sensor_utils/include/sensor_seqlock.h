@@ -0,0 +1,109 @@
+#ifndef SENSOR_SEQLOCK_H
+#define SENSOR_SEQLOCK_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file sensor_seqlock.h
+ * @brief Sequence lock for publishing a small snapshot struct.
+ *
+ * Writers bump an odd/even sequence counter around their update and are
+ * serialized by an internal spinlock, so several producers (e.g. one per
+ * sensor) may share one snapshot. Readers never take a lock: they copy the
+ * data and retry if the sequence moved or was odd, so a reader can never
+ * block a writer or cause priority inversion.
+ *
+ * Example:
+ * @code
+ *  static struct sensor_seqlock lock;
+ *  static struct sensor_data live;
+ *
+ *  k_spinlock_key_t key = sensor_seqlock_write_begin(&lock);
+ *  live.temp = t;
+ *  sensor_seqlock_write_end(&lock, key);
+ *
+ *  struct sensor_data snap;
+ *  SENSOR_SEQLOCK_READ(&lock, &snap, &live);
+ * @endcode
+ */
+
+/** @brief Sequence lock state; zero-initialised is a valid unlocked lock. */
+struct sensor_seqlock {
+	atomic_t		seq;	/**< Even: stable, odd: write in progress. */
+	struct k_spinlock	wlock;	/**< Serializes writers. */
+};
+
+/**
+ * @brief Begin a write section.
+ *
+ * Keep the section short: it runs with the writer spinlock held.
+ *
+ * @return Key to pass to sensor_seqlock_write_end().
+ */
+static inline k_spinlock_key_t sensor_seqlock_write_begin(struct sensor_seqlock *sl)
+{
+	k_spinlock_key_t key = k_spin_lock(&sl->wlock);
+
+	atomic_inc(&sl->seq);
+	barrier_dmem_fence_full();
+	return key;
+}
+
+/** @brief End a write section started by sensor_seqlock_write_begin(). */
+static inline void sensor_seqlock_write_end(struct sensor_seqlock *sl, k_spinlock_key_t key)
+{
+	barrier_dmem_fence_full();
+	atomic_inc(&sl->seq);
+	k_spin_unlock(&sl->wlock, key);
+}
+
+/**
+ * @brief Begin a read attempt.
+ *
+ * Spins while a writer (on another CPU) is inside its section.
+ *
+ * @return Sequence value to pass to sensor_seqlock_read_retry().
+ */
+static inline atomic_val_t sensor_seqlock_read_begin(const struct sensor_seqlock *sl)
+{
+	atomic_val_t s;
+
+	while ((s = atomic_get(&sl->seq)) & 1) {
+		/* writer active on another CPU */
+	}
+	barrier_dmem_fence_full();
+	return s;
+}
+
+/**
+ * @brief Check whether a read attempt must be repeated.
+ *
+ * @retval true if a writer ran since @p start (the copy may be torn).
+ */
+static inline bool sensor_seqlock_read_retry(const struct sensor_seqlock *sl, atomic_val_t start)
+{
+	barrier_dmem_fence_full();
+	return atomic_get(&sl->seq) != start;
+}
+
+/**
+ * @brief Copy @p src into @p dst consistently with respect to writers.
+ *
+ * @param sl  Sequence lock guarding @p src.
+ * @param dst Destination pointer (object of the same type as @p src).
+ * @param src Live object.
+ */
+#define SENSOR_SEQLOCK_READ(sl, dst, src)					\
+	do {									\
+		atomic_val_t _seq;						\
+		do {								\
+			_seq = sensor_seqlock_read_begin(sl);			\
+			memcpy((dst), (const void *)(src), sizeof(*(dst)));	\
+		} while (sensor_seqlock_read_retry((sl), _seq));		\
+	} while (0)
+
+#endif /* SENSOR_SEQLOCK_H */
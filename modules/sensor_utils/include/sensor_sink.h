@@ -0,0 +1,282 @@
+#ifndef SENSOR_SINK_H
+#define SENSOR_SINK_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_sink.h
+ * @brief Append-only log file kept open behind a RAM buffer.
+ *
+ * Opening, writing and closing the file for every record makes LittleFS
+ * commit its metadata once per record. A sink keeps the file open and
+ * collects records in a RAM buffer; the buffer is written and committed
+ * with @c fs_sync() when
+ * - it is full (size trigger; the write is exactly one buffer),
+ * - the oldest buffered byte is @c flush_ms old (time trigger, from the
+ *   system work queue),
+ * - the owner calls sensor_sink_flush() or sensor_sink_close() (shutdown
+ *   trigger: stop, before reading or removing the file).
+ *
+ * Records appended since the last commit are lost on a reset; the time
+ * trigger bounds that window. It runs @c fs_write() and @c fs_sync() (a
+ * LittleFS commit) on the system work queue, so a sink with a non-zero
+ * @c flush_ms needs @c CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE of at least
+ * 2048; the 1 KiB default overflows. The buffer size is checked to be a whole
+ * number of LittleFS cache lines, so a full-buffer write programs whole
+ * @c prog-size units.
+ *
+ * A segmented sink (@ref SENSOR_SINK_SEG_DEFINE) spreads the log over
+ * numbered files @c path.0, @c path.1, ... of at most @c seg_size bytes
+ * each: a record that would cross the limit starts the next segment, and
+ * the oldest segment is removed once more than @c seg_max exist, so the
+ * log never takes more than about @c seg_size * @c seg_max bytes. Appends
+ * stay on a small file, which keeps LittleFS's CTZ skip-list walks short,
+ * and every segment starts with the header, so each one decodes alone.
+ * The numbering resumes from the files found on the first append.
+ *
+ * A filter (sensor_sink_set_filter(), e.g. sensor_pack.h) transforms each
+ * record under the sink lock before it is stored. It is told when a new
+ * segment starts, so a stateful encoder can restart there and every
+ * segment stays decodable on its own. Reopening a non-empty segment (after
+ * a reboot or a failed write) starts the next one instead.
+ *
+ * Example:
+ * @code
+ *  SENSOR_SINK_SEG_DEFINE(log_sink, "/lfs/log.csv", 1024, 5000, 8192, 8);
+ *
+ *  sensor_sink_append(&log_sink, line, len);
+ *  ...
+ *  sensor_sink_for_each(&log_sink, print_file, sh);	// oldest first
+ *  sensor_sink_clear(&log_sink);
+ * @endcode
+ */
+
+/** @brief Buffer sizes must be a multiple of this (LittleFS cache line). */
+#if defined(CONFIG_FS_LITTLEFS_CACHE_SIZE)
+#define SENSOR_SINK_ALIGN	CONFIG_FS_LITTLEFS_CACHE_SIZE
+#else
+#define SENSOR_SINK_ALIGN	1
+#endif
+
+/** @brief Counters since boot; take copies with sensor_sink_get_stats(). */
+struct sensor_sink_stats {
+	uint32_t	appends;	/**< Records appended. */
+	uint32_t	bytes;		/**< Bytes appended. */
+	uint32_t	stored;		/**< Bytes stored after the filter, headers excluded. */
+	uint32_t	writes;		/**< @c fs_write() calls. */
+	uint32_t	syncs;		/**< @c fs_sync() calls (metadata commits). */
+	uint32_t	opens;		/**< @c fs_open() calls. */
+	uint32_t	errors;		/**< Failed open/write/sync. */
+	uint32_t	dropped;	/**< Bytes discarded after a failed write. */
+	uint32_t	rotations;	/**< Segments started because one was full. */
+	uint32_t	removed;	/**< Oldest segments removed for the budget. */
+};
+
+/**
+ * @brief Record filter, see sensor_sink_set_filter().
+ *
+ * @param ctx     Filter state.
+ * @param restart True for the first record of a new segment.
+ * @param in      Record passed to sensor_sink_append().
+ * @param len     Bytes in @p in.
+ * @param out     Set to the transformed record (owned by the filter).
+ *
+ * @return bytes at @p out, or a negative errno to fail the append.
+ */
+typedef int (*sensor_sink_filter_t)(void *ctx, bool restart, const void *in, size_t len,
+				    const void **out);
+
+/** @brief Sink state; define with @ref SENSOR_SINK_DEFINE. */
+struct sensor_sink {
+	const char			*path;		/**< File, created on first append. */
+	uint8_t				*buf;		/**< Record buffer. */
+	size_t				size;		/**< Capacity of @ref buf. */
+	uint32_t			flush_ms;	/**< Time trigger, 0 = off. */
+	uint32_t			seg_size;	/**< Segment size limit, 0 = one file. */
+	uint32_t			seg_max;	/**< Segments kept, oldest removed first. */
+	sensor_sink_filter_t		filter;		/**< Record transform, NULL = none. */
+	void				*filter_ctx;	/**< Passed to @ref filter. */
+	const void			*hdr;		/**< Written first into a new file. */
+	size_t				hdr_len;	/**< Bytes in @ref hdr, 0 = none. */
+	struct k_mutex			*lock;		/**< Guards everything below. */
+	struct k_work_delayable		*timer;		/**< Time trigger. */
+	struct fs_file_t		file;		/**< Open handle when @ref open. */
+	size_t				fill;		/**< Bytes in @ref buf. */
+	bool				open;		/**< @ref file is open. */
+	bool				dirty;		/**< Written since the last sync. */
+	bool				scanned;	/**< @ref seg_first / @ref seg_last known. */
+	bool				restart;	/**< Next record starts a segment. */
+	bool				held;		/**< Appends refused (sensor_sink_hold()). */
+	uint32_t			seg_first;	/**< Oldest segment number. */
+	uint32_t			seg_last;	/**< Segment appended to. */
+	size_t				seg_used;	/**< Bytes in it, buffered ones included. */
+	struct sensor_sink_stats	stats;		/**< Counters. */
+};
+
+/** @cond INTERNAL_HIDDEN */
+void sensor_sink_timeout(struct sensor_sink *sk);
+/** @endcond */
+
+/** @brief Longest segment file name, terminator included. */
+#define SENSOR_SINK_NAME_MAX	64
+
+/**
+ * @brief Statically allocate a segmented sink named @p _name.
+ *
+ * @param _name     Sink variable.
+ * @param _path     File path; segments are @p _path.<n>.
+ * @param _size     Buffer bytes, a multiple of @ref SENSOR_SINK_ALIGN.
+ * @param _flush_ms Longest time a record stays in RAM, 0 for no time trigger.
+ * @param _seg_size Bytes per segment (header included), 0 for one file.
+ * @param _seg_max  Segments kept; the total budget is @p _seg_size * @p _seg_max.
+ */
+#define SENSOR_SINK_SEG_DEFINE(_name, _path, _size, _flush_ms, _seg_size, _seg_max)	\
+	BUILD_ASSERT((_size) > 0 && (_size) % SENSOR_SINK_ALIGN == 0,			\
+		     "sink buffer must be a multiple of the LittleFS cache size");	\
+	BUILD_ASSERT((_seg_max) > 0, "a sink keeps at least one segment");		\
+	static struct sensor_sink _name;						\
+	static void _name##_timeout(struct k_work *work)				\
+	{										\
+		ARG_UNUSED(work);							\
+		sensor_sink_timeout(&_name);						\
+	}										\
+	static K_MUTEX_DEFINE(_name##_lock);						\
+	static K_WORK_DELAYABLE_DEFINE(_name##_timer, _name##_timeout);		\
+	static uint8_t _name##_buf[_size];						\
+	static struct sensor_sink _name = {						\
+		.path = (_path), .buf = _name##_buf, .size = (_size),			\
+		.flush_ms = (_flush_ms), .lock = &_name##_lock,				\
+		.timer = &_name##_timer, .seg_size = (_seg_size),			\
+		.seg_max = (_seg_max),							\
+	}
+
+/**
+ * @brief Statically allocate a single-file sink named @p _name.
+ *
+ * @param _name     Sink variable.
+ * @param _path     File path.
+ * @param _size     Buffer bytes, a multiple of @ref SENSOR_SINK_ALIGN.
+ * @param _flush_ms Longest time a record stays in RAM, 0 for no time trigger.
+ */
+#define SENSOR_SINK_DEFINE(_name, _path, _size, _flush_ms)				\
+	SENSOR_SINK_SEG_DEFINE(_name, _path, _size, _flush_ms, 0, 1)
+
+/**
+ * @brief Set the file header (e.g. CSV column names or a sensor_rec.h header).
+ *
+ * Whenever the sink opens a file (segment) and finds it missing or empty, @p hdr is
+ * written ahead of the first record. Call before the first append; @p hdr
+ * must stay valid.
+ */
+void sensor_sink_set_header(struct sensor_sink *sk, const void *hdr, size_t len);
+
+/**
+ * @brief Pass every record through @p fn before it is stored.
+ *
+ * Only for segmented sinks; call before the first append.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @p sk is a single-file sink.
+ */
+int sensor_sink_set_filter(struct sensor_sink *sk, sensor_sink_filter_t fn, void *ctx);
+
+/**
+ * @brief Append one record.
+ *
+ * Opens the file on first use (or after a close), writing the header into
+ * a new file, copies @p data into the
+ * buffer and writes + commits each time the buffer fills; a record longer
+ * than the buffer is written in buffer-sized pieces. A segmented sink first
+ * moves on to the next segment if @p data would overflow the current one.
+ *
+ * @param sk   Sink.
+ * @param data Record.
+ * @param len  Bytes in @p data.
+ *
+ * @retval 0 on success (the record may still be in RAM).
+ * @retval -EAGAIN while held (sensor_sink_hold()).
+ * @retval negative errno from @c fs_open / @c fs_write / @c fs_sync. On a
+ *         write error the buffered bytes are dropped and the file is
+ *         closed, so the next append reopens it.
+ */
+int sensor_sink_append(struct sensor_sink *sk, const void *data, size_t len);
+
+/**
+ * @brief Write the buffered records and commit them (@c fs_sync).
+ *
+ * @retval 0 on success or if nothing was pending.
+ * @retval negative errno otherwise.
+ */
+int sensor_sink_flush(struct sensor_sink *sk);
+
+/**
+ * @brief Flush, then close the file (e.g. before removing or renaming it).
+ *
+ * The next sensor_sink_append() reopens @c path.
+ *
+ * @retval 0 on success.
+ * @retval negative errno from the flush or @c fs_close.
+ */
+int sensor_sink_close(struct sensor_sink *sk);
+
+/**
+ * @brief Refuse appends until released, e.g. while the volume is unmounted.
+ *
+ * Holding flushes and closes the file under the sink lock, so no append
+ * still in progress can keep it open; appends then fail with -EAGAIN
+ * until sensor_sink_hold() is called with @p hold false. Clearing and
+ * reading still work while held.
+ *
+ * @param sk   Sink.
+ * @param hold true to hold, false to release.
+ *
+ * @retval 0 on success.
+ * @retval negative errno from the flush or @c fs_close (held anyway).
+ */
+int sensor_sink_hold(struct sensor_sink *sk, bool hold);
+
+/**
+ * @brief Flush, close and remove every file of the sink.
+ *
+ * Numbering restarts at 0; the next append creates the file again.
+ *
+ * @retval 0 on success (missing files are not an error).
+ * @retval negative errno from the flush or @c fs_unlink.
+ */
+int sensor_sink_clear(struct sensor_sink *sk);
+
+/**
+ * @brief Range of segment numbers on the volume.
+ *
+ * @param sk    Sink.
+ * @param first Oldest segment (may be NULL).
+ * @param last  Segment appended to (may be NULL).
+ *
+ * @return number of segments, 1 for a single-file sink.
+ * @retval negative errno if the directory could not be read.
+ */
+int sensor_sink_segments(struct sensor_sink *sk, uint32_t *first, uint32_t *last);
+
+/** @brief Called by sensor_sink_for_each() with each file path. */
+typedef int (*sensor_sink_file_cb)(const char *path, void *ctx);
+
+/**
+ * @brief Call @p cb for every file of the sink, oldest first.
+ *
+ * The lock is not held during @p cb, so appends go on; a segment removed
+ * meanwhile (callback returns -ENOENT) is skipped. Flush first to include
+ * buffered records.
+ *
+ * @retval 0 after the last file or when @p cb returns a positive value.
+ * @retval negative errno returned by @p cb or sensor_sink_segments().
+ */
+int sensor_sink_for_each(struct sensor_sink *sk, sensor_sink_file_cb cb, void *ctx);
+
+/** @brief Copy the counters of @p sk; @p fill gets the bytes still in RAM (may be NULL). */
+void sensor_sink_get_stats(struct sensor_sink *sk, struct sensor_sink_stats *out, size_t *fill);
+
+#endif /* SENSOR_SINK_H */
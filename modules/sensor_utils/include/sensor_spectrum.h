@@ -0,0 +1,103 @@
+#ifndef SENSOR_SPECTRUM_H
+#define SENSOR_SPECTRUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+#include <arm_math.h>
+
+/**
+ * @file sensor_spectrum.h
+ * @brief Q15 real-FFT power spectrum with band energies and peak frequency.
+ *
+ * A block of @c n micro-unit samples per axis is mean-removed, scaled to
+ * Q15 against a full-scale value, Hann-windowed and transformed with the
+ * CMSIS-DSP @c arm_rfft_q15 (SIMD on Cortex-M4/M7). The squared bin
+ * magnitudes of every axis added since the last clear are summed, so the
+ * spectrum of a three-axis accelerometer does not depend on how the board
+ * is mounted.
+ *
+ * Example:
+ * @code
+ *  SENSOR_SPECTRUM_DEFINE(spec, 256);
+ *  struct sensor_spectrum_result res;
+ *
+ *  sensor_spectrum_init(&spec);
+ *  sensor_spectrum_clear(&spec);
+ *  for (int k = 0; k < 3; k++) {
+ *      sensor_spectrum_add(&spec, &blk[0][k], 3, 39226600);
+ *  }
+ *  sensor_spectrum_features(&spec, odr_mhz, &res);
+ * @endcode
+ */
+
+#define SENSOR_SPECTRUM_BANDS	8	/**< Equal-width bands from DC to Nyquist. */
+
+/** @brief FFT state and buffers; define with @ref SENSOR_SPECTRUM_DEFINE. */
+struct sensor_spectrum {
+	arm_rfft_instance_q15	rfft;	/**< CMSIS-DSP instance. */
+	uint16_t		n;	/**< FFT length (power of two, 32..4096). */
+	q15_t			*win;	/**< Hann window, @c n entries. */
+	q15_t			*in;	/**< Scratch input, @c n entries. */
+	q15_t			*out;	/**< Complex output, 2 x @c n entries. */
+	uint32_t		*pow;	/**< Summed |X[k]|^2 / 4, @c n / 2 bins. */
+	uint16_t		axes;	/**< Blocks added since the last clear. */
+};
+
+/** @brief Spectral features of the accumulated blocks. */
+struct sensor_spectrum_result {
+	uint32_t	peak_mhz;			/**< Centre of the strongest non-DC bin. */
+	uint32_t	peak_pow;			/**< Power of that bin (raw units). */
+	uint64_t	total;				/**< Power of bins 1..n/2-1 (raw units). */
+	uint16_t	band_pm[SENSOR_SPECTRUM_BANDS];	/**< Share of @ref total per band, ‰. */
+};
+
+/**
+ * @brief Statically allocate a spectrum named @p _name of length @p _n.
+ */
+#define SENSOR_SPECTRUM_DEFINE(_name, _n)						\
+	BUILD_ASSERT(((_n) & ((_n) - 1)) == 0 && (_n) >= 32 && (_n) <= 4096,		\
+		     "spectrum length must be a power of two in 32..4096");		\
+	static q15_t _name##_win[_n];							\
+	static q15_t _name##_in[_n];							\
+	static q15_t _name##_out[2 * (_n)];						\
+	static uint32_t _name##_pow[(_n) / 2];						\
+	static struct sensor_spectrum _name = {						\
+		.n = (_n), .win = _name##_win, .in = _name##_in,			\
+		.out = _name##_out, .pow = _name##_pow,					\
+	}
+
+/**
+ * @brief Initialise the FFT instance and the window table.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the length is not supported by CMSIS-DSP.
+ */
+int sensor_spectrum_init(struct sensor_spectrum *sp);
+
+/** @brief Drop the accumulated power spectrum. */
+void sensor_spectrum_clear(struct sensor_spectrum *sp);
+
+/**
+ * @brief Transform one axis and add its power spectrum.
+ *
+ * @param sp         Spectrum.
+ * @param x          First sample (micro-units); @c n samples are read.
+ * @param stride     Distance between consecutive samples, in int32 units.
+ * @param full_scale Micro-unit amplitude mapped to Q15 full scale; larger
+ *                   deviations from the block mean saturate.
+ */
+void sensor_spectrum_add(struct sensor_spectrum *sp, const int32_t *x, size_t stride,
+			 int32_t full_scale);
+
+/**
+ * @brief Extract band shares and the peak from the accumulated spectrum.
+ *
+ * @param sp     Spectrum.
+ * @param fs_mhz Sample rate of the blocks in mHz.
+ * @param res    Destination.
+ */
+void sensor_spectrum_features(const struct sensor_spectrum *sp, uint32_t fs_mhz,
+			      struct sensor_spectrum_result *res);
+
+#endif /* SENSOR_SPECTRUM_H */
@@ -0,0 +1,68 @@
+#ifndef SENSOR_STAT_H
+#define SENSOR_STAT_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+/**
+ * @file sensor_stat.h
+ * @brief Cycle-count latency statistics for one pipeline stage.
+ *
+ * Each stage keeps count, min, max, sum and a log2 histogram of durations
+ * measured with @c k_cycle_get_32(). Bucket @c k holds durations in
+ * [2^k, 2^(k+1)) cycles (bucket 0 also holds 0), so one 32-bit counter per
+ * power of two covers the full 32-bit cycle range with no configuration.
+ *
+ * Example:
+ * @code
+ *  static struct sensor_stat fs_write_stat = SENSOR_STAT_INIT("fs_write");
+ *
+ *  uint32_t t0 = k_cycle_get_32();
+ *  fs_write(&file, buf, len);
+ *  sensor_stat_record(&fs_write_stat, k_cycle_get_32() - t0);
+ * @endcode
+ */
+
+#define SENSOR_STAT_BUCKETS	32	/**< One bucket per bit of a cycle count. */
+
+/** @brief Latency statistics of one stage; take copies with sensor_stat_get(). */
+struct sensor_stat {
+	const char		*name;				/**< Stage label. */
+	uint32_t		count;				/**< Recorded samples. */
+	uint32_t		min;				/**< Shortest, in cycles. */
+	uint32_t		max;				/**< Longest, in cycles. */
+	uint64_t		sum;				/**< Total, in cycles. */
+	uint32_t		hist[SENSOR_STAT_BUCKETS];	/**< log2(cycles) histogram. */
+	struct k_spinlock	lock;				/**< Guards the fields above. */
+};
+
+/** @brief Static initializer for a named, empty stage. */
+#define SENSOR_STAT_INIT(_name) { .name = (_name), .min = UINT32_MAX }
+
+/**
+ * @brief Record one duration.
+ *
+ * @param st     Stage.
+ * @param cycles Duration in hardware cycles (difference of two
+ *               @c k_cycle_get_32() reads; wraps correctly).
+ */
+void sensor_stat_record(struct sensor_stat *st, uint32_t cycles);
+
+/** @brief Clear all counters of @p st (keeps its name). */
+void sensor_stat_reset(struct sensor_stat *st);
+
+/**
+ * @brief Take a consistent copy of @p st for printing.
+ *
+ * @param st  Stage.
+ * @param out Destination; its @c lock member must not be used.
+ */
+void sensor_stat_get(struct sensor_stat *st, struct sensor_stat *out);
+
+/** @brief Convert a cycle count to microseconds. */
+static inline uint32_t sensor_stat_cyc_to_us(uint64_t cycles)
+{
+	return (uint32_t)k_cyc_to_us_floor64(cycles);
+}
+
+#endif /* SENSOR_STAT_H */
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Convert a sensor_rec.h binary log (e.g. /lfs/senslog.bin) to CSV.
+
+The file header describes every record type, so this decoder needs no
+knowledge of the application that wrote the log. Packed logs
+(sensor_pack.h, "SREZ" magic) are unpacked first:
+
+    srec2csv.py senslog.bin                  # every type, column header line per type
+    srec2csv.py sensor.bin -t agg -o agg.csv # only the "agg" records
+
+Missing samples become empty fields. A record cut short at the end of the
+file (reset during a write) is dropped with a warning.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x43455253  # "SREC"
+PACK_MAGIC = 0x5A455253  # "SREZ"
+VERSION = 1
+HDR = struct.Struct("<IBBH")
+TYPE = struct.Struct("<BBH8s")
+CHAN = struct.Struct("<8s6sBb")
+PREFIX = struct.Struct("<BI")
+INT = {1: "b", 2: "h", 4: "i"}
+
+
+class RecType:
+    def __init__(self, tag, name, size, chans):
+        self.tag = tag
+        self.name = name
+        self.size = size
+        self.chans = chans  # (name, unit, width, exp)
+        self.values = struct.Struct("<" + "".join(INT[c[2]] for c in chans))
+        self.missing = [-(1 << (8 * c[2] - 1)) for c in chans]
+
+    def columns(self):
+        return [f"{n}[{u}]" if u else n for n, u, _, _ in self.chans]
+
+    def unpack(self, values, t_ms):
+        """Fixed-layout record of the stored values (sensor_pack.h)."""
+        return PREFIX.pack(self.tag, t_ms) + self.values.pack(*values)
+
+    def decode(self, rec):
+        out = []
+        for s, lo, (_, _, _, exp) in zip(self.values.unpack_from(rec, PREFIX.size),
+                                         self.missing, self.chans):
+            if s == lo:
+                out.append("")
+            elif exp >= 0:
+                out.append(str(s * 10 ** exp))
+            else:
+                a = abs(s)
+                d = 10 ** -exp
+                out.append(f"{'-' if s < 0 else ''}{a // d}.{a % d:0{-exp}d}")
+        return out
+
+
+def text(field):
+    return field.rstrip(b"\0").decode("ascii", "replace")
+
+
+def parse_header(data):
+    if len(data) < HDR.size:
+        raise ValueError("file shorter than the header")
+    magic, version, ntypes, hdr_len = HDR.unpack_from(data)
+    if magic not in (MAGIC, PACK_MAGIC):
+        raise ValueError(f"bad magic 0x{magic:08x}")
+    if version != VERSION:
+        raise ValueError(f"unsupported version {version}")
+
+    types, off = {}, HDR.size
+    for _ in range(ntypes):
+        tag, nchan, size, name = TYPE.unpack_from(data, off)
+        off += TYPE.size
+        chans = []
+        for _ in range(nchan):
+            cname, unit, width, exp = CHAN.unpack_from(data, off)
+            off += CHAN.size
+            if width not in INT:
+                raise ValueError(f"channel {text(cname)}: bad width {width}")
+            chans.append((text(cname), text(unit), width, exp))
+        t = RecType(tag, text(name), size, chans)
+        if PREFIX.size + t.values.size != size:
+            raise ValueError(f"type {t.name}: record size mismatch")
+        types[tag] = t
+    if off != hdr_len:
+        raise ValueError("header length mismatch")
+    return types, hdr_len, magic == PACK_MAGIC
+
+
+class Bits:
+    """MSB-first bit reader; None once the data runs out."""
+
+    def __init__(self, data, off):
+        self.data, self.pos, self.bit = data, off, 0
+
+    def get(self, n):
+        v = 0
+        for _ in range(n):
+            if self.pos >= len(self.data):
+                return None
+            v = (v << 1) | ((self.data[self.pos] >> (7 - self.bit)) & 1)
+            self.bit += 1
+            if self.bit == 8:
+                self.pos, self.bit = self.pos + 1, 0
+        return v
+
+    def align(self):
+        if self.bit:
+            self.pos, self.bit = self.pos + 1, 0
+
+
+class Truncated(Exception):
+    pass
+
+
+def records(data, off, types):
+    """Yield (offset, type, record) of a plain log."""
+    while off < len(data):
+        t = types.get(data[off])
+        if t is None:
+            raise ValueError(f"unknown record tag {data[off]} at offset {off}")
+        if off + t.size > len(data):
+            print(f"dropped a truncated record at offset {off}", file=sys.stderr)
+            return
+        yield off, t, data[off:off + t.size]
+        off += t.size
+
+
+def unpack(data, off, types):
+    """Yield (offset, type, record) of a packed log: LZSS, then deltas."""
+    bits, win = Bits(data, off), bytearray()
+    match = [0, 0]  # distance, bytes left
+    prev_t, prev = 0, {tag: [0] * len(t.chans) for tag, t in types.items()}
+
+    def byte():
+        if match[1] == 0:
+            flag, v = bits.get(1), bits.get(8)
+            if v is None:
+                raise Truncated
+            if flag:
+                win.append(v)
+                return v
+            n = bits.get(4)
+            if n is None:
+                raise Truncated
+            match[:] = [v + 1, n + 3]
+        # byte by byte, so a match may overlap what it produces
+        win.append(win[-match[0]])
+        match[1] -= 1
+        return win[-1]
+
+    def varint():
+        v = 0
+        for i in range(5):
+            b = byte()
+            v |= (b & 0x7F) << (7 * i)
+            if not b & 0x80:
+                return (v >> 1) ^ -(v & 1)
+        raise ValueError("bad varint")
+
+    while bits.pos < len(data):
+        start = bits.pos
+        try:
+            t = types.get(byte())
+            if t is None:
+                raise ValueError(f"unknown record tag at offset {start}")
+            prev_t = (prev_t + varint()) & 0xFFFFFFFF
+            p = prev[t.tag]
+            for i, (_, _, width, _) in enumerate(t.chans):
+                v = (p[i] + varint()) & ((1 << (8 * width)) - 1)
+                p[i] = v - (1 << (8 * width)) if v >> (8 * width - 1) else v
+        except Truncated:
+            print(f"dropped a truncated record at offset {start}", file=sys.stderr)
+            return
+        if match[1]:
+            raise ValueError(f"match crosses a record at offset {start}")
+        bits.align()
+        del win[:-256]
+        yield start, t, t.unpack(p, prev_t)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("log", help="binary log file")
+    ap.add_argument("-t", "--type", help="only records of this type (no type column)")
+    ap.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    args = ap.parse_args()
+
+    with open(args.log, "rb") as f:
+        data = f.read()
+    try:
+        types, off, packed = parse_header(data)
+    except (ValueError, struct.error) as e:
+        sys.exit(f"{args.log}: {e}")
+
+    only = None
+    if args.type is not None:
+        only = next((t for t in types.values() if t.name == args.type), None)
+        if only is None:
+            sys.exit(f"{args.log}: no record type '{args.type}' "
+                     f"(have: {', '.join(t.name for t in types.values())})")
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    if only:
+        out.write(",".join(["t_ms"] + only.columns()) + "\n")
+    else:
+        for t in types.values():
+            out.write(",".join([t.name, "t_ms"] + t.columns()) + "\n")
+
+    count = 0
+    try:
+        for _, t, rec in (unpack if packed else records)(data, off, types):
+            if only and t is not only:
+                continue
+            _, t_ms = PREFIX.unpack_from(rec)
+            row = [str(t_ms)] + t.decode(rec)
+            out.write(",".join(row if only else [t.name] + row) + "\n")
+            count += 1
+    except ValueError as e:
+        sys.exit(f"{args.log}: {e}")
+
+    if out is not sys.stdout:
+        out.close()
+    print(f"{count} records", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
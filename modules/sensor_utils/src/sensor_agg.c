@@ -0,0 +1,73 @@
+
+/**
+ * @file
+ * @brief Integer Welford aggregation (see sensor_agg.h).
+ */
+
+#include "sensor_agg.h"
+
+#include <limits.h>
+
+void sensor_agg_reset(struct sensor_agg *a)
+{
+	a->n = 0;
+	a->min = INT32_MAX;
+	a->max = INT32_MIN;
+	a->mean_q = 0;
+	a->m2 = 0;
+}
+
+void sensor_agg_add(struct sensor_agg *a, int32_t x)
+{
+	int64_t x_q = (int64_t)x * (1LL << SENSOR_AGG_FRAC);
+
+	a->n++;
+	a->min = (x < a->min) ? x : a->min;
+	a->max = (x > a->max) ? x : a->max;
+
+	int64_t delta = x_q - a->mean_q;
+
+	a->mean_q += delta / (int64_t)a->n;
+
+	int64_t delta2 = x_q - a->mean_q;
+
+	/*
+	 * delta and delta2 have the same sign. Bring both back to whole
+	 * micro-units (sub-µ deviations are below sensor resolution anyway)
+	 * and multiply the magnitudes unsigned: each is below 2^32 for int32
+	 * samples, so the product fits 64 bits even for full-range steps.
+	 */
+	int64_t d1 = delta / (1 << SENSOR_AGG_FRAC);
+	int64_t d2 = delta2 / (1 << SENSOR_AGG_FRAC);
+	uint64_t inc = (uint64_t)(d1 < 0 ? -d1 : d1) * (uint64_t)(d2 < 0 ? -d2 : d2);
+
+	a->m2 = (a->m2 > UINT64_MAX - inc) ? UINT64_MAX : a->m2 + inc;
+}
+
+/** @brief floor(sqrt(v)) for 64-bit @p v, bit by bit. */
+static uint32_t isqrt64(uint64_t v)
+{
+	uint64_t res = 0;
+	uint64_t bit = 1ULL << 62;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= res + bit) {
+			v -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)res;
+}
+
+int32_t sensor_agg_stddev(const struct sensor_agg *a)
+{
+	uint32_t sd = isqrt64(sensor_agg_variance(a));
+
+	return (sd > INT32_MAX) ? INT32_MAX : (int32_t)sd;
+}
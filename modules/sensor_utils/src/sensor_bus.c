@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief zbus acquisition service (see sensor_bus.h).
+ */
+
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
+#include "sensor_period.h"
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sensor_bus, LOG_LEVEL_INF);
+
+/** @brief Device of devicetree alias @p a, or NULL when the board has none. */
+#define BUS_DEV(a)	COND_CODE_1(DT_HAS_ALIAS(a), (DEVICE_DT_GET(DT_ALIAS(a))), (NULL))
+
+static const struct device *const dev_ht =
+	COND_CODE_1(DT_HAS_ALIAS(ht_sensor), (BUS_DEV(ht_sensor)), (BUS_DEV(ambient_temp0)));
+static const struct device *const dev_press = BUS_DEV(pressure_sensor);
+static const struct device *const dev_imu = BUS_DEV(imu_sensor);
+
+ZBUS_CHAN_DEFINE(sensor_bus_chan, struct sensor_bus_sample, NULL, NULL,
+		 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+static struct sensor_period	tick;		/**< Acquisition schedule. */
+static uint32_t			present;	/**< SENSOR_BUS_* of ready sources. */
+static atomic_t			started;	/**< sensor_bus_start() called. */
+static atomic_t			n_pub, n_lost, n_drop;	/**< Counters for the stats. */
+
+static K_SEM_DEFINE(bus_go, 0, 1);	/**< sensor_bus_start() → acquisition thread. */
+
+#define PUB_TIMEOUT	K_MSEC(CONFIG_SENSOR_UTILS_BUS_PUB_TIMEOUT_MS)
+
+/** @brief Read one channel into @p out; true on success. */
+static bool get_chan(const struct device *dev, enum sensor_channel ch, int32_t *out)
+{
+	struct sensor_value v;
+
+	if (sensor_channel_get(dev, ch, &v) != 0) {
+		return false;
+	}
+	*out = sensor_fixp_from_value(&v);
+	return true;
+}
+
+/**
+ * @brief Fetch every present source once.
+ *
+ * Each device is fetched exactly once per period, whatever the number of
+ * consumers; a failing source only clears its bits in @c valid.
+ */
+static void acquire(struct sensor_bus_sample *s)
+{
+	s->t_ms = k_uptime_get();
+	s->valid = 0;
+
+	if ((present & (SENSOR_BUS_TEMP | SENSOR_BUS_HUM)) && sensor_sample_fetch(dev_ht) == 0) {
+		if (get_chan(dev_ht, SENSOR_CHAN_AMBIENT_TEMP, &s->temp)) {
+			s->valid |= SENSOR_BUS_TEMP;
+		}
+		if (get_chan(dev_ht, SENSOR_CHAN_HUMIDITY, &s->hum)) {
+			s->valid |= SENSOR_BUS_HUM;
+		}
+	}
+
+	/* the LPS22HB driver reports kPa */
+	if ((present & SENSOR_BUS_PRESS) && sensor_sample_fetch(dev_press) == 0 &&
+	    get_chan(dev_press, SENSOR_CHAN_PRESS, &s->press)) {
+		s->press *= 10;
+		s->valid |= SENSOR_BUS_PRESS;
+	}
+
+	if ((present & SENSOR_BUS_ACCEL) && sensor_sample_fetch(dev_imu) == 0 &&
+	    get_chan(dev_imu, SENSOR_CHAN_ACCEL_X, &s->accel[0]) &&
+	    get_chan(dev_imu, SENSOR_CHAN_ACCEL_Y, &s->accel[1]) &&
+	    get_chan(dev_imu, SENSOR_CHAN_ACCEL_Z, &s->accel[2])) {
+		s->valid |= SENSOR_BUS_ACCEL;
+	}
+}
+
+/**
+ * @brief Acquisition thread: fetch, publish, sleep until the next deadline.
+ *
+ * @param a Unused.
+ * @param b Unused.
+ * @param c Unused.
+ */
+static void bus_thread(void *a, void *b, void *c)
+{
+	struct sensor_bus_sample s = {0};
+
+	k_sem_take(&bus_go, K_FOREVER);
+	sensor_period_start(&tick);
+
+	while (sensor_period_wait(&tick) > 0) {
+		acquire(&s);
+		s.seq++;
+
+		/*
+		 * Store, then notify, each with a bounded wait: readers hold the
+		 * channel lock in zbus_chan_read() for a copy, so a K_NO_WAIT
+		 * publish would fail for every observer whenever one reads. A
+		 * sample that cannot be stored is lost for all of them; a failed
+		 * notification (lock, full subscriber queue, empty buffer pool)
+		 * means at least one observer missed it.
+		 */
+		if (zbus_chan_claim(&sensor_bus_chan, PUB_TIMEOUT) != 0) {
+			atomic_inc(&n_lost);
+			continue;
+		}
+		*(struct sensor_bus_sample *)zbus_chan_msg(&sensor_bus_chan) = s;
+		(void)zbus_chan_finish(&sensor_bus_chan);
+		atomic_inc(&n_pub);
+
+		if (zbus_chan_notify(&sensor_bus_chan, PUB_TIMEOUT) != 0) {
+			atomic_inc(&n_drop);
+		}
+	}
+}
+
+K_THREAD_DEFINE(sensor_bus_tid, CONFIG_SENSOR_UTILS_BUS_STACK_SIZE, bus_thread,
+		NULL, NULL, NULL, CONFIG_SENSOR_UTILS_BUS_PRIORITY, 0, 0);
+
+/** @brief SENSOR_BUS_* bits of @p dev if it exists and is ready. */
+static uint32_t probe(const struct device *dev, uint32_t bits)
+{
+	if (dev == NULL) {
+		return 0;
+	}
+	if (!device_is_ready(dev)) {
+		LOG_ERR("%s not ready", dev->name);
+		return 0;
+	}
+	return bits;
+}
+
+int sensor_bus_start(uint32_t period_ms)
+{
+	if (!atomic_cas(&started, 0, 1)) {
+		return -EALREADY;
+	}
+	sensor_period_init(&tick, period_ms);
+
+	present = probe(dev_ht, SENSOR_BUS_TEMP | SENSOR_BUS_HUM) |
+		  probe(dev_press, SENSOR_BUS_PRESS) |
+		  probe(dev_imu, SENSOR_BUS_ACCEL);
+	if (present == 0) {
+		atomic_clear(&started);
+		return -ENODEV;
+	}
+
+	k_sem_give(&bus_go);
+	return 0;
+}
+
+uint32_t sensor_bus_present(void)
+{
+	return present;
+}
+
+void sensor_bus_set_period_ms(uint32_t ms)
+{
+	if (!atomic_get(&started)) {
+		return;		/* timer not initialised yet */
+	}
+	sensor_period_set(&tick, ms);
+}
+
+uint32_t sensor_bus_get_period_ms(void)
+{
+	return sensor_period_get(&tick);
+}
+
+void sensor_bus_get_stats(struct sensor_bus_stats *st)
+{
+	st->published = (uint32_t)atomic_get(&n_pub);
+	st->lost = (uint32_t)atomic_get(&n_lost);
+	st->dropped = (uint32_t)atomic_get(&n_drop);
+	st->overruns = sensor_period_overruns(&tick);
+}
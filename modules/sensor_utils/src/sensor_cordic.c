@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Integer CORDIC kernels (see sensor_cordic.h).
+ */
+
+#include "sensor_cordic.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ITERS		21		/**< atan(2^-21) rounds to 0 µrad. */
+#define PRESHIFT	8		/**< Headroom bits for atan2 inputs. */
+#define HALF_PI		1570796		/**< pi / 2 in µrad. */
+#define GAIN_INV_Q30	652032874	/**< 1 / prod(sqrt(1 + 2^-2i)), Q30. */
+
+/** @brief atan(2^-i) in µrad. */
+static const int32_t atan_tbl[ITERS] = {
+	785398, 463648, 244979, 124355, 62419, 31240, 15624, 7812, 3906, 1953,
+	977, 488, 244, 122, 61, 31, 15, 8, 4, 2, 1,
+};
+
+int32_t sensor_cordic_atan2(int32_t y, int32_t x, uint32_t *mag)
+{
+	int64_t vx = (int64_t)x * (1 << PRESHIFT);
+	int64_t vy = (int64_t)y * (1 << PRESHIFT);
+	int32_t z = 0;
+
+	/* vectoring mode converges for x > 0 only: fold the left half-plane */
+	if (vx < 0) {
+		z = (vy >= 0) ? SENSOR_CORDIC_PI : -SENSOR_CORDIC_PI;
+		vx = -vx;
+		vy = -vy;
+	}
+
+	for (int i = 0; i < ITERS; i++) {
+		int64_t nx;
+
+		if (vy > 0) {
+			nx = vx + (vy >> i);
+			vy -= vx >> i;
+			z += atan_tbl[i];
+		} else {
+			nx = vx - (vy >> i);
+			vy += vx >> i;
+			z -= atan_tbl[i];
+		}
+		vx = nx;
+	}
+
+	if (mag != NULL) {
+		/* vx < 2^41 here: drop the headroom before the Q30 gain, or it overflows */
+		*mag = (uint32_t)(((vx >> PRESHIFT) * GAIN_INV_Q30) >> 30);
+	}
+	return sensor_cordic_wrap(z);
+}
+
+void sensor_cordic_sincos(int32_t angle, int32_t *s, int32_t *c)
+{
+	int64_t vx = GAIN_INV_Q30;
+	int64_t vy = 0;
+	int32_t z = angle;
+	bool flip = false;
+
+	/* rotation mode converges within +-pi/2: use sin/cos(a -+ pi) = -sin/cos(a) */
+	if (z > HALF_PI) {
+		z -= SENSOR_CORDIC_PI;
+		flip = true;
+	} else if (z < -HALF_PI) {
+		z += SENSOR_CORDIC_PI;
+		flip = true;
+	}
+
+	for (int i = 0; i < ITERS; i++) {
+		int64_t nx;
+
+		if (z >= 0) {
+			nx = vx - (vy >> i);
+			vy += vx >> i;
+			z -= atan_tbl[i];
+		} else {
+			nx = vx + (vy >> i);
+			vy -= vx >> i;
+			z += atan_tbl[i];
+		}
+		vx = nx;
+	}
+
+	*c = (int32_t)(flip ? -vx : vx);
+	*s = (int32_t)(flip ? -vy : vy);
+}
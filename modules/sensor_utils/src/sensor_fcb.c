@@ -0,0 +1,289 @@
+/**
+ * @file
+ * @brief Buffered append-only log on a flash circular buffer (see sensor_fcb.h).
+ */
+
+#include "sensor_fcb.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define FCB_LAYOUT_VERSION	1	/**< @c f_version of every sensor_fcb. */
+#define SECTOR_HDR		8	/**< FCB sector header bytes, before alignment. */
+
+/**
+ * @brief Write the buffer as one entry, erasing the oldest sector when the
+ *        partition is full; lock held.
+ *
+ * A failed write drops the buffer: the entry space is already taken, and
+ * retrying on a broken sector would only fail again.
+ */
+static int entry_write(struct sensor_fcb *f)
+{
+	struct fcb_entry loc;
+	size_t len;
+	int rc;
+
+	(void)k_work_cancel_delayable(f->timer);
+	if (f->fill == 0) return 0;
+
+	rc = fcb_append(&f->fcb, f->fill, &loc);
+	if (rc == -ENOSPC) {
+		rc = fcb_rotate(&f->fcb);
+		if (rc == 0) {
+			f->stats.rotations++;
+			rc = fcb_append(&f->fcb, f->fill, &loc);
+		}
+	}
+	if (rc == 0) {
+		/* whole write blocks, the tail padded with the erased value */
+		len = ROUND_UP(f->fill, f->align);
+		memset(f->buf + f->fill, f->fcb.f_erase_value, len - f->fill);
+		rc = flash_area_write(f->fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), f->buf, len);
+	}
+	if (rc == 0) {
+		rc = fcb_append_finish(&f->fcb, &loc);
+	}
+
+	if (rc < 0) {
+		f->stats.errors++;
+		f->stats.dropped += f->fill;
+	} else {
+		f->stats.entries++;
+	}
+	f->fill = 0;
+	return rc;
+}
+
+/** @brief Fill in @c f->fcb and run fcb_init(); lock held. */
+static int attach(struct sensor_fcb *f, uint32_t magic, uint32_t cnt)
+{
+	memset(&f->fcb, 0, sizeof(f->fcb));
+	f->fcb.f_magic = magic;
+	f->fcb.f_version = FCB_LAYOUT_VERSION;
+	f->fcb.f_sector_cnt = (uint8_t)cnt;
+	f->fcb.f_sectors = f->sectors;
+	return fcb_init(f->area_id, &f->fcb);
+}
+
+int sensor_fcb_init(struct sensor_fcb *f, uint32_t magic)
+{
+	const struct flash_area *fa;
+	uint32_t cnt = f->sector_max;
+	int rc;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	(void)k_work_cancel_delayable(f->timer);
+	f->ready = false;
+	f->fill = 0;
+
+	rc = flash_area_get_sectors(f->area_id, &cnt, f->sectors);
+	if (rc < 0) goto out;
+	if (f->budget > 0) {
+		size_t sum = 0;
+		uint32_t n = 0;
+
+		while (n < cnt && sum + f->sectors[n].fs_size <= f->budget) {
+			sum += f->sectors[n++].fs_size;
+		}
+		cnt = n;
+	}
+	if (cnt < 2 || cnt > UINT8_MAX) {
+		rc = -EINVAL;
+		goto out;
+	}
+
+	rc = flash_area_open(f->area_id, &fa);
+	if (rc < 0) goto out;
+
+	/* a buffer is one entry: whole write blocks, and it must fit a sector */
+	f->align = MAX(flash_area_align(fa), 1U);
+	for (uint32_t i = 0; i < cnt && rc == 0; i++) {
+		if (f->size % f->align != 0 ||
+		    ROUND_UP(SECTOR_HDR, f->align) + 3 * f->align + f->size > f->sectors[i].fs_size) {
+			rc = -EINVAL;
+		}
+	}
+
+	if (rc == 0) {
+		rc = attach(f, magic, cnt);
+	}
+	if (rc == -ENOMSG) {
+		/* another layout or a file system: start from an erased partition */
+		rc = flash_area_erase(fa, 0, fa->fa_size);
+		if (rc == 0) {
+			f->stats.formats++;
+			rc = attach(f, magic, cnt);
+		}
+	}
+	flash_area_close(fa);
+	f->ready = (rc == 0);
+out:
+	if (rc < 0) {
+		f->stats.errors++;
+	}
+	k_mutex_unlock(f->lock);
+	return rc;
+}
+
+void sensor_fcb_set_budget(struct sensor_fcb *f, size_t bytes)
+{
+	k_mutex_lock(f->lock, K_FOREVER);
+	f->budget = bytes;
+	k_mutex_unlock(f->lock);
+}
+
+int sensor_fcb_append(struct sensor_fcb *f, const void *data, size_t len)
+{
+	int rc = 0;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	if (!f->ready) {
+		rc = -ENODEV;
+		goto out;
+	}
+	if (len > f->size) {
+		rc = -EMSGSIZE;
+		goto out;
+	}
+
+	/* records never straddle entries */
+	if (f->fill + len > f->size) {
+		rc = entry_write(f);
+		if (rc < 0) {
+			f->stats.dropped += len;
+			goto out;
+		}
+	}
+
+	if (f->fill == 0 && f->flush_ms) {
+		/* deadline runs from the oldest buffered byte */
+		k_work_schedule(f->timer, K_MSEC(f->flush_ms));
+	}
+	memcpy(f->buf + f->fill, data, len);
+	f->fill += len;
+	f->stats.appends++;
+	f->stats.bytes += len;
+
+	if (f->fill == f->size) {
+		rc = entry_write(f);
+	}
+out:
+	k_mutex_unlock(f->lock);
+	return rc;
+}
+
+int sensor_fcb_flush(struct sensor_fcb *f)
+{
+	int rc = 0;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	if (f->ready) {
+		rc = entry_write(f);
+	}
+	k_mutex_unlock(f->lock);
+	return rc;
+}
+
+int sensor_fcb_close(struct sensor_fcb *f)
+{
+	int rc = 0;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	if (f->ready) {
+		rc = entry_write(f);
+		f->ready = false;
+	}
+	k_mutex_unlock(f->lock);
+	return rc;
+}
+
+int sensor_fcb_clear(struct sensor_fcb *f)
+{
+	int rc = -ENODEV;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	(void)k_work_cancel_delayable(f->timer);
+	f->fill = 0;
+	if (f->ready) {
+		rc = fcb_clear(&f->fcb);
+		if (rc < 0) {
+			f->stats.errors++;
+		}
+	}
+	k_mutex_unlock(f->lock);
+	return rc;
+}
+
+/** @brief fcb_walk() state of sensor_fcb_for_each(). */
+struct fcb_walk_ctx {
+	uint8_t			*buf;
+	size_t			len;
+	sensor_fcb_entry_cb	cb;
+	void			*ctx;
+	int			rc;	/**< Read error that stopped the walk. */
+};
+
+static int walk_entry(struct fcb_entry_ctx *ec, void *arg)
+{
+	struct fcb_walk_ctx *w = arg;
+	size_t n = ec->loc.fe_data_len;
+	int rc;
+
+	if (n > w->len) {
+		w->rc = -EMSGSIZE;
+		return 1;
+	}
+	rc = flash_area_read(ec->fap, FCB_ENTRY_FA_DATA_OFF(ec->loc), w->buf, n);
+	if (rc < 0) {
+		w->rc = rc;
+		return 1;
+	}
+	return w->cb(w->buf, n, w->ctx) ? 1 : 0;
+}
+
+int sensor_fcb_for_each(struct sensor_fcb *f, uint8_t *buf, size_t len,
+			sensor_fcb_entry_cb cb, void *ctx)
+{
+	struct fcb_walk_ctx w = { .buf = buf, .len = len, .cb = cb, .ctx = ctx };
+	int rc;
+
+	if (!f->ready) return -ENODEV;
+
+	/* the FCB's own lock covers finding each entry, not the callback */
+	rc = fcb_walk(&f->fcb, NULL, walk_entry, &w);
+	return (rc < 0) ? rc : w.rc;
+}
+
+int sensor_fcb_sectors(struct sensor_fcb *f, uint32_t *total)
+{
+	int n = 0;
+
+	k_mutex_lock(f->lock, K_FOREVER);
+	if (total) {
+		*total = f->ready ? f->fcb.f_sector_cnt : 0;
+	}
+	if (f->ready && !fcb_is_empty(&f->fcb)) {
+		int cnt = f->fcb.f_sector_cnt;
+		int d = (int)(f->fcb.f_active.fe_sector - f->fcb.f_oldest);
+
+		n = (d + cnt) % cnt + 1;
+	}
+	k_mutex_unlock(f->lock);
+	return n;
+}
+
+void sensor_fcb_timeout(struct sensor_fcb *f)
+{
+	(void)sensor_fcb_flush(f);
+}
+
+void sensor_fcb_get_stats(struct sensor_fcb *f, struct sensor_fcb_stats *out, size_t *fill)
+{
+	k_mutex_lock(f->lock, K_FOREVER);
+	*out = f->stats;
+	if (fill) {
+		*fill = f->fill;
+	}
+	k_mutex_unlock(f->lock);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Fixed-point complementary filter (see sensor_fusion.h).
+ */
+
+#include "sensor_fusion.h"
+#include "sensor_cordic.h"
+
+#include <stdlib.h>
+
+#define COS_MIN_Q30	10737418	/**< |cos(pitch)| floor (0.01) near gimbal lock. */
+
+/** @brief Q30 product. */
+static inline int64_t q30_mul(int64_t a, int64_t b)
+{
+	return (a * b) >> 30;
+}
+
+/** @brief Tilt from the gravity vector; returns |a| in µm/s^2. */
+static uint32_t accel_tilt(const int32_t a[3], int32_t *roll, int32_t *pitch)
+{
+	uint32_t yz, g;
+
+	*roll = sensor_cordic_atan2(a[1], a[2], &yz);
+	/* |(y, z)| passes INT32_MAX only beyond ~219 g: saturate, it is the x input */
+	*pitch = sensor_cordic_atan2(-a[0], (int32_t)(yz > INT32_MAX ? INT32_MAX : yz), &g);
+	return g;
+}
+
+void sensor_fusion_init(struct sensor_fusion *f, uint16_t alpha)
+{
+	f->roll = f->pitch = f->yaw = 0;
+	f->alpha = alpha;
+	f->valid = false;
+	f->gated = 0;
+}
+
+void sensor_fusion_update(struct sensor_fusion *f, const int32_t accel[3],
+			  const int32_t gyro[3], uint32_t dt_us)
+{
+	int32_t ar, ap;
+	uint32_t g = accel_tilt(accel, &ar, &ap);
+
+	if (!f->valid) {
+		f->roll = ar;
+		f->pitch = ap;
+		f->valid = true;
+		return;
+	}
+
+	/* Euler kinematics: body rates -> roll/pitch/yaw rates */
+	int32_t sr, cr, sp, cp;
+
+	sensor_cordic_sincos(f->roll, &sr, &cr);
+	sensor_cordic_sincos(f->pitch, &sp, &cp);
+	if (abs(cp) < COS_MIN_Q30) {
+		cp = (cp < 0) ? -COS_MIN_Q30 : COS_MIN_Q30;
+	}
+
+	int64_t yz = q30_mul(sr, gyro[1]) + q30_mul(cr, gyro[2]);	/* µrad/s */
+	int64_t roll_dot = gyro[0] + yz * sp / cp;
+	int64_t pitch_dot = q30_mul(cr, gyro[1]) - q30_mul(sr, gyro[2]);
+	int64_t yaw_dot = yz * SENSOR_CORDIC_ONE / cp;
+
+	int32_t roll = sensor_cordic_wrap(f->roll + roll_dot * dt_us / 1000000);
+	int32_t pitch = sensor_cordic_wrap(f->pitch + pitch_dot * dt_us / 1000000);
+
+	f->yaw = sensor_cordic_wrap(f->yaw + yaw_dot * dt_us / 1000000);
+
+	if (abs((int32_t)g - SENSOR_FUSION_G) > SENSOR_FUSION_GATE) {
+		f->gated++;
+	} else {
+		int32_t k = 32768 - f->alpha;
+
+		roll += (int32_t)((int64_t)sensor_cordic_wrap((int64_t)ar - roll) * k >> 15);
+		pitch += (int32_t)((int64_t)sensor_cordic_wrap((int64_t)ap - pitch) * k >> 15);
+	}
+	f->roll = sensor_cordic_wrap(roll);
+	f->pitch = sensor_cordic_wrap(pitch);
+}
+
+void sensor_fusion_quat(const struct sensor_fusion *f, int32_t q[4])
+{
+	int32_t sr, cr, sp, cp, sy, cy;
+
+	sensor_cordic_sincos(f->roll / 2, &sr, &cr);
+	sensor_cordic_sincos(f->pitch / 2, &sp, &cp);
+	sensor_cordic_sincos(f->yaw / 2, &sy, &cy);
+
+	q[0] = (int32_t)(q30_mul(q30_mul(cr, cp), cy) + q30_mul(q30_mul(sr, sp), sy));
+	q[1] = (int32_t)(q30_mul(q30_mul(sr, cp), cy) - q30_mul(q30_mul(cr, sp), sy));
+	q[2] = (int32_t)(q30_mul(q30_mul(cr, sp), cy) + q30_mul(q30_mul(sr, cp), sy));
+	q[3] = (int32_t)(q30_mul(q30_mul(cr, cp), sy) - q30_mul(q30_mul(sr, sp), cy));
+}
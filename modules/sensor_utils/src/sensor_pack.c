@@ -0,0 +1,406 @@
+/**
+ * @file
+ * @brief Delta + LZSS packing of sensor_rec.h records (see sensor_pack.h).
+ */
+
+#include "sensor_pack.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/sys/byteorder.h>
+#include <errno.h>
+#include <string.h>
+
+BUILD_ASSERT(SENSOR_PACK_WINDOW == 256, "distances are coded in 8 bits");
+BUILD_ASSERT(SENSOR_PACK_MAX_MATCH - SENSOR_PACK_MIN_MATCH == 15, "lengths are coded in 4 bits");
+
+#define VARINT_MAX	5	/**< Bytes of a 32-bit varint. */
+
+/** @brief Record type with tag @p tag, or NULL. */
+static const struct sensor_rec_type *find_type(const struct sensor_pack *pk, uint8_t tag,
+					       size_t *idx)
+{
+	for (size_t i = 0; i < pk->ntypes; i++) {
+		if (pk->types[i].tag == tag) {
+			*idx = i;
+			return &pk->types[i];
+		}
+	}
+	return NULL;
+}
+
+/** @brief Stored value of @p width bytes at @p p, sign-extended. */
+static int32_t get_val(const uint8_t *p, uint8_t width)
+{
+	switch (width) {
+	case 1: return (int8_t)*p;
+	case 2: return (int16_t)sys_get_le16(p);
+	default: return (int32_t)sys_get_le32(p);
+	}
+}
+
+static void put_val(uint8_t *p, uint8_t width, int32_t v)
+{
+	switch (width) {
+	case 1: *p = (uint8_t)v; break;
+	case 2: sys_put_le16((uint16_t)v, p); break;
+	default: sys_put_le32((uint32_t)v, p); break;
+	}
+}
+
+/** @brief Zig-zag: small differences of either sign → small unsigned values. */
+static inline uint32_t zz_enc(uint32_t d)
+{
+	return (d << 1) ^ (uint32_t)((int32_t)d >> 31);
+}
+
+static inline uint32_t zz_dec(uint32_t u)
+{
+	return (u >> 1) ^ -(u & 1);
+}
+
+/** @brief LEB128 varint of @p v at @p p; bytes written. */
+static size_t put_varint(uint8_t *p, uint32_t v)
+{
+	size_t n = 0;
+
+	while (v >= 0x80) {
+		p[n++] = (uint8_t)v | 0x80;
+		v >>= 7;
+	}
+	p[n++] = (uint8_t)v;
+	return n;
+}
+
+/** @brief MSB-first bit writer over the packed record. */
+struct bit_out {
+	uint8_t		*p;
+	uint32_t	acc;
+	int		n;
+};
+
+static void bits_put(struct bit_out *w, uint32_t v, int nbits)
+{
+	w->acc = (w->acc << nbits) | v;
+	w->n += nbits;
+	while (w->n >= 8) {
+		w->n -= 8;
+		*w->p++ = (uint8_t)(w->acc >> w->n);
+	}
+}
+
+static void bits_flush(struct bit_out *w)
+{
+	if (w->n > 0) {
+		*w->p++ = (uint8_t)(w->acc << (8 - w->n));
+		w->n = 0;
+	}
+}
+
+/**
+ * @brief LZSS-code the @p len delta bytes at @c hist[hist_len] into @c out,
+ *        then slide the window over them.
+ *
+ * Greedy longest match over the whole window; a match may run into the
+ * bytes it copies (runs) but never past the record.
+ */
+static size_t lz_pack(struct sensor_pack *pk, size_t len)
+{
+	uint8_t *h = pk->hist;
+	size_t base = pk->hist_len, total = base + len;
+	struct bit_out w = { .p = pk->out };
+
+	for (size_t cur = base; cur < total;) {
+		size_t max = MIN(total - cur, SENSOR_PACK_MAX_MATCH);
+		size_t best = 0, dist = 0;
+
+		for (size_t d = 1; max >= SENSOR_PACK_MIN_MATCH && d <= MIN(cur, SENSOR_PACK_WINDOW);
+		     d++) {
+			const uint8_t *s = h + cur - d;
+			size_t l = 0;
+
+			while (l < max && s[l] == h[cur + l]) {
+				l++;
+			}
+			if (l > best) {
+				best = l;
+				dist = d;
+				if (l == max) break;
+			}
+		}
+
+		if (best >= SENSOR_PACK_MIN_MATCH) {
+			bits_put(&w, 0, 1);
+			bits_put(&w, dist - 1, 8);
+			bits_put(&w, best - SENSOR_PACK_MIN_MATCH, 4);
+			cur += best;
+		} else {
+			bits_put(&w, 1, 1);
+			bits_put(&w, h[cur], 8);
+			cur++;
+		}
+	}
+	bits_flush(&w);
+
+	size_t keep = MIN(total, SENSOR_PACK_WINDOW);
+
+	memmove(h, h + total - keep, keep);
+	pk->hist_len = keep;
+	return w.p - pk->out;
+}
+
+size_t sensor_pack_header(const struct sensor_pack *pk, uint8_t *out, size_t len)
+{
+	size_t n;
+
+	for (size_t i = 0; i < pk->ntypes; i++) {
+		if (pk->types[i].nchan > SENSOR_PACK_MAX_CHAN) return 0;
+	}
+	n = sensor_rec_header(pk->types, pk->ntypes, out, len);
+	if (n) {
+		sys_put_le32(SENSOR_PACK_MAGIC, out);
+	}
+	return n;
+}
+
+void sensor_pack_restart(struct sensor_pack *pk)
+{
+	memset(pk->prev, 0, pk->ntypes * SENSOR_PACK_MAX_CHAN * sizeof(pk->prev[0]));
+	pk->prev_t = 0;
+	pk->hist_len = 0;
+	pk->stats.restarts++;
+}
+
+int sensor_pack_record(struct sensor_pack *pk, const uint8_t *rec, size_t len,
+		       const uint8_t **out)
+{
+	uint32_t t0 = k_cycle_get_32();
+	const struct sensor_rec_type *t;
+	size_t ti, n = 0;
+	uint8_t *d = pk->hist + pk->hist_len;
+
+	t = find_type(pk, rec[0], &ti);
+	if (t == NULL || len != sensor_rec_size(t)) return -EINVAL;
+
+	/* stage 1: differences to the previous record of the same type */
+	int32_t *prev = pk->prev + ti * SENSOR_PACK_MAX_CHAN;
+	uint32_t t_ms = sys_get_le32(rec + 1);
+	const uint8_t *p = rec + SENSOR_REC_PREFIX;
+
+	d[n++] = rec[0];
+	n += put_varint(d + n, zz_enc(t_ms - pk->prev_t));
+	pk->prev_t = t_ms;
+
+	for (int c = 0; c < t->nchan; c++) {
+		int32_t s = get_val(p, t->chan[c].width);
+
+		n += put_varint(d + n, zz_enc((uint32_t)s - (uint32_t)prev[c]));
+		prev[c] = s;
+		p += t->chan[c].width;
+	}
+
+	/* stage 2: repeats within the window */
+	size_t packed = lz_pack(pk, n);
+	uint32_t dt = k_cycle_get_32() - t0;
+
+	pk->stats.records++;
+	pk->stats.in += len;
+	pk->stats.delta += n;
+	pk->stats.out += packed;
+	pk->stats.cycles += dt;
+	pk->stats.max_cycles = MAX(pk->stats.max_cycles, dt);
+
+	*out = pk->out;
+	return (int)packed;
+}
+
+int sensor_pack_filter(void *ctx, bool restart, const void *in, size_t len, const void **out)
+{
+	struct sensor_pack *pk = ctx;
+
+	if (restart) {
+		sensor_pack_restart(pk);
+	}
+	return sensor_pack_record(pk, in, len, (const uint8_t **)out);
+}
+
+void sensor_pack_get_stats(const struct sensor_pack *pk, struct sensor_pack_stats *out)
+{
+	*out = pk->stats;
+}
+
+/** @brief Unpack state of sensor_pack_dump(): file bits → LZ bytes → values. */
+struct unpack {
+	struct fs_file_t	*f;
+	uint8_t			buf[128];	/**< File bytes. */
+	size_t			len, pos;	/**< Bytes in / taken from @ref buf. */
+	uint32_t		acc;		/**< Bit reader. */
+	int			nbits;		/**< Unread bits in @ref acc. */
+	uint8_t			win[SENSOR_PACK_WINDOW];	/**< Last unpacked bytes. */
+	uint8_t			head;		/**< Next @ref win slot (wraps at 256). */
+	uint8_t			copy_dist;	/**< Distance - 1 of the match being copied. */
+	uint8_t			copy_left;	/**< Match bytes still to copy. */
+};
+
+/** @brief Next file byte; -ENODATA at the end of the file. */
+static int up_byte(struct unpack *u)
+{
+	if (u->pos == u->len) {
+		ssize_t rd = fs_read(u->f, u->buf, sizeof(u->buf));
+
+		if (rd < 0) return (int)rd;
+		if (rd == 0) return -ENODATA;
+		u->len = rd;
+		u->pos = 0;
+	}
+	return u->buf[u->pos++];
+}
+
+static int up_bits(struct unpack *u, int nbits, uint32_t *v)
+{
+	while (u->nbits < nbits) {
+		int b = up_byte(u);
+
+		if (b < 0) return b;
+		u->acc = (u->acc << 8) | (uint32_t)b;
+		u->nbits += 8;
+	}
+	u->nbits -= nbits;
+	*v = (u->acc >> u->nbits) & ((1U << nbits) - 1);
+	return 0;
+}
+
+/** @brief Next delta byte out of the LZSS stream. */
+static int up_lz(struct unpack *u, uint8_t *out)
+{
+	uint32_t flag, v;
+	int rc;
+
+	if (u->copy_left == 0) {
+		rc = up_bits(u, 1, &flag);
+		if (rc == 0) rc = up_bits(u, 8, &v);
+		if (rc < 0) return rc;
+
+		if (flag) {
+			u->win[u->head++] = (uint8_t)v;
+			*out = (uint8_t)v;
+			return 0;
+		}
+		u->copy_dist = (uint8_t)v;
+		rc = up_bits(u, 4, &v);
+		if (rc < 0) return rc;
+		u->copy_left = (uint8_t)(v + SENSOR_PACK_MIN_MATCH);
+	}
+	/* byte by byte, so a match may overlap what it produces */
+	*out = u->win[(uint8_t)(u->head - u->copy_dist - 1)];
+	u->win[u->head++] = *out;
+	u->copy_left--;
+	return 0;
+}
+
+static int up_varint(struct unpack *u, uint32_t *v)
+{
+	uint8_t b;
+
+	*v = 0;
+	for (int i = 0; i < VARINT_MAX; i++) {
+		int rc = up_lz(u, &b);
+
+		if (rc < 0) return rc;
+		*v |= (uint32_t)(b & 0x7f) << (7 * i);
+		if (!(b & 0x80)) return 0;
+	}
+	return -EBADMSG;
+}
+
+/** @brief Unpack the next record into @p rec (fixed layout); its size, or negative errno. */
+static int up_record(struct sensor_pack *pk, struct unpack *u, uint32_t *prev_t, uint8_t *rec,
+		     const struct sensor_rec_type **type)
+{
+	const struct sensor_rec_type *t;
+	uint8_t tag;
+	uint32_t v;
+	size_t ti;
+	int rc;
+
+	rc = up_lz(u, &tag);
+	if (rc < 0) return rc;
+	t = find_type(pk, tag, &ti);
+	if (t == NULL) return -EBADMSG;
+
+	rc = up_varint(u, &v);
+	if (rc < 0) return rc;
+	*prev_t += zz_dec(v);
+	rec[0] = tag;
+	sys_put_le32(*prev_t, rec + 1);
+
+	int32_t *prev = pk->dump_prev + ti * SENSOR_PACK_MAX_CHAN;
+	uint8_t *p = rec + SENSOR_REC_PREFIX;
+
+	for (int c = 0; c < t->nchan; c++) {
+		rc = up_varint(u, &v);
+		if (rc < 0) return rc;
+		prev[c] = (int32_t)((uint32_t)prev[c] + zz_dec(v));
+		put_val(p, t->chan[c].width, prev[c]);
+		p += t->chan[c].width;
+	}
+	/* the packer never lets a match cross a record, and pads it to a byte */
+	if (u->copy_left) return -EBADMSG;
+	u->nbits &= ~7;
+
+	*type = t;
+	return p - rec;
+}
+
+int sensor_pack_dump(struct sensor_pack *pk, const char *path, const uint8_t *hdr,
+		     size_t hdr_len, size_t *max_bytes, sensor_rec_print_t print, void *ctx)
+{
+	struct fs_file_t f;
+	struct unpack u = { .f = &f };
+	uint8_t rec[SENSOR_REC_PREFIX + 4 * SENSOR_PACK_MAX_CHAN];
+	char line[768];
+	uint32_t prev_t = 0;
+	int rc, count = 0;
+
+	fs_file_t_init(&f);
+	rc = fs_open(&f, path, FS_O_READ);
+	if (rc < 0) return rc;
+
+	for (size_t off = 0; off < hdr_len; off += sizeof(u.buf)) {
+		size_t n = MIN(hdr_len - off, sizeof(u.buf));
+		ssize_t rd = fs_read(&f, u.buf, n);
+
+		rc = (rd < 0) ? (int)rd : ((size_t)rd != n) ? -EIO : 0;
+		if (rc == 0 && memcmp(u.buf, hdr + off, n) != 0) rc = -EBADMSG;
+		if (rc < 0) goto out;
+	}
+
+	for (size_t i = 0; i < pk->ntypes; i++) {
+		sensor_rec_csv_header(&pk->types[i], line, sizeof(line));
+		print(ctx, line);
+	}
+
+	/* every segment starts from zero, like the packer */
+	memset(pk->dump_prev, 0, pk->ntypes * SENSOR_PACK_MAX_CHAN * sizeof(pk->dump_prev[0]));
+
+	while (*max_bytes > 0) {
+		const struct sensor_rec_type *t;
+
+		rc = up_record(pk, &u, &prev_t, rec, &t);
+		if (rc < 0) break;
+		if ((size_t)rc > *max_bytes) {
+			*max_bytes = 0;
+			break;
+		}
+
+		sensor_rec_csv(t, rec, line, sizeof(line));
+		print(ctx, line);
+		count++;
+		*max_bytes -= rc;
+	}
+	/* running out of data is the end of file (or a record cut by a reset) */
+	rc = (rc < 0 && rc != -ENODATA) ? rc : count;
+out:
+	fs_close(&f);
+	return rc;
+}
@@ -0,0 +1,100 @@
+
+/**
+ * @file
+ * @brief k_timer backed periodic schedule (see sensor_period.h).
+ */
+
+#include "sensor_period.h"
+
+/** @brief Count @p n elapsed periods. */
+static void account(struct sensor_period *sp, uint32_t n)
+{
+	atomic_add(&sp->expiries, (atomic_val_t)n);
+	if (n > 1) {
+		atomic_add(&sp->overruns, (atomic_val_t)(n - 1));
+	}
+}
+
+void sensor_period_init(struct sensor_period *sp, uint32_t period_ms)
+{
+	sensor_period_init_notify(sp, period_ms, NULL);
+}
+
+void sensor_period_init_notify(struct sensor_period *sp, uint32_t period_ms,
+			       k_timer_expiry_t expiry)
+{
+	k_timer_init(&sp->timer, expiry, NULL);
+	atomic_set(&sp->period_ms, MAX(period_ms, 1U));
+	atomic_clear(&sp->rerate);
+	atomic_clear(&sp->running);
+	sp->notify = (expiry != NULL);
+	sensor_period_reset_stats(sp);
+}
+
+void sensor_period_start(struct sensor_period *sp)
+{
+	k_timeout_t p = K_MSEC(sensor_period_get(sp));
+
+	atomic_clear(&sp->rerate);
+	atomic_set(&sp->running, 1);
+	k_timer_start(&sp->timer, p, p);
+}
+
+void sensor_period_stop(struct sensor_period *sp)
+{
+	atomic_clear(&sp->running);
+	k_timer_stop(&sp->timer);
+}
+
+void sensor_period_set(struct sensor_period *sp, uint32_t period_ms)
+{
+	atomic_set(&sp->period_ms, MAX(period_ms, 1U));
+
+	if (sp->notify) {
+		/* no blocked waiter to hand the re-arm to: restart from here */
+		if (atomic_get(&sp->running)) {
+			k_timeout_t p = K_MSEC(sensor_period_get(sp));
+
+			k_timer_start(&sp->timer, p, p);
+		}
+		return;
+	}
+
+	atomic_set(&sp->rerate, 1);
+
+	/* releases a blocked waiter with status 0; it re-arms the timer itself */
+	if (atomic_get(&sp->running)) {
+		k_timer_stop(&sp->timer);
+	}
+}
+
+uint32_t sensor_period_wait(struct sensor_period *sp)
+{
+	for (;;) {
+		uint32_t n = k_timer_status_sync(&sp->timer);
+
+		if (!atomic_get(&sp->running)) return 0;
+
+		if (atomic_cas(&sp->rerate, 1, 0) || n == 0) {
+			/*
+			 * New period, or the timer was stopped by a re-rate that
+			 * raced with a previous re-arm: restart from now.
+			 */
+			k_timeout_t p = K_MSEC(sensor_period_get(sp));
+
+			k_timer_start(&sp->timer, p, p);
+			if (n == 0) continue;
+		}
+
+		account(sp, n);
+		return n;
+	}
+}
+
+uint32_t sensor_period_poll(struct sensor_period *sp)
+{
+	uint32_t n = k_timer_status_get(&sp->timer);
+
+	account(sp, n);
+	return n;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file
+ * @brief Binary record log format (see sensor_rec.h).
+ */
+
+#include "sensor_rec.h"
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <string.h>
+
+#define CMP_CHUNK	64	/**< Header bytes compared per read. */
+
+BUILD_ASSERT(CMP_CHUNK <= 128, "header chunks are read into the record buffer");
+
+size_t sensor_rec_size(const struct sensor_rec_type *t)
+{
+	size_t n = SENSOR_REC_PREFIX;
+
+	for (int i = 0; i < t->nchan; i++) {
+		n += t->chan[i].width;
+	}
+	return n;
+}
+
+/** @brief Copy @p s into a NUL-padded field of @p len bytes. */
+static void put_name(uint8_t *out, const char *s, size_t len)
+{
+	memset(out, 0, len);
+	memcpy(out, s, MIN(strlen(s), len));
+}
+
+size_t sensor_rec_header(const struct sensor_rec_type *types, size_t ntypes,
+			 uint8_t *out, size_t len)
+{
+	size_t n = SENSOR_REC_HDR_LEN;
+
+	for (size_t i = 0; i < ntypes; i++) {
+		n += SENSOR_REC_TYPE_LEN + types[i].nchan * SENSOR_REC_CHAN_LEN;
+	}
+	if (n > len || n > UINT16_MAX) return 0;
+
+	sys_put_le32(SENSOR_REC_MAGIC, out);
+	out[4] = SENSOR_REC_VERSION;
+	out[5] = (uint8_t)ntypes;
+	sys_put_le16((uint16_t)n, out + 6);
+	out += SENSOR_REC_HDR_LEN;
+
+	for (size_t i = 0; i < ntypes; i++) {
+		const struct sensor_rec_type *t = &types[i];
+
+		out[0] = t->tag;
+		out[1] = t->nchan;
+		sys_put_le16((uint16_t)sensor_rec_size(t), out + 2);
+		put_name(out + 4, t->name, SENSOR_REC_NAME_LEN);
+		out += SENSOR_REC_TYPE_LEN;
+
+		for (int c = 0; c < t->nchan; c++) {
+			put_name(out, t->chan[c].name, SENSOR_REC_NAME_LEN);
+			put_name(out + 8, t->chan[c].unit, SENSOR_REC_UNIT_LEN);
+			out[14] = t->chan[c].width;
+			out[15] = (uint8_t)t->chan[c].exp;
+			out += SENSOR_REC_CHAN_LEN;
+		}
+	}
+	return n;
+}
+
+/** @brief 10^@p n in 64 bits; sensor_fixp_pow10() stops at 10^6. */
+static int64_t pow10_64(unsigned int n)
+{
+	int64_t p = 1;
+
+	while (n--) {
+		p *= 10;
+	}
+	return p;
+}
+
+/** @brief Input value → stored LSBs of @p c, rounded half away from zero. */
+static int64_t to_lsb(const struct sensor_rec_chan *c, int32_t v)
+{
+	int shift = c->exp - c->src_exp;
+
+	if (shift <= 0) {
+		/* 10^10 already saturates any non-zero value */
+		return (int64_t)v * pow10_64(MIN(-shift, 10));
+	}
+
+	int64_t d = pow10_64(MIN(shift, 18));
+
+	return (v < 0) ? -((-(int64_t)v + d / 2) / d) : ((v + d / 2) / d);
+}
+
+size_t sensor_rec_encode(const struct sensor_rec_type *t, uint32_t t_ms, const int32_t *v,
+			 uint8_t *out)
+{
+	uint8_t *p = out;
+
+	*p++ = t->tag;
+	sys_put_le32(t_ms, p);
+	p += 4;
+
+	for (int i = 0; i < t->nchan; i++) {
+		const struct sensor_rec_chan *c = &t->chan[i];
+		int64_t lo = -(1LL << (8 * c->width - 1));
+		int64_t hi = -lo - 1;
+		/* missing → lo; real values saturate to lo + 1 so they stay distinct */
+		int64_t s = (v[i] == SENSOR_REC_NONE) ? lo : CLAMP(to_lsb(c, v[i]), lo + 1, hi);
+
+		switch (c->width) {
+		case 1: *p = (uint8_t)s; break;
+		case 2: sys_put_le16((uint16_t)s, p); break;
+		default: sys_put_le32((uint32_t)s, p); break;
+		}
+		p += c->width;
+	}
+	return p - out;
+}
+
+int sensor_rec_csv_header(const struct sensor_rec_type *t, char *out, size_t len)
+{
+	int n = snprintk(out, len, "%s,t_ms", t->name);
+
+	for (int i = 0; i < t->nchan && n < (int)len; i++) {
+		const struct sensor_rec_chan *c = &t->chan[i];
+
+		n += snprintk(out + n, len - n, (c->unit[0] ? ",%s[%s]" : ",%s"), c->name, c->unit);
+	}
+	return n;
+}
+
+int sensor_rec_csv(const struct sensor_rec_type *t, const uint8_t *rec, char *out, size_t len)
+{
+	const uint8_t *p = rec + SENSOR_REC_PREFIX;
+	int n = snprintk(out, len, "%s,%u", t->name, sys_get_le32(rec + 1));
+
+	for (int i = 0; i < t->nchan && n < (int)len; i++) {
+		const struct sensor_rec_chan *c = &t->chan[i];
+		int32_t s, lo = (int32_t)(-(1LL << (8 * c->width - 1)));
+
+		switch (c->width) {
+		case 1: s = (int8_t)*p; break;
+		case 2: s = (int16_t)sys_get_le16(p); break;
+		default: s = (int32_t)sys_get_le32(p); break;
+		}
+		p += c->width;
+
+		if (s == lo) {
+			n += snprintk(out + n, len - n, ",");
+		} else if (c->exp >= 0) {
+			n += snprintk(out + n, len - n, ",%lld",
+				      (long long)(s * pow10_64(c->exp)));
+		} else {
+			unsigned int dec = -c->exp;
+			uint32_t d = (uint32_t)pow10_64(dec);
+			uint32_t a = (s < 0) ? -(uint32_t)s : (uint32_t)s;
+
+			n += snprintk(out + n, len - n, ",%s%u.%0*u", (s < 0) ? "-" : "",
+				      a / d, dec, a % d);
+		}
+	}
+	return n;
+}
+
+/** @brief Read exactly @p len bytes; -EIO on a short read. */
+static int read_full(struct fs_file_t *f, void *buf, size_t len)
+{
+	ssize_t rd = fs_read(f, buf, len);
+
+	if (rd < 0) return (int)rd;
+	return ((size_t)rd == len) ? 0 : -EIO;
+}
+
+int sensor_rec_dump(const char *path, const uint8_t *hdr, size_t hdr_len,
+		    const struct sensor_rec_type *types, size_t ntypes, size_t *max_bytes,
+		    sensor_rec_print_t print, void *ctx)
+{
+	struct fs_file_t f;
+	uint8_t buf[128];
+	char line[768];
+	int rc, count = 0;
+
+	fs_file_t_init(&f);
+	rc = fs_open(&f, path, FS_O_READ);
+	if (rc < 0) return rc;
+
+	for (size_t off = 0; off < hdr_len; off += CMP_CHUNK) {
+		size_t n = MIN(hdr_len - off, CMP_CHUNK);
+
+		rc = read_full(&f, buf, n);
+		if (rc == 0 && memcmp(buf, hdr + off, n) != 0) rc = -EBADMSG;
+		if (rc < 0) goto out;
+	}
+
+	for (size_t i = 0; i < ntypes; i++) {
+		sensor_rec_csv_header(&types[i], line, sizeof(line));
+		print(ctx, line);
+	}
+
+	while (*max_bytes > 0) {
+		const struct sensor_rec_type *t = NULL;
+		size_t size;
+
+		rc = read_full(&f, buf, 1);
+		if (rc < 0) break;
+
+		for (size_t i = 0; i < ntypes; i++) {
+			if (types[i].tag == buf[0]) t = &types[i];
+		}
+		if (t == NULL) {
+			rc = -EBADMSG;
+			break;
+		}
+		size = sensor_rec_size(t);
+		if (size > sizeof(buf) || size > *max_bytes) {
+			*max_bytes = 0;
+			break;
+		}
+
+		rc = read_full(&f, buf + 1, size - 1);
+		if (rc < 0) break;
+
+		sensor_rec_csv(t, buf, line, sizeof(line));
+		print(ctx, line);
+		count++;
+		*max_bytes -= size;
+	}
+	/* a short read is the end of file (or a record cut by a reset) */
+	rc = (rc < 0 && rc != -EIO) ? rc : count;
+out:
+	fs_close(&f);
+	return rc;
+}
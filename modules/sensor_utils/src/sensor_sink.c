@@ -0,0 +1,434 @@
+/**
+ * @file
+ * @brief Buffered append-only log file (see sensor_sink.h).
+ */
+
+#include "sensor_sink.h"
+
+#include <zephyr/sys/printk.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int sink_flush(struct sensor_sink *sk);
+
+/**
+ * @brief Copy @p len bytes into the buffer, writing and committing each
+ *        time it fills; lock held.
+ */
+static int sink_put(struct sensor_sink *sk, const uint8_t *p, size_t len)
+{
+	while (len > 0) {
+		size_t n = MIN(len, sk->size - sk->fill);
+
+		if (sk->fill == 0 && sk->flush_ms) {
+			/* deadline runs from the oldest buffered byte */
+			k_work_schedule(sk->timer, K_MSEC(sk->flush_ms));
+		}
+		memcpy(sk->buf + sk->fill, p, n);
+		sk->fill += n;
+		sk->seg_used += n;
+		p += n;
+		len -= n;
+
+		if (sk->fill == sk->size) {
+			int rc = sink_flush(sk);
+
+			if (rc < 0) {
+				sk->stats.dropped += len;
+				return rc;
+			}
+		}
+	}
+	return 0;
+}
+
+/** @brief File name of segment @p seq (@c path itself for a single file). */
+static void seg_name(const struct sensor_sink *sk, uint32_t seq, char *name)
+{
+	if (sk->seg_size == 0) {
+		snprintk(name, SENSOR_SINK_NAME_MAX, "%s", sk->path);
+	} else {
+		snprintk(name, SENSOR_SINK_NAME_MAX, "%s.%u", sk->path, seq);
+	}
+}
+
+/** @brief Segment number of directory entry @p name, if it is one of @p base. */
+static bool seg_parse(const char *name, const char *base, size_t blen, uint32_t *seq)
+{
+	char *end;
+
+	if (strncmp(name, base, blen) != 0 || name[blen] != '.' || name[blen + 1] == '\0') {
+		return false;
+	}
+	*seq = strtoul(name + blen + 1, &end, 10);
+	return *end == '\0';
+}
+
+/**
+ * @brief Find the segments left by an earlier run; lock held.
+ *
+ * Appending resumes on the newest one; an empty volume starts at 0.
+ */
+static int sink_scan(struct sensor_sink *sk)
+{
+	const char *base = strrchr(sk->path, '/');
+	char dname[SENSOR_SINK_NAME_MAX];
+	struct fs_dir_t dir;
+	struct fs_dirent ent;
+	uint32_t first = UINT32_MAX, last = 0, seq;
+	int rc;
+
+	if (sk->scanned) return 0;
+	if (sk->seg_size == 0 || base == NULL) {
+		sk->scanned = true;
+		return 0;
+	}
+
+	snprintk(dname, sizeof(dname), "%.*s", (int)(base - sk->path), sk->path);
+	base++;
+
+	fs_dir_t_init(&dir);
+	rc = fs_opendir(&dir, dname);
+	if (rc < 0) return rc;
+
+	while ((rc = fs_readdir(&dir, &ent)) == 0 && ent.name[0] != '\0') {
+		if (ent.type == FS_DIR_ENTRY_FILE && seg_parse(ent.name, base, strlen(base), &seq)) {
+			first = MIN(first, seq);
+			last = MAX(last, seq);
+		}
+	}
+	(void)fs_closedir(&dir);
+	if (rc < 0) return rc;
+
+	sk->seg_first = (first == UINT32_MAX) ? 0 : first;
+	sk->seg_last = last;
+	sk->scanned = true;
+	return 0;
+}
+
+/**
+ * @brief Remove segment @p seq; lock held.
+ * @return 0 if removed or already gone, negative errno otherwise.
+ */
+static int seg_remove(struct sensor_sink *sk, uint32_t seq)
+{
+	char name[SENSOR_SINK_NAME_MAX];
+	int rc;
+
+	seg_name(sk, seq, name);
+	rc = fs_unlink(name);
+	return (rc == -ENOENT) ? 0 : rc;
+}
+
+/** @brief Move on to the next segment number, dropping the oldest ones over @c seg_max. */
+static void seg_advance(struct sensor_sink *sk)
+{
+	sk->seg_last++;
+	while (sk->seg_last - sk->seg_first >= sk->seg_max) {
+		if (seg_remove(sk, sk->seg_first) < 0) {
+			sk->stats.errors++;
+		} else {
+			sk->stats.removed++;
+		}
+		sk->seg_first++;
+	}
+}
+
+/** @brief Open the current segment for appending, header first if it is new; lock held. */
+static int sink_open(struct sensor_sink *sk)
+{
+	char name[SENSOR_SINK_NAME_MAX];
+	struct fs_dirent ent;
+	bool fresh;
+	int rc;
+
+	rc = sink_scan(sk);
+	if (rc < 0) {
+		sk->stats.errors++;
+		return rc;
+	}
+	seg_name(sk, sk->seg_last, name);
+	fresh = (fs_stat(name, &ent) != 0 || ent.size == 0);
+	if (!fresh && sk->filter) {
+		/* the filter state that wrote this segment is gone */
+		seg_advance(sk);
+		seg_name(sk, sk->seg_last, name);
+		fresh = true;
+	}
+	sk->seg_used = fresh ? 0 : ent.size;
+	sk->restart = fresh;
+
+	fs_file_t_init(&sk->file);
+	sk->stats.opens++;
+	rc = fs_open(&sk->file, name, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (rc < 0) {
+		sk->stats.errors++;
+		return rc;
+	}
+	sk->open = true;
+	return (fresh && sk->hdr_len) ? sink_put(sk, sk->hdr, sk->hdr_len) : 0;
+}
+
+/** @brief Close the file without flushing; lock held. */
+static int sink_close(struct sensor_sink *sk)
+{
+	if (!sk->open) return 0;
+
+	sk->open = false;
+	sk->dirty = false;
+	return fs_close(&sk->file);
+}
+
+/**
+ * @brief Write the buffer out; lock held.
+ *
+ * A failed or short write drops the buffer and closes the file: retrying
+ * the same bytes would only fail again on a full or broken volume.
+ */
+static int sink_write(struct sensor_sink *sk)
+{
+	ssize_t rc;
+
+	if (sk->fill == 0) return 0;
+
+	sk->stats.writes++;
+	rc = fs_write(&sk->file, sk->buf, sk->fill);
+	if (rc >= 0 && (size_t)rc != sk->fill) {
+		rc = -ENOSPC;
+	}
+	if (rc < 0) {
+		sk->stats.errors++;
+		sk->stats.dropped += sk->fill;
+		sk->fill = 0;
+		(void)sink_close(sk);
+		return (int)rc;
+	}
+	sk->fill = 0;
+	sk->dirty = true;
+	return 0;
+}
+
+/**
+ * @brief Commit and close the full segment, drop the oldest ones over
+ *        @c seg_max, open the next; lock held.
+ */
+static int sink_rotate(struct sensor_sink *sk)
+{
+	(void)sink_flush(sk);	/* a failed write already dropped its bytes */
+	(void)sink_close(sk);
+
+	sk->stats.rotations++;
+	seg_advance(sk);
+	return sink_open(sk);
+}
+
+/** @brief Write the buffer and commit it; lock held. */
+static int sink_flush(struct sensor_sink *sk)
+{
+	int rc;
+
+	(void)k_work_cancel_delayable(sk->timer);
+
+	rc = sink_write(sk);
+	if (rc < 0 || !sk->dirty) return rc;
+
+	sk->stats.syncs++;
+	rc = fs_sync(&sk->file);
+	if (rc < 0) {
+		sk->stats.errors++;
+		return rc;
+	}
+	sk->dirty = false;
+	return 0;
+}
+
+/** @brief Run the filter on @p data, if any; lock held. */
+static int sink_filter(struct sensor_sink *sk, const void *data, size_t len, const void **out)
+{
+	int rc;
+
+	if (sk->filter == NULL) {
+		*out = data;
+		return (int)len;
+	}
+	rc = sk->filter(sk->filter_ctx, sk->restart, data, len, out);
+	if (rc >= 0) {
+		sk->restart = false;
+	}
+	return rc;
+}
+
+int sensor_sink_append(struct sensor_sink *sk, const void *data, size_t len)
+{
+	const void *rec;
+	int rc = 0;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+
+	if (sk->held) {
+		rc = -EAGAIN;
+		goto out;
+	}
+	if (!sk->open) {
+		rc = sink_open(sk);
+		if (rc < 0) goto out;
+	}
+
+	rc = sink_filter(sk, data, len, &rec);
+	if (rc < 0) goto out;
+
+	/* records never straddle segments; one larger than a segment gets its own */
+	if (sk->seg_size && sk->seg_used > sk->hdr_len && sk->seg_used + rc > sk->seg_size) {
+		rc = sink_rotate(sk);
+		if (rc < 0) goto out;
+		/* encode again against the new segment's fresh filter state */
+		rc = sink_filter(sk, data, len, &rec);
+		if (rc < 0) goto out;
+	}
+
+	sk->stats.appends++;
+	sk->stats.bytes += len;
+	sk->stats.stored += rc;
+	rc = sink_put(sk, rec, rc);
+out:
+	k_mutex_unlock(sk->lock);
+	return rc;
+}
+
+int sensor_sink_flush(struct sensor_sink *sk)
+{
+	int rc = 0;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	if (sk->open) {
+		rc = sink_flush(sk);
+	}
+	k_mutex_unlock(sk->lock);
+	return rc;
+}
+
+int sensor_sink_close(struct sensor_sink *sk)
+{
+	int rc = 0;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	if (sk->open) {
+		rc = sink_flush(sk);
+
+		int rc2 = sink_close(sk);
+
+		rc = rc ? rc : rc2;
+	}
+	k_mutex_unlock(sk->lock);
+	return rc;
+}
+
+int sensor_sink_hold(struct sensor_sink *sk, bool hold)
+{
+	int rc = 0;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	if (hold && sk->open) {
+		rc = sink_flush(sk);
+
+		int rc2 = sink_close(sk);
+
+		rc = rc ? rc : rc2;
+	}
+	sk->held = hold;
+	k_mutex_unlock(sk->lock);
+	return rc;
+}
+
+int sensor_sink_clear(struct sensor_sink *sk)
+{
+	int rc = 0;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	if (sk->open) {
+		rc = sink_flush(sk);
+		(void)sink_close(sk);
+	}
+
+	int rc2 = sink_scan(sk);
+
+	for (uint32_t seq = sk->seg_first; rc2 == 0 && seq <= sk->seg_last; seq++) {
+		rc2 = seg_remove(sk, seq);
+	}
+	sk->seg_first = 0;
+	sk->seg_last = 0;
+	k_mutex_unlock(sk->lock);
+	return rc ? rc : rc2;
+}
+
+int sensor_sink_segments(struct sensor_sink *sk, uint32_t *first, uint32_t *last)
+{
+	int rc;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	rc = sink_scan(sk);
+	if (rc == 0) {
+		if (first) {
+			*first = sk->seg_first;
+		}
+		if (last) {
+			*last = sk->seg_last;
+		}
+		rc = (int)(sk->seg_last - sk->seg_first + 1);
+	}
+	k_mutex_unlock(sk->lock);
+	return rc;
+}
+
+int sensor_sink_for_each(struct sensor_sink *sk, sensor_sink_file_cb cb, void *ctx)
+{
+	char name[SENSOR_SINK_NAME_MAX];
+	uint32_t first, last;
+	int rc = sensor_sink_segments(sk, &first, &last);
+
+	if (rc < 0) return rc;
+
+	for (uint32_t seq = first; seq <= last; seq++) {
+		seg_name(sk, seq, name);
+		rc = cb(name, ctx);
+		if (rc > 0) break;
+		if (rc < 0 && rc != -ENOENT) return rc;
+	}
+	return 0;
+}
+
+int sensor_sink_set_filter(struct sensor_sink *sk, sensor_sink_filter_t fn, void *ctx)
+{
+	if (sk->seg_size == 0) return -EINVAL;
+
+	k_mutex_lock(sk->lock, K_FOREVER);
+	sk->filter = fn;
+	sk->filter_ctx = ctx;
+	sk->restart = true;
+	k_mutex_unlock(sk->lock);
+	return 0;
+}
+
+void sensor_sink_set_header(struct sensor_sink *sk, const void *hdr, size_t len)
+{
+	k_mutex_lock(sk->lock, K_FOREVER);
+	sk->hdr = hdr;
+	sk->hdr_len = len;
+	k_mutex_unlock(sk->lock);
+}
+
+void sensor_sink_timeout(struct sensor_sink *sk)
+{
+	(void)sensor_sink_flush(sk);
+}
+
+void sensor_sink_get_stats(struct sensor_sink *sk, struct sensor_sink_stats *out, size_t *fill)
+{
+	k_mutex_lock(sk->lock, K_FOREVER);
+	*out = sk->stats;
+	if (fill) {
+		*fill = sk->fill;
+	}
+	k_mutex_unlock(sk->lock);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Q15 FFT spectrum features (see sensor_spectrum.h).
+ */
+
+#include "sensor_spectrum.h"
+
+#include <errno.h>
+#include <string.h>
+
+int sensor_spectrum_init(struct sensor_spectrum *sp)
+{
+	if (arm_rfft_init_q15(&sp->rfft, sp->n, 0, 1) != ARM_MATH_SUCCESS) {
+		return -EINVAL;
+	}
+
+	/* Hann: w[i] = (1 - cos(2 pi i / n)) / 2; arm_cos_q15 maps [0, 1) to [0, 2 pi) */
+	for (uint32_t i = 0; i < sp->n; i++) {
+		int32_t c = arm_cos_q15((q15_t)((i * 32768U) / sp->n));
+		int32_t w = (32768 - c) / 2;
+
+		sp->win[i] = (q15_t)((w > 32767) ? 32767 : w);
+	}
+
+	sensor_spectrum_clear(sp);
+	return 0;
+}
+
+void sensor_spectrum_clear(struct sensor_spectrum *sp)
+{
+	memset(sp->pow, 0, (sp->n / 2U) * sizeof(sp->pow[0]));
+	sp->axes = 0;
+}
+
+void sensor_spectrum_add(struct sensor_spectrum *sp, const int32_t *x, size_t stride,
+			 int32_t full_scale)
+{
+	uint32_t n = sp->n;
+	int64_t sum = 0;
+
+	for (uint32_t i = 0; i < n; i++) {
+		sum += x[i * stride];
+	}
+
+	int32_t mean = (int32_t)(sum / (int64_t)n);
+
+	for (uint32_t i = 0; i < n; i++) {
+		int64_t v = ((int64_t)x[i * stride] - mean) * 32768 / full_scale;
+
+		sp->in[i] = (q15_t)((v > 32767) ? 32767 : (v < -32768) ? -32768 : v);
+	}
+
+	arm_mult_q15(sp->in, sp->win, sp->in, n);
+	arm_rfft_q15(&sp->rfft, sp->in, sp->out);
+
+	/*
+	 * |X|^2 in 32 bits rather than arm_cmplx_mag_squared_q15(): the RFFT
+	 * output is already scaled down by n, and the 3.13 result of the
+	 * CMSIS helper would round small vibrations to zero.
+	 */
+	for (uint32_t k = 0; k < n / 2U; k++) {
+		int32_t re = sp->out[2 * k];
+		int32_t im = sp->out[2 * k + 1];
+		uint32_t p = ((uint32_t)(re * re) + (uint32_t)(im * im)) >> 2;
+		uint32_t acc = sp->pow[k] + p;
+
+		sp->pow[k] = (acc < p) ? UINT32_MAX : acc;
+	}
+	sp->axes++;
+}
+
+void sensor_spectrum_features(const struct sensor_spectrum *sp, uint32_t fs_mhz,
+			      struct sensor_spectrum_result *res)
+{
+	uint32_t bins = sp->n / 2U;
+	uint64_t band[SENSOR_SPECTRUM_BANDS] = {0};
+	uint32_t peak = 1;
+
+	memset(res, 0, sizeof(*res));
+
+	for (uint32_t k = 1; k < bins; k++) {
+		band[(k * SENSOR_SPECTRUM_BANDS) / bins] += sp->pow[k];
+		res->total += sp->pow[k];
+		if (sp->pow[k] > sp->pow[peak]) peak = k;
+	}
+
+	res->peak_mhz = (uint32_t)(((uint64_t)peak * fs_mhz) / sp->n);
+	res->peak_pow = sp->pow[peak];
+
+	for (int b = 0; b < SENSOR_SPECTRUM_BANDS; b++) {
+		res->band_pm[b] = res->total ? (uint16_t)((band[b] * 1000U) / res->total) : 0;
+	}
+}
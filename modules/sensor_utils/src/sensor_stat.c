@@ -0,0 +1,51 @@
+
+/**
+ * @file
+ * @brief Per-stage latency statistics (see sensor_stat.h).
+ */
+
+#include "sensor_stat.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/** @brief Histogram bucket of a duration: floor(log2(cycles)), 0 for 0/1. */
+static inline unsigned int bucket_of(uint32_t cycles)
+{
+	return 31U - (unsigned int)__builtin_clz(cycles | 1U);
+}
+
+void sensor_stat_record(struct sensor_stat *st, uint32_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&st->lock);
+
+	st->count++;
+	st->sum += cycles;
+	st->min = MIN(st->min, cycles);
+	st->max = MAX(st->max, cycles);
+	st->hist[bucket_of(cycles)]++;
+
+	k_spin_unlock(&st->lock, key);
+}
+
+void sensor_stat_reset(struct sensor_stat *st)
+{
+	k_spinlock_key_t key = k_spin_lock(&st->lock);
+
+	st->count = 0;
+	st->sum = 0;
+	st->min = UINT32_MAX;
+	st->max = 0;
+	memset(st->hist, 0, sizeof(st->hist));
+
+	k_spin_unlock(&st->lock, key);
+}
+
+void sensor_stat_get(struct sensor_stat *st, struct sensor_stat *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&st->lock);
+
+	memcpy(out, st, offsetof(struct sensor_stat, lock));
+
+	k_spin_unlock(&st->lock, key);
+}
@@ -0,0 +1,317 @@
+/**
+ * @file
+ * @brief Round-trip tests of sensor_pack.h: records packed into a segment
+ *        file and printed back by sensor_pack_dump() must give exactly the
+ *        sensor_rec_csv() lines of the records that went in.
+ *
+ * A seeded generator produces the stream twice, once to pack it and once
+ * to check every dumped line, so thousands of records need no RAM copy.
+ * Streams cover missing values, saturated values (the largest deltas a
+ * channel can have) and a mix of record types with a timestamp wrap.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <string.h>
+
+#include "sensor_pack.h"
+
+#define MNT		"/t"
+#define SEG0		MNT "/seg0.bin"
+#define SEG1		MNT "/seg1.bin"
+
+static const struct sensor_rec_chan env_ch[] = {
+	SENSOR_REC_CHAN("temp", "C", 2, -2),
+	SENSOR_REC_CHAN("hum", "%", 1, 0),
+	SENSOR_REC_CHAN("press", "hPa", 4, -3),
+};
+
+static const struct sensor_rec_chan imu_ch[] = {
+	SENSOR_REC_CHAN("ax", "m/s2", 2, -3),
+	SENSOR_REC_CHAN("ay", "m/s2", 2, -3),
+	SENSOR_REC_CHAN("az", "m/s2", 2, -3),
+	SENSOR_REC_CHAN("gx", "dps", 2, -1),
+	SENSOR_REC_CHAN("gy", "dps", 2, -1),
+	SENSOR_REC_CHAN("gz", "dps", 2, -1),
+};
+
+static const struct sensor_rec_chan evt_ch[] = {
+	SENSOR_REC_CHAN_RAW("count", "", 4),
+	SENSOR_REC_CHAN_RAW("flags", "", 1),
+};
+
+static const struct sensor_rec_type types[] = {
+	SENSOR_REC_TYPE(0, "env", env_ch),
+	SENSOR_REC_TYPE(1, "imu", imu_ch),
+	SENSOR_REC_TYPE(2, "evt", evt_ch),
+};
+
+SENSOR_PACK_DEFINE(pack, types);
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(test_lfs);
+
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.mnt_point = MNT,
+	.fs_data = &test_lfs,
+	.storage_dev = (void *)FIXED_PARTITION_ID(test_lfs),
+};
+
+/** @brief Value mix of a generated stream. */
+enum gen_mode {
+	GEN_NONE,	/**< About half of the values missing. */
+	GEN_SAT,	/**< Values beyond the channel range, both signs. */
+	GEN_MIXED,	/**< Random walks and noise, rare gaps and spikes. */
+};
+
+/** @brief Deterministic record stream. */
+struct gen {
+	enum gen_mode	mode;
+	uint32_t	rnd;		/**< xorshift32 state, never 0. */
+	uint32_t	t_ms;
+	int32_t		walk[ARRAY_SIZE(env_ch)];	/**< env values, micro-units. */
+	int32_t		count;		/**< evt counter. */
+};
+
+/** @brief What the print callback of sensor_pack_dump() saw. */
+struct check {
+	struct gen	g;		/**< Regenerates the packed stream. */
+	int		lines;		/**< Lines printed, headers included. */
+	int		bad;		/**< Lines that differed. */
+};
+
+static void gen_init(struct gen *g, enum gen_mode mode, uint32_t seed)
+{
+	memset(g, 0, sizeof(*g));
+	g->mode = mode;
+	g->rnd = seed;
+	/* wraps after a few thousand records */
+	g->t_ms = UINT32_MAX - 20000;
+	g->walk[0] = 21000000;
+	g->walk[1] = 45000000;
+	g->walk[2] = 1013000000;
+}
+
+static uint32_t rnd(struct gen *g)
+{
+	g->rnd ^= g->rnd << 13;
+	g->rnd ^= g->rnd >> 17;
+	g->rnd ^= g->rnd << 5;
+	return g->rnd;
+}
+
+/** @brief @p base plus or minus up to @p span. */
+static int32_t noise(struct gen *g, int32_t base, uint32_t span)
+{
+	return base + (int32_t)(rnd(g) % (2 * span + 1)) - (int32_t)span;
+}
+
+static int32_t gen_value(struct gen *g, size_t ti, int c)
+{
+	static const int32_t extreme[] = { INT32_MAX, -INT32_MAX, 0, SENSOR_REC_NONE };
+
+	switch (g->mode) {
+	case GEN_NONE:
+		if (rnd(g) & 1) return SENSOR_REC_NONE;
+		break;
+	case GEN_SAT:
+		return extreme[rnd(g) % ARRAY_SIZE(extreme)];
+	default:
+		if (rnd(g) % 64 == 0) return SENSOR_REC_NONE;
+		break;
+	}
+
+	switch (ti) {
+	case 0:
+		g->walk[c] = noise(g, g->walk[c], 2000);
+		return g->walk[c];
+	case 1:
+		/* one sample in a hundred saturates the int16 */
+		return noise(g, 0, (rnd(g) % 100 == 0) ? 50000000 : 2000000);
+	default:
+		return (c == 0) ? g->count++ : (int32_t)(rnd(g) & 0xff);
+	}
+}
+
+/** @brief Next record of the stream into @p rec; its type. */
+static const struct sensor_rec_type *gen_next(struct gen *g, uint8_t *rec, size_t *len)
+{
+	uint32_t r = rnd(g) % 16;
+	size_t ti = (r == 0) ? 2 : (r < 6) ? 0 : 1;
+	int32_t v[SENSOR_PACK_MAX_CHAN];
+
+	for (int c = 0; c < types[ti].nchan; c++) {
+		v[c] = gen_value(g, ti, c);
+	}
+	g->t_ms += 1 + rnd(g) % 20;
+	*len = sensor_rec_encode(&types[ti], g->t_ms, v, rec);
+	return &types[ti];
+}
+
+/** @brief Pack @p n records of a stream into a new segment @p path. */
+static void pack_file(const char *path, enum gen_mode mode, uint32_t seed, int n,
+		      size_t *rec_bytes)
+{
+	struct fs_file_t f;
+	struct gen g;
+	uint8_t hdr[256], rec[SENSOR_REC_PREFIX + 4 * SENSOR_PACK_MAX_CHAN];
+	size_t hdr_len = sensor_pack_header(&pack, hdr, sizeof(hdr));
+
+	zassert_true(hdr_len > 0);
+	fs_unlink(path);
+	fs_file_t_init(&f);
+	zassert_ok(fs_open(&f, path, FS_O_CREATE | FS_O_WRITE));
+	zassert_equal(fs_write(&f, hdr, hdr_len), (ssize_t)hdr_len);
+
+	gen_init(&g, mode, seed);
+	sensor_pack_restart(&pack);
+	*rec_bytes = 0;
+	for (int i = 0; i < n; i++) {
+		const uint8_t *out;
+		size_t len;
+		int packed;
+
+		gen_next(&g, rec, &len);
+		packed = sensor_pack_record(&pack, rec, len, &out);
+		zassert_true(packed > 0 && packed <= SENSOR_PACK_OUT_MAX, "record %d: %d", i, packed);
+		zassert_equal(fs_write(&f, out, packed), packed);
+		*rec_bytes += len;
+	}
+	zassert_ok(fs_close(&f));
+}
+
+static void check_line(void *ctx, const char *line)
+{
+	struct check *ck = ctx;
+	uint8_t rec[SENSOR_REC_PREFIX + 4 * SENSOR_PACK_MAX_CHAN];
+	char want[256];
+
+	if (ck->lines < (int)ARRAY_SIZE(types)) {
+		sensor_rec_csv_header(&types[ck->lines], want, sizeof(want));
+	} else {
+		size_t len;
+		const struct sensor_rec_type *t = gen_next(&ck->g, rec, &len);
+
+		sensor_rec_csv(t, rec, want, sizeof(want));
+	}
+	if (strcmp(line, want) != 0 && ck->bad++ == 0) {
+		TC_PRINT("line %d: got \"%s\", want \"%s\"\n", ck->lines, line, want);
+	}
+	ck->lines++;
+}
+
+/** @brief Dump @p path and compare it with the stream; records printed. */
+static int dump_check(const char *path, enum gen_mode mode, uint32_t seed, size_t *max_bytes)
+{
+	struct check ck = { .lines = 0 };
+	uint8_t hdr[256];
+	size_t hdr_len = sensor_pack_header(&pack, hdr, sizeof(hdr));
+	int rc;
+
+	gen_init(&ck.g, mode, seed);
+	rc = sensor_pack_dump(&pack, path, hdr, hdr_len, max_bytes, check_line, &ck);
+	zassert_equal(ck.bad, 0, "%d of %d lines differ", ck.bad, ck.lines);
+	zassert_equal(ck.lines, rc + (int)ARRAY_SIZE(types));
+	return rc;
+}
+
+/**
+ * @brief Pack and dump one segment of @p n records.
+ *
+ * @return packed file bytes; @p rec_bytes is set to the record bytes.
+ */
+static size_t round_trip(enum gen_mode mode, uint32_t seed, int n, size_t *rec_bytes)
+{
+	struct fs_dirent st;
+	size_t max_bytes = SIZE_MAX;
+
+	pack_file(SEG0, mode, seed, n, rec_bytes);
+	zassert_equal(dump_check(SEG0, mode, seed, &max_bytes), n);
+	zassert_equal(SIZE_MAX - max_bytes, *rec_bytes, "unpacked bytes must be counted");
+
+	zassert_ok(fs_stat(SEG0, &st));
+	TC_PRINT("%d records: %zu bytes -> %zu packed\n", n, *rec_bytes, st.size);
+	return st.size;
+}
+
+ZTEST(sensor_pack, test_none)
+{
+	size_t rec_bytes;
+
+	round_trip(GEN_NONE, 0x1234567, 3000, &rec_bytes);
+}
+
+ZTEST(sensor_pack, test_saturation)
+{
+	size_t rec_bytes;
+
+	round_trip(GEN_SAT, 0x2468ace, 3000, &rec_bytes);
+}
+
+ZTEST(sensor_pack, test_mixed)
+{
+	size_t rec_bytes, packed = round_trip(GEN_MIXED, 0xc0ffee, 5000, &rec_bytes);
+
+	/* random walks and noise still leave the delta stage something to do */
+	zassert_true(packed < rec_bytes, "%zu packed bytes for %zu", packed, rec_bytes);
+}
+
+ZTEST(sensor_pack, test_segments)
+{
+	size_t b0, b1, all = SIZE_MAX;
+
+	/* each segment restarts the state and decodes alone */
+	pack_file(SEG0, GEN_MIXED, 11, 3000, &b0);
+	pack_file(SEG1, GEN_MIXED, 22, 2000, &b1);
+	zassert_equal(dump_check(SEG1, GEN_MIXED, 22, &all), 2000);
+	zassert_equal(dump_check(SEG0, GEN_MIXED, 11, &all), 3000);
+	zassert_equal(SIZE_MAX - all, b0 + b1);
+}
+
+ZTEST(sensor_pack, test_max_bytes)
+{
+	struct gen g;
+	uint8_t rec[SENSOR_REC_PREFIX + 4 * SENSOR_PACK_MAX_CHAN];
+	size_t rec_bytes, len, limit = 0;
+
+	pack_file(SEG0, GEN_MIXED, 33, 3000, &rec_bytes);
+
+	/* a limit that ends inside record 1001 prints the first 1000 */
+	gen_init(&g, GEN_MIXED, 33);
+	for (int i = 0; i < 1000; i++) {
+		gen_next(&g, rec, &len);
+		limit += len;
+	}
+	limit += 1;
+	zassert_equal(dump_check(SEG0, GEN_MIXED, 33, &limit), 1000);
+	zassert_equal(limit, 0);
+}
+
+ZTEST(sensor_pack, test_bad_header)
+{
+	uint8_t hdr[256];
+	size_t rec_bytes, max_bytes = SIZE_MAX;
+	size_t hdr_len = sensor_rec_header(types, ARRAY_SIZE(types), hdr, sizeof(hdr));
+
+	/* an unpacked ("SREC") header must not be taken for a packed one */
+	pack_file(SEG0, GEN_MIXED, 44, 10, &rec_bytes);
+	zassert_equal(sensor_pack_dump(&pack, SEG0, hdr, hdr_len, &max_bytes, check_line, NULL),
+		      -EBADMSG);
+}
+
+static void *setup(void)
+{
+	zassert_ok(fs_mount(&mnt));	/* formats the erased partition */
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	fs_unmount(&mnt);
+}
+
+ZTEST_SUITE(sensor_pack, NULL, setup, NULL, NULL, teardown);
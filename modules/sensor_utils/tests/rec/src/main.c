@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @brief Encode/decode tests of sensor_rec.h: header layout, rounding,
+ *        saturation and missing values, and the CSV lines of a record.
+ *
+ * The expected strings are what `scripts/srec2csv.py` prints for the same
+ * records, so the target and host decoders stay in step.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#include "sensor_rec.h"
+
+static const struct sensor_rec_chan env_ch[] = {
+	SENSOR_REC_CHAN("temp", "C", 2, -2),		/* 0.01 C in an int16 */
+	SENSOR_REC_CHAN("pressure", "hPa", 4, -3),	/* 8-char name fills its field */
+	SENSOR_REC_CHAN("hum", "%", 1, 0),
+	SENSOR_REC_CHAN_RAW("flags", "", 1),
+};
+
+static const struct sensor_rec_chan dist_ch[] = {
+	SENSOR_REC_CHAN("dist", "m", 2, 2),		/* 100 m steps */
+};
+
+static const struct sensor_rec_type types[] = {
+	SENSOR_REC_TYPE(0, "env", env_ch),
+	SENSOR_REC_TYPE(7, "dist", dist_ch),
+};
+
+#define ENV_SIZE	(SENSOR_REC_PREFIX + 2 + 4 + 1 + 1)
+#define HDR_SIZE	(SENSOR_REC_HDR_LEN + 2 * SENSOR_REC_TYPE_LEN +			\
+			 (ARRAY_SIZE(env_ch) + ARRAY_SIZE(dist_ch)) * SENSOR_REC_CHAN_LEN)
+
+/** @brief Encode one env record and format it as CSV into @p line. */
+static void env_csv(uint32_t t_ms, int32_t temp, int32_t press, int32_t hum, int32_t flags,
+		    char *line, size_t len)
+{
+	int32_t v[] = { temp, press, hum, flags };
+	uint8_t rec[ENV_SIZE];
+
+	zassert_equal(sensor_rec_encode(&types[0], t_ms, v, rec), ENV_SIZE);
+	zassert_equal(rec[0], 0);
+	zassert_equal(sys_get_le32(rec + 1), t_ms);
+	sensor_rec_csv(&types[0], rec, line, len);
+}
+
+ZTEST(sensor_rec, test_header)
+{
+	uint8_t hdr[HDR_SIZE];
+	const uint8_t *t = hdr + SENSOR_REC_HDR_LEN;
+	const uint8_t *c = t + SENSOR_REC_TYPE_LEN;
+
+	zassert_equal(sensor_rec_header(types, ARRAY_SIZE(types), hdr, sizeof(hdr) - 1), 0,
+		      "a short buffer must be refused");
+	zassert_equal(sensor_rec_header(types, ARRAY_SIZE(types), hdr, sizeof(hdr)), HDR_SIZE);
+
+	zassert_mem_equal(hdr, "SREC", 4);
+	zassert_equal(hdr[4], SENSOR_REC_VERSION);
+	zassert_equal(hdr[5], ARRAY_SIZE(types));
+	zassert_equal(sys_get_le16(hdr + 6), HDR_SIZE);
+
+	/* type descriptor: tag, channels, record bytes, NUL-padded name */
+	zassert_equal(t[0], 0);
+	zassert_equal(t[1], ARRAY_SIZE(env_ch));
+	zassert_equal(sys_get_le16(t + 2), ENV_SIZE);
+	zassert_mem_equal(t + 4, "env\0\0\0\0\0", SENSOR_REC_NAME_LEN);
+
+	/* channel descriptors: name, unit, width, exponent */
+	zassert_mem_equal(c, "temp\0\0\0\0C\0\0\0\0\0", 14);
+	zassert_equal(c[14], 2);
+	zassert_equal((int8_t)c[15], -2);
+	c += SENSOR_REC_CHAN_LEN;
+	zassert_mem_equal(c, "pressurehPa\0\0\0", 14, "a full name is not terminated");
+	zassert_equal(c[14], 4);
+	zassert_equal((int8_t)c[15], -3);
+
+	/* second type follows the first one's channels */
+	t += SENSOR_REC_TYPE_LEN + ARRAY_SIZE(env_ch) * SENSOR_REC_CHAN_LEN;
+	zassert_equal(t[0], 7);
+	zassert_equal(t[1], 1);
+	zassert_equal(sys_get_le16(t + 2), sensor_rec_size(&types[1]));
+	zassert_equal(sensor_rec_size(&types[1]), SENSOR_REC_PREFIX + 2);
+}
+
+ZTEST(sensor_rec, test_csv_header)
+{
+	char line[96];
+
+	sensor_rec_csv_header(&types[0], line, sizeof(line));
+	zassert_str_equal(line, "env,t_ms,temp[C],pressure[hPa],hum[%],flags");
+	sensor_rec_csv_header(&types[1], line, sizeof(line));
+	zassert_str_equal(line, "dist,t_ms,dist[m]");
+}
+
+ZTEST(sensor_rec, test_round_trip)
+{
+	char line[96];
+
+	/* 21.345 C rounds half away from zero; micro-hPa drop three decimals */
+	env_csv(1234, 21345000, 1013250400, 45600000, 5, line, sizeof(line));
+	zassert_str_equal(line, "env,1234,21.35,1013.250,46,5");
+
+	/* negative values round away from zero too, and keep their sign below 1 */
+	env_csv(UINT32_MAX, -5000, -1500, -45500000, 0, line, sizeof(line));
+	zassert_str_equal(line, "env,4294967295,-0.01,-0.002,-46,0");
+
+	env_csv(0, 0, 0, 0, 0, line, sizeof(line));
+	zassert_str_equal(line, "env,0,0.00,0.000,0,0");
+}
+
+ZTEST(sensor_rec, test_positive_exponent)
+{
+	int32_t v[1];
+	uint8_t rec[SENSOR_REC_PREFIX + 2];
+	char line[32];
+
+	v[0] = 1549999999;	/* 1549.999999 m → 15 x 100 m */
+	sensor_rec_encode(&types[1], 10, v, rec);
+	zassert_equal(rec[0], 7);
+	sensor_rec_csv(&types[1], rec, line, sizeof(line));
+	zassert_str_equal(line, "dist,10,1500");
+
+	v[0] = -1550000000;
+	sensor_rec_encode(&types[1], 10, v, rec);
+	sensor_rec_csv(&types[1], rec, line, sizeof(line));
+	zassert_str_equal(line, "dist,10,-1600");
+}
+
+ZTEST(sensor_rec, test_saturation)
+{
+	uint8_t rec[ENV_SIZE];
+	int32_t v[] = { 400000000, 0, 200000000, 1000 };
+	char line[96];
+
+	/* too large: the widest value of the channel */
+	env_csv(1, v[0], v[1], v[2], v[3], line, sizeof(line));
+	zassert_str_equal(line, "env,1,327.67,0.000,127,127");
+
+	/* too small: one above the missing marker, never the marker itself */
+	env_csv(2, -v[0], v[1], -v[2], -v[3], line, sizeof(line));
+	zassert_str_equal(line, "env,2,-327.67,0.000,-127,-127");
+
+	v[0] = -v[0];
+	v[3] = -128;
+	sensor_rec_encode(&types[0], 2, v, rec);
+	zassert_equal(sys_get_le16(rec + SENSOR_REC_PREFIX), 0x8001);
+	zassert_equal(rec[ENV_SIZE - 1], 0x81, "-128 is the missing marker of an int8");
+}
+
+ZTEST(sensor_rec, test_missing)
+{
+	int32_t v[] = { SENSOR_REC_NONE, SENSOR_REC_NONE, SENSOR_REC_NONE, SENSOR_REC_NONE };
+	uint8_t rec[ENV_SIZE];
+	char line[96];
+
+	sensor_rec_encode(&types[0], 99, v, rec);
+	zassert_equal(sys_get_le16(rec + SENSOR_REC_PREFIX), 0x8000);
+	zassert_equal(sys_get_le32(rec + SENSOR_REC_PREFIX + 2), 0x80000000);
+	zassert_equal(rec[ENV_SIZE - 2], 0x80);
+	zassert_equal(rec[ENV_SIZE - 1], 0x80);
+	sensor_rec_csv(&types[0], rec, line, sizeof(line));
+	zassert_str_equal(line, "env,99,,,,");
+
+	/* a missing value beside real ones keeps its column */
+	env_csv(100, 20000000, SENSOR_REC_NONE, 50000000, SENSOR_REC_NONE, line, sizeof(line));
+	zassert_str_equal(line, "env,100,20.00,,50,");
+}
+
+ZTEST_SUITE(sensor_rec, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief SMP stress test of sensor_seqlock.h: no reader may see a torn copy.
+ *
+ * One writer (the test thread) keeps storing a self-consistent pattern,
+ * every word equal to the write count, while readers pinned to the other
+ * CPUs copy it with SENSOR_SEQLOCK_READ() and check that all words agree.
+ * The pattern is larger than a cache line, so an unprotected copy racing
+ * the writer would mix two writes.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "sensor_seqlock.h"
+
+#define WORDS		32		/**< Pattern size: 128 bytes. */
+#define WRITES		200000		/**< Writer iterations. */
+#define READERS		(CONFIG_MP_MAX_NUM_CPUS - 1)
+#define STACK_SIZE	1024
+
+/** @brief Guarded object: consistent when every word is equal. */
+struct pattern {
+	uint32_t	w[WORDS];
+};
+
+/** @brief What one reader saw. */
+struct reader_res {
+	uint32_t	reads;		/**< Copies taken. */
+	uint32_t	torn;		/**< Copies with words from two writes. */
+	uint32_t	changes;	/**< Copies that differed from the previous one. */
+};
+
+static struct sensor_seqlock	lock;
+static struct pattern		live;
+static atomic_t			done;
+
+static struct k_thread		reader_data[READERS];
+static K_THREAD_STACK_ARRAY_DEFINE(reader_stack, READERS, STACK_SIZE);
+static struct reader_res	res[READERS];
+
+static void reader(void *p1, void *p2, void *p3)
+{
+	struct reader_res *r = p1;
+	struct pattern snap;
+	uint32_t last = 0;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!atomic_get(&done)) {
+		SENSOR_SEQLOCK_READ(&lock, &snap, &live);
+		r->reads++;
+		for (int k = 1; k < WORDS; k++) {
+			if (snap.w[k] != snap.w[0]) {
+				r->torn++;
+				break;
+			}
+		}
+		if (snap.w[0] != last) {
+			r->changes++;
+			last = snap.w[0];
+		}
+	}
+}
+
+ZTEST(sensor_seqlock, test_no_torn_reads)
+{
+	uint32_t reads = 0, changes = 0;
+
+	atomic_clear(&done);
+	memset(&live, 0, sizeof(live));
+	memset(res, 0, sizeof(res));
+
+	/* one reader pinned to each other CPU; the writer keeps CPU 0 */
+	for (int i = 0; i < READERS; i++) {
+		k_thread_create(&reader_data[i], reader_stack[i], STACK_SIZE, reader,
+				&res[i], NULL, NULL, K_PRIO_PREEMPT(1), 0, K_FOREVER);
+		zassert_ok(k_thread_cpu_pin(&reader_data[i], i + 1));
+		k_thread_start(&reader_data[i]);
+	}
+
+	for (uint32_t n = 1; n <= WRITES; n++) {
+		k_spinlock_key_t key = sensor_seqlock_write_begin(&lock);
+
+		for (int k = 0; k < WORDS; k++) {
+			live.w[k] = n;
+		}
+		sensor_seqlock_write_end(&lock, key);
+	}
+
+	atomic_set(&done, 1);
+	for (int i = 0; i < READERS; i++) {
+		zassert_ok(k_thread_join(&reader_data[i], K_SECONDS(10)));
+		TC_PRINT("reader %d: %u reads, %u changes, %u torn\n", i, res[i].reads,
+			 res[i].changes, res[i].torn);
+		zassert_equal(res[i].torn, 0, "reader %d saw %u torn copies", i, res[i].torn);
+		reads += res[i].reads;
+		changes += res[i].changes;
+	}
+
+	/* the readers must actually have raced the writer */
+	zassert_true(reads > 0, "no reads");
+	zassert_true(changes > 1, "readers never overlapped the writer");
+}
+
+ZTEST_SUITE(sensor_seqlock, NULL, NULL, NULL, NULL, NULL);
@@ -4,36 +4,37 @@
 #include <zephyr/logging/log.h>
 #include "hd44780_pcf8574.h"
 #include <zephyr/drivers/i2c.h>
-#include <zephyr/drivers/sensor.h>
+#include <zephyr/zbus/zbus.h>
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
 
 
 LOG_MODULE_REGISTER(app, LOG_LEVEL_INF);
 
-const struct device *hts_dev = DEVICE_DT_GET(DT_ALIAS(ht_sensor));
 const struct device *lcd = DEVICE_DT_GET(DT_ALIAS(lcd));
 
-int hum_temp_sensor_lcd_data()
+/* the HTS221 is read by the sensor_bus thread; the LCD only renders what it publishes */
+ZBUS_SUBSCRIBER_DEFINE(lcd_sub, 2);
+ZBUS_CHAN_ADD_OBS(sensor_bus_chan, lcd_sub, 0);
+
+int hum_temp_sensor_lcd_data(const struct sensor_bus_sample *s)
 {
 
 	char buf[20];
-	if (!device_is_ready(hts_dev)) return -1;
-	if (sensor_sample_fetch(hts_dev) < 0)
+	if ((s->valid & (SENSOR_BUS_TEMP | SENSOR_BUS_HUM)) != (SENSOR_BUS_TEMP | SENSOR_BUS_HUM))
 	{
 		return -1;
 	}
-	struct sensor_value temp, hum;
-	if (sensor_channel_get(hts_dev, SENSOR_CHAN_AMBIENT_TEMP, &temp) < 0) return -1;
-	if (sensor_channel_get(hts_dev, SENSOR_CHAN_HUMIDITY, &hum) < 0) return -1;
 
-	double t = sensor_value_to_double(&temp);
-	double h = sensor_value_to_double(&hum);
+	int32_t t = s->temp;
+	int32_t h = s->hum;
 	
-	snprintf(buf,sizeof(buf),"Temp: %2.1f C", t);
+	snprintk(buf,sizeof(buf),"Temp: " SENSOR_FIXP_FMT " C", SENSOR_FIXP_ARG(t, 1));
 	hd44780_set_cursor(lcd,0,0);
 	hd44780_print(lcd,buf);
 	LOG_INF("%s",buf);
 	hd44780_set_cursor(lcd,0,1);
-	snprintf(buf,sizeof(buf),"Hum:  %2.1f %%", h);
+	snprintk(buf,sizeof(buf),"Hum:  " SENSOR_FIXP_FMT " %%", SENSOR_FIXP_ARG(h, 1));
 	hd44780_print(lcd,buf);
 	LOG_INF("%s",buf);
 
@@ -43,9 +44,10 @@ int hum_temp_sensor_lcd_data()
 
 int hum_temp_sensor_check(void)
 {
-	if (!device_is_ready(hts_dev)) 
+	/* 100 ms, the rate the display used to poll the sensor at */
+	if (sensor_bus_start(100) < 0 || !(sensor_bus_present() & SENSOR_BUS_TEMP))
 	{
-	       	LOG_ERR("sensor: %s device not ready.", hts_dev->name);
+	       	LOG_ERR("sensor: HT device not ready.");
 		hd44780_set_cursor(lcd, 0, 0);
        	 	hd44780_print(lcd, "Sensor err!");
 
@@ -71,10 +73,17 @@ int main(void)
 	hd44780_clear(lcd);
 	LOG_INF("clear");
 	hum_temp_sensor_check();
-	while(1)
+
+	const struct zbus_channel *chan;
+	struct sensor_bus_sample s;
+
+	/* a redraw slower than the period skips samples, it never delays acquisition */
+	while (zbus_sub_wait(&lcd_sub, &chan, K_FOREVER) == 0)
 	{
-		hum_temp_sensor_lcd_data();
-		k_msleep(100);
+		if (zbus_chan_read(chan, &s, K_MSEC(10)) == 0) {
+			hum_temp_sensor_lcd_data(&s);
+		}
 	}
+	return 0;
 }
 
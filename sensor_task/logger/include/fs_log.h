@@ -4,10 +4,42 @@
 #include <zephyr/kernel.h>
 #include <zephyr/fs/fs.h>
 
+#include "sensor_sink.h"
+#include "sensor_bus.h"
+#include "sensor_pack.h"
+#include "sensor_fcb.h"
+
+/* app_lfs erase pages (64 x 2 KiB on STM32L4), sizes the FCB sector tables */
+#define FSLOG_SECTORS	(FIXED_PARTITION_SIZE(app_lfs) /					\
+			 DT_PROP(DT_MTD_FROM_FIXED_PARTITION(DT_NODELABEL(app_lfs)),	\
+				 erase_block_size))
+
 int fslog_init(void);
-int fslog_append(const char *line);
-int fslog_cat(size_t max_bytes);	/* print to shell/console */
-int fslog_clear(void);
+#if defined(CONFIG_APP_LOG_BINARY)
+int fslog_append_sample(const struct sensor_bus_sample *s);	/* one binary record, buffered */
+#else
+int fslog_append(const char *line);	/* buffered, see fslog_sync() */
+#endif
+int fslog_sync(void);			/* write + commit the buffered lines */
+#if defined(CONFIG_APP_LOG_FCB)
+void fslog_get_stats(struct sensor_fcb_stats *st, size_t *pending);
+#else
+void fslog_get_stats(struct sensor_sink_stats *st, size_t *pending);
+#endif
+#if defined(CONFIG_APP_LOG_PACK)
+void fslog_get_pack_stats(struct sensor_pack_stats *st);	/* ratio, cycles per record */
+#endif
+int fslog_cat(size_t max_bytes);	/* print to shell/console, binary logs as CSV */
+int fslog_clear(void);			/* removes every segment (FCB: erases app_lfs) */
+#if defined(CONFIG_APP_LOG_FCB)
+int fslog_sectors(uint32_t *total);	/* pages holding entries */
+#else
+int fslog_segments(uint32_t *first, uint32_t *last);	/* segment count */
+#endif
+#if defined(CONFIG_APP_LOG_BENCH)
+int fslog_suspend(void);		/* release app_lfs, log erased; appends dropped */
+int fslog_resume(void);			/* fslog_init() again, logging resumes */
+#endif
 
 #endif
 
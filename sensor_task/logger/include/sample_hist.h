@@ -0,0 +1,35 @@
+#ifndef SAMPLE_HIST_H
+#define SAMPLE_HIST_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+/*
+ * Last CONFIG_APP_HIST_SAMPLES samples in RAM, single producer (a zbus
+ * listener on sensor_bus_chan, i.e. the acquisition thread), any number
+ * of readers. The producer never waits: it overwrites the
+ * oldest slot and then publishes the new count. Readers address records by
+ * sequence number and detect records overwritten while they copied them.
+ */
+
+/* one sample, micro-units (see sensor_fixp.h) */
+struct hist_rec {
+	uint32_t	t_ms;		/* uptime, ms */
+	int32_t		temp;		/* °C */
+	int32_t		hum;		/* %RH */
+	int32_t		press;		/* hPa */
+	int32_t		accel[3];	/* m/s^2 */
+};
+
+void hist_push(const struct hist_rec *r);
+
+/* sequence number one past the newest record (= records ever pushed) */
+uint32_t hist_head(void);
+
+/* oldest sequence number still held */
+uint32_t hist_tail(void);
+
+/* copy record @seq; -ENOENT if not pushed yet or already overwritten */
+int hist_get(uint32_t seq, struct hist_rec *out);
+
+#endif
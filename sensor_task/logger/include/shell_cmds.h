@@ -6,6 +6,7 @@
 void sens_shell_register(void);
 void sens_update_period_ms(uint32_t ms);
 uint32_t sens_get_period_ms(void);
+uint32_t sens_get_overruns(void);
 void sens_set_live(bool en);
 
 #endif
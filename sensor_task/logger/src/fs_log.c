@@ -1,97 +1,368 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
 #include <string.h>
 
+#include "fs_log.h"
+#include "sensor_sink.h"
+#include "sensor_rec.h"
+#include "sensor_pack.h"
+#include "sensor_fcb.h"
+
 LOG_MODULE_REGISTER(fslog, LOG_LEVEL_INF);
 
+#if defined(CONFIG_APP_LOG_BINARY)
+#define LOG_PATH	"/lfs/senslog.bin"
+#else
 #define LOG_PATH	"/lfs/senslog.csv"
+#endif
+
+#define LOG_SEGS	(CONFIG_APP_LOG_BUDGET / CONFIG_APP_LOG_SEG_SIZE)
+
+#if defined(CONFIG_APP_LOG_FCB)
+/*
+ * app_lfs as a flash circular buffer: one entry per full buffer (or after
+ * APP_LOG_FLUSH_MS, or on cat/sync), the oldest page erased when it is full.
+ */
+SENSOR_FCB_DEFINE(log_fcb, FIXED_PARTITION_ID(app_lfs), CONFIG_APP_LOG_BUF_SIZE,
+		  CONFIG_APP_LOG_FLUSH_MS, FSLOG_SECTORS);
+#else
+/*
+ * LOG_PATH.0, .1, ... of APP_LOG_SEG_SIZE bytes, oldest removed beyond APP_LOG_BUDGET.
+ * The newest stays open; records reach flash per full buffer, after
+ * APP_LOG_FLUSH_MS, or on cat/clear/sync.
+ */
+SENSOR_SINK_SEG_DEFINE(log_sink, LOG_PATH, CONFIG_APP_LOG_BUF_SIZE, CONFIG_APP_LOG_FLUSH_MS,
+		       CONFIG_APP_LOG_SEG_SIZE, LOG_SEGS);
+#endif
+
+#if defined(CONFIG_APP_LOG_BENCH)
+/* set while `sens bench` has app_lfs; appends are dropped (the sink/FCB refuse them too) */
+static atomic_t log_suspended;
+#endif
 
+#if defined(CONFIG_APP_LOG_BINARY)
+/* one 19 B record per sample, resolution of the CSV columns (accel 0.01 m/s2) */
+static const struct sensor_rec_chan sample_chans[] = {
+	SENSOR_REC_CHAN("temp", "C", 2, -2),
+	SENSOR_REC_CHAN("hum", "%RH", 2, -2),
+	SENSOR_REC_CHAN("press", "hPa", 4, -2),
+	SENSOR_REC_CHAN("ax", "m/s2", 2, -2),
+	SENSOR_REC_CHAN("ay", "m/s2", 2, -2),
+	SENSOR_REC_CHAN("az", "m/s2", 2, -2),
+};
+
+static const struct sensor_rec_type log_types[] = {
+	SENSOR_REC_TYPE(0, "sample", sample_chans),
+};
+
+#if defined(CONFIG_APP_LOG_PACK)
+/* records packed under the sink lock, restarted with every segment */
+SENSOR_PACK_DEFINE(log_pack, log_types);
+#endif
+
+/* file header, built once by fslog_init() */
+static uint8_t log_hdr[SENSOR_REC_HDR_LEN + SENSOR_REC_TYPE_LEN +
+		       ARRAY_SIZE(sample_chans) * SENSOR_REC_CHAN_LEN];
+static size_t log_hdr_len;
+#else
+static const char log_hdr[] = "ts_ms,temp_c,hum_pct,press_hpa,ax,ay,az\r\n";
+#endif
+
+#if !defined(CONFIG_APP_LOG_FCB)
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+
+/* LittleFS on the app_lfs fixed partition (internal flash or flash simulator) */
 static struct fs_mount_t lfs_mnt = {
 	.type = FS_LITTLEFS,
 	.mnt_point = "/lfs",
-	.fs_data = NULL,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)FIXED_PARTITION_ID(app_lfs),
 };
+#endif
 
 int fslog_init(void)
 {
 	int rc;
 
+#if defined(CONFIG_APP_LOG_BINARY)
+#if defined(CONFIG_APP_LOG_PACK)
+	log_hdr_len = sensor_pack_header(&log_pack, log_hdr, sizeof(log_hdr));
+#else
+	log_hdr_len = sensor_rec_header(log_types, ARRAY_SIZE(log_types),
+					log_hdr, sizeof(log_hdr));
+#endif
+#else
+	size_t log_hdr_len = strlen(log_hdr);
+#endif
+
+#if defined(CONFIG_APP_LOG_FCB)
+	/* entries carry no header: its CRC tags the partition, another layout erases it */
+	rc = sensor_fcb_init(&log_fcb, crc32_ieee((const uint8_t *)log_hdr, log_hdr_len));
+	if (rc) {
+		LOG_ERR("fcb init failed: %d", rc);
+	}
+	return rc;
+#else
 	rc = fs_mount(&lfs_mnt);
 	if (rc != 0 && rc != -EEXIST) {
 		LOG_ERR("mount failed: %d", rc);
 		return rc;
 	}
 
-	/* ensure file exists with header */
-	struct fs_file_t f;
-	fs_file_t_init(&f);
-	rc = fs_open(&f, LOG_PATH, FS_O_CREATE | FS_O_READ | FS_O_WRITE);
-	if (rc) {
-		LOG_ERR("open header: %d", rc);
-		return rc;
+	/* the sink writes the header into every new (or cleared) file */
+#if defined(CONFIG_APP_LOG_PACK)
+	(void)sensor_sink_set_filter(&log_sink, sensor_pack_filter, &log_pack);
+#endif
+	sensor_sink_set_header(&log_sink, log_hdr, log_hdr_len);
+	return 0;
+#endif
+}
+
+static int log_append(const void *data, size_t len)
+{
+#if defined(CONFIG_APP_LOG_BENCH)
+	if (atomic_get(&log_suspended)) {
+		return -EAGAIN;
 	}
+#endif
+#if defined(CONFIG_APP_LOG_FCB)
+	int rc = sensor_fcb_append(&log_fcb, data, len);
+#else
+	int rc = sensor_sink_append(&log_sink, data, len);
+#endif
 
-	/* write header if empty */
-	struct fs_dirent ent;
-	rc = fs_stat(LOG_PATH, &ent);
-	if (rc == 0 && ent.size == 0) {
-		const char *hdr = "ts_ms,temp_c,hum_pct,press_hpa,ax,ay,az\r\n";
-		(void)fs_write(&f, hdr, strlen(hdr));
+	/* -EAGAIN: held by fslog_suspend() */
+	if (rc && rc != -EAGAIN) {
+		LOG_ERR("append: %d", rc);
 	}
-	fs_close(&f);
-	return 0;
+	return rc;
 }
 
+#if defined(CONFIG_APP_LOG_BINARY)
+int fslog_append_sample(const struct sensor_bus_sample *s)
+{
+	uint32_t ok = s->valid;
+	int32_t v[] = {
+		(ok & SENSOR_BUS_TEMP) ? s->temp : SENSOR_REC_NONE,
+		(ok & SENSOR_BUS_HUM) ? s->hum : SENSOR_REC_NONE,
+		(ok & SENSOR_BUS_PRESS) ? s->press : SENSOR_REC_NONE,
+		(ok & SENSOR_BUS_ACCEL) ? s->accel[0] : SENSOR_REC_NONE,
+		(ok & SENSOR_BUS_ACCEL) ? s->accel[1] : SENSOR_REC_NONE,
+		(ok & SENSOR_BUS_ACCEL) ? s->accel[2] : SENSOR_REC_NONE,
+	};
+	uint8_t rec[SENSOR_REC_PREFIX + 14];
+	BUILD_ASSERT(ARRAY_SIZE(v) == ARRAY_SIZE(sample_chans));
+
+	/* uptime in ms as u32: wraps after 49 days, order within a file is kept */
+	return log_append(rec, sensor_rec_encode(&log_types[0], (uint32_t)s->t_ms, v, rec));
+}
+#else
 int fslog_append(const char *line)
 {
+	return log_append(line, strlen(line));
+}
+#endif
+
+#if defined(CONFIG_APP_LOG_FCB)
+int fslog_sync(void)
+{
+	return sensor_fcb_flush(&log_fcb);
+}
+
+void fslog_get_stats(struct sensor_fcb_stats *st, size_t *pending)
+{
+	sensor_fcb_get_stats(&log_fcb, st, pending);
+}
+#else
+int fslog_sync(void)
+{
+	return sensor_sink_flush(&log_sink);
+}
+
+void fslog_get_stats(struct sensor_sink_stats *st, size_t *pending)
+{
+	sensor_sink_get_stats(&log_sink, st, pending);
+}
+#endif
+
+#if defined(CONFIG_APP_LOG_PACK)
+void fslog_get_pack_stats(struct sensor_pack_stats *st)
+{
+	sensor_pack_get_stats(&log_pack, st);
+}
+#endif
+
+#if defined(CONFIG_APP_LOG_FCB)
+/* one entry read back at a time, on the shell thread */
+static uint8_t cat_buf[CONFIG_APP_LOG_BUF_SIZE];
+
+#if defined(CONFIG_APP_LOG_BINARY)
+/* the records of one entry as CSV; max_bytes counts record bytes */
+static int cat_entry(const uint8_t *data, size_t len, void *ctx)
+{
+	const struct sensor_rec_type *t = &log_types[0];
+	size_t *left = ctx;
+	size_t size = sensor_rec_size(t);
+	char line[128];
+
+	for (size_t off = 0; off + size <= len && *left >= size; off += size) {
+		if (data[off] != t->tag) {
+			break;	/* not written by this layout: skip the rest */
+		}
+		sensor_rec_csv(t, data + off, line, sizeof(line));
+		printk("%s\r\n", line);
+		*left -= size;
+	}
+	return (*left < size);
+}
+#else
+/* the lines of one entry as stored */
+static int cat_entry(const uint8_t *data, size_t len, void *ctx)
+{
+	size_t *left = ctx;
+	size_t n = MIN(len, *left);
+
+	printk("%.*s", (int)n, data);
+	*left -= n;
+	return (*left == 0);
+}
+#endif
+
+int fslog_cat(size_t max_bytes)
+{
+	/* print what was logged up to now, not what reached flash */
+	(void)sensor_fcb_flush(&log_fcb);
+
+	/* entries have no header: the columns once, then the entries oldest first */
+#if defined(CONFIG_APP_LOG_BINARY)
+	char line[128];
+
+	sensor_rec_csv_header(&log_types[0], line, sizeof(line));
+	printk("%s\r\n", line);
+#else
+	printk("%s", log_hdr);
+#endif
+	int rc = sensor_fcb_for_each(&log_fcb, cat_buf, sizeof(cat_buf), cat_entry, &max_bytes);
+
+	if (rc) {
+		LOG_ERR("cat: %d", rc);
+	}
+	return rc;
+}
+
+int fslog_clear(void)
+{
+	/* erases every page of app_lfs */
+	return sensor_fcb_clear(&log_fcb);
+}
+
+int fslog_sectors(uint32_t *total)
+{
+	return sensor_fcb_sectors(&log_fcb, total);
+}
+#else
+#if defined(CONFIG_APP_LOG_BINARY)
+static void cat_line(void *ctx, const char *line)
+{
+	ARG_UNUSED(ctx);
+	printk("%s\r\n", line);
+}
+
+/* one segment decoded to CSV; max_bytes counts record bytes */
+static int cat_file(const char *path, void *ctx)
+{
+	size_t *left = ctx;
+#if defined(CONFIG_APP_LOG_PACK)
+	int rc = sensor_pack_dump(&log_pack, path, log_hdr, log_hdr_len, left, cat_line, NULL);
+#else
+	int rc = sensor_rec_dump(path, log_hdr, log_hdr_len, log_types, ARRAY_SIZE(log_types),
+				 left, cat_line, NULL);
+#endif
+
+	return (rc < 0) ? rc : (*left == 0);
+}
+#else
+/* one segment as stored, its CSV header included */
+static int cat_file(const char *path, void *ctx)
+{
+	size_t *left = ctx;
 	struct fs_file_t f;
+	char buf[256];
+	ssize_t rd;
 	int rc;
 
 	fs_file_t_init(&f);
-	rc = fs_open(&f, LOG_PATH, FS_O_WRITE | FS_O_APPEND);
+	rc = fs_open(&f, path, FS_O_READ);
 	if (rc) {
-		LOG_ERR("append open: %d", rc);
 		return rc;
 	}
-	rc = fs_write(&f, line, strlen(line));
+	while (*left > 0 && (rd = fs_read(&f, buf, MIN(*left, sizeof(buf)))) > 0) {
+		printk("%.*s", (int)rd, buf);
+		*left -= rd;
+	}
 	fs_close(&f);
-	return rc < 0 ? rc : 0;
+	return (*left == 0);
 }
+#endif
 
 int fslog_cat(size_t max_bytes)
 {
-	struct fs_file_t f;
-	int rc;
+	/* print what was logged up to now, not what reached flash */
+	(void)sensor_sink_flush(&log_sink);
+
+	/* oldest segment first; one removed meanwhile (-ENOENT) is skipped */
+	int rc = sensor_sink_for_each(&log_sink, cat_file, &max_bytes);
 
-	fs_file_t_init(&f);
-	rc = fs_open(&f, LOG_PATH, FS_O_READ);
 	if (rc) {
-		LOG_ERR("cat open: %d", rc);
-		return rc;
+		LOG_ERR("cat: %d", rc);
 	}
+	return rc;
+}
 
-	char buf[256];
-	size_t left = max_bytes;
-	ssize_t rd;
+int fslog_clear(void)
+{
+	/* all segments; the sink re-creates LOG_PATH.0, header first, on the next append */
+	return sensor_sink_clear(&log_sink);
+}
 
-	while (left > 0 && (rd = fs_read(&f, buf, MIN(left, sizeof(buf)))) > 0) {
-		printk("%.*s", (int)rd, buf);
-		left -= rd;
-	}
+int fslog_segments(uint32_t *first, uint32_t *last)
+{
+	return sensor_sink_segments(&log_sink, first, last);
+}
+#endif
 
-	fs_close(&f);
-	return 0;
+#if defined(CONFIG_APP_LOG_BENCH)
+int fslog_suspend(void)
+{
+	atomic_set(&log_suspended, 1);
+#if defined(CONFIG_APP_LOG_FCB)
+	return sensor_fcb_close(&log_fcb);
+#else
+	/*
+	 * Held under the sink lock, so an append already past the flag cannot
+	 * reopen a segment; then segments removed and numbering reset (the
+	 * bench erases the partition anyway) and no file is left open.
+	 */
+	(void)sensor_sink_hold(&log_sink, true);
+	(void)sensor_sink_clear(&log_sink);
+	return fs_unmount(&lfs_mnt);
+#endif
 }
 
-int fslog_clear(void)
+int fslog_resume(void)
 {
-	/* truncate by re-creating */
-	int rc = fs_unlink(LOG_PATH);
-	if (rc && rc != -ENOENT) {
-		return rc;
-	}
-	return fslog_init();
+	int rc = fslog_init();
+
+#if !defined(CONFIG_APP_LOG_FCB)
+	(void)sensor_sink_hold(&log_sink, false);	/* a failed mount then shows in the appends */
+#endif
+	atomic_set(&log_suspended, 0);
+	return rc;
 }
+#endif
 
@@ -0,0 +1,240 @@
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+#include <zephyr/stats/stats.h>
+#endif
+
+#include "fs_log.h"
+#include "sensor_sink.h"
+#include "sensor_fcb.h"
+#include "sensor_rec.h"
+
+/*
+ * `sens bench [records]`: the same records through both log storages on
+ * app_lfs, each from an erased partition:
+ *   lfs - segmented sink on a fresh LittleFS volume (APP_LOG_LFS)
+ *   fcb - flash circular buffer on the raw partition (APP_LOG_FCB)
+ * Same buffer size and APP_LOG_BUDGET bytes of log (the sink's segments,
+ * the leading pages of the FCB), no time trigger, one flush at the end.
+ * Records are the binary log's sample records. Records/s is
+ * uptime, so on native_sim it comes from the flash simulator's program and
+ * erase delays (boards/native_sim.conf). Erases and programmed bytes are the
+ * flash simulator's counters, where it has them. The live log is stopped
+ * and erased for the run, then restarted empty.
+ */
+
+#define BENCH_DEFAULT	20000	/* ~380 KB: both storages wrap the budget several times */
+#define BENCH_MAGIC	0x48434e42	/* "BNCH" */
+
+/* same layout as the binary log's sample record (fs_log.c) */
+static const struct sensor_rec_chan bench_chans[] = {
+	SENSOR_REC_CHAN("temp", "C", 2, -2),
+	SENSOR_REC_CHAN("hum", "%RH", 2, -2),
+	SENSOR_REC_CHAN("press", "hPa", 4, -2),
+	SENSOR_REC_CHAN("ax", "m/s2", 2, -2),
+	SENSOR_REC_CHAN("ay", "m/s2", 2, -2),
+	SENSOR_REC_CHAN("az", "m/s2", 2, -2),
+};
+
+static const struct sensor_rec_type bench_type = SENSOR_REC_TYPE(0, "sample", bench_chans);
+
+#define BENCH_REC_MAX	(SENSOR_REC_PREFIX + 4 * ARRAY_SIZE(bench_chans))
+
+SENSOR_SINK_SEG_DEFINE(bench_sink, "/bench/bench.bin", CONFIG_APP_LOG_BUF_SIZE, 0,
+		       CONFIG_APP_LOG_SEG_SIZE, CONFIG_APP_LOG_BUDGET / CONFIG_APP_LOG_SEG_SIZE);
+SENSOR_FCB_DEFINE(bench_fcb, FIXED_PARTITION_ID(app_lfs), CONFIG_APP_LOG_BUF_SIZE, 0,
+		  FSLOG_SECTORS);
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(bench_lfs);
+
+static struct fs_mount_t bench_mnt = {
+	.type = FS_LITTLEFS,
+	.mnt_point = "/bench",
+	.fs_data = &bench_lfs,
+	.storage_dev = (void *)FIXED_PARTITION_ID(app_lfs),
+};
+
+struct flash_count {
+	uint32_t erases;	/* erase calls, one page each on both paths */
+	uint32_t written;	/* bytes programmed */
+};
+
+struct bench_res {
+	uint32_t ms;
+	uint32_t commits;	/* fs_sync() calls or FCB entries */
+	struct flash_count before, after;
+	bool counted;
+};
+
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+static int count_stat(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
+{
+	struct flash_count *c = arg;
+	uint32_t v = *(uint32_t *)((uint8_t *)hdr + off);
+
+	if (strcmp(name, "flash_erase_calls") == 0) {
+		c->erases = v;
+	} else if (strcmp(name, "bytes_written") == 0) {
+		c->written = v;
+	}
+	return 0;
+}
+#endif
+
+/* flash simulator counters; false on real flash */
+static bool flash_count(struct flash_count *c)
+{
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	if (hdr) {
+		stats_walk(hdr, count_stat, c);
+		return true;
+	}
+#endif
+	ARG_UNUSED(c);
+	return false;
+}
+
+static int erase_area(void)
+{
+	const struct flash_area *fa;
+	int rc = flash_area_open(FIXED_PARTITION_ID(app_lfs), &fa);
+
+	if (rc) {
+		return rc;
+	}
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+	return rc;
+}
+
+/* record i: one every 100 ms, slowly changing values; its bytes */
+static size_t bench_rec(uint8_t *rec, uint32_t i)
+{
+	int32_t v[ARRAY_SIZE(bench_chans)];
+
+	for (size_t k = 0; k < ARRAY_SIZE(v); k++) {
+		v[k] = (int32_t)((i >> k) % 1000) * 10000;
+	}
+	return sensor_rec_encode(&bench_type, i * 100, v, rec);
+}
+
+static int run_lfs(uint32_t n, struct bench_res *r)
+{
+	struct sensor_sink_stats st0, st;
+	uint8_t rec[BENCH_REC_MAX];
+	int rc = fs_mount(&bench_mnt);	/* formats the erased partition */
+
+	if (rc) {
+		return rc;
+	}
+	sensor_sink_get_stats(&bench_sink, &st0, NULL);
+	r->counted = flash_count(&r->before);
+	int64_t t0 = k_uptime_get();
+
+	for (uint32_t i = 0; i < n && rc == 0; i++) {
+		rc = sensor_sink_append(&bench_sink, rec, bench_rec(rec, i));
+	}
+	if (rc == 0) {
+		rc = sensor_sink_close(&bench_sink);
+	}
+	r->ms = (uint32_t)(k_uptime_get() - t0);
+	flash_count(&r->after);
+	sensor_sink_get_stats(&bench_sink, &st, NULL);
+	r->commits = st.syncs - st0.syncs;
+
+	(void)sensor_sink_clear(&bench_sink);	/* numbering restarts for the next run */
+	(void)fs_unmount(&bench_mnt);
+	return rc;
+}
+
+static int run_fcb(uint32_t n, struct bench_res *r)
+{
+	struct sensor_fcb_stats st0, st;
+	uint8_t rec[BENCH_REC_MAX];
+	int rc;
+
+	sensor_fcb_set_budget(&bench_fcb, CONFIG_APP_LOG_BUDGET);
+	rc = sensor_fcb_init(&bench_fcb, BENCH_MAGIC);
+	if (rc) {
+		return rc;
+	}
+	sensor_fcb_get_stats(&bench_fcb, &st0, NULL);
+	r->counted = flash_count(&r->before);
+	int64_t t0 = k_uptime_get();
+
+	for (uint32_t i = 0; i < n && rc == 0; i++) {
+		rc = sensor_fcb_append(&bench_fcb, rec, bench_rec(rec, i));
+	}
+	if (rc == 0) {
+		rc = sensor_fcb_close(&bench_fcb);
+	}
+	r->ms = (uint32_t)(k_uptime_get() - t0);
+	flash_count(&r->after);
+	sensor_fcb_get_stats(&bench_fcb, &st, NULL);
+	r->commits = st.entries - st0.entries;
+	return rc;
+}
+
+static void print_res(const struct shell *sh, const char *name, uint32_t n, int rc,
+		      const struct bench_res *r)
+{
+	if (rc) {
+		shell_print(sh, "%s: failed: %d", name, rc);
+		return;
+	}
+	shell_print(sh, "%s: %u records in %u ms = %u rec/s, %u commits", name, n, r->ms,
+		    r->ms ? (uint32_t)((uint64_t)n * 1000 / r->ms) : 0, r->commits);
+	if (r->counted) {
+		shell_print(sh, "%s: %u page erases, %u B programmed (%u B of records)", name,
+			    r->after.erases - r->before.erases,
+			    r->after.written - r->before.written,
+			    n * (uint32_t)sensor_rec_size(&bench_type));
+	}
+}
+
+static int cmd_sens_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t n = (argc == 2) ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT;
+	struct bench_res r;
+	int rc;
+
+	(void)fslog_suspend();
+	shell_print(sh, "log stopped and erased; %u records of %u B, %u B buffer, %u B budget", n,
+		    (uint32_t)sensor_rec_size(&bench_type), CONFIG_APP_LOG_BUF_SIZE,
+		    CONFIG_APP_LOG_BUDGET);
+
+	memset(&r, 0, sizeof(r));
+	rc = erase_area();
+	if (rc == 0) {
+		rc = run_lfs(n, &r);
+	}
+	print_res(sh, "lfs", n, rc, &r);
+
+	memset(&r, 0, sizeof(r));
+	rc = erase_area();
+	if (rc == 0) {
+		rc = run_fcb(n, &r);
+	}
+	print_res(sh, "fcb", n, rc, &r);
+
+	/* the live log starts over on an erased partition */
+	rc = erase_area();
+
+	int rc2 = fslog_resume();
+
+	rc = rc ? rc : rc2;
+	if (rc) {
+		shell_print(sh, "log restart failed: %d", rc);
+	}
+	return rc;
+}
+
+SHELL_SUBCMD_ADD((sens), bench, NULL, "LittleFS vs FCB log: records/s, erases (erases the log)",
+		 cmd_sens_bench, 1, 1);
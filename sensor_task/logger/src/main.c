@@ -1,120 +1,122 @@
 #include <zephyr/kernel.h>
-#include <zephyr/device.h>
-#include <zephyr/devicetree.h>
-#include <zephyr/drivers/sensor.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/zbus/zbus.h>
 
 #include "fs_log.h"
 #include "shell_cmds.h"
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
 
 LOG_MODULE_REGISTER(app);
-//struct k_thread sampler_t;
-//K_THREAD_STACK_DEFINE(sampler_stack,512);
-/* devices */
-//static const struct device *const dev_hts = DEVICE_DT_GET_ONE(st_hts221);
-//static const struct device *const dev_lps = DEVICE_DT_GET_ONE(st_lps22hb_press);
-//static const struct device *const dev_imu = DEVICE_DT_GET_ONE(st_lsm6dsl);
 
-static const struct device *const dev_hts = DEVICE_DT_GET(DT_ALIAS(ht_sensor));
-static const struct device *const dev_lps = DEVICE_DT_GET(DT_ALIAS(pressure_sensor));
-static const struct device *const dev_imu = DEVICE_DT_GET(DT_ALIAS(imu_sensor));
-
-/* last-sample globals (read by shell) */
-volatile float g_last_temp_c = 0.0f, g_last_hum = 0.0f, g_last_press_hpa = 0.0f;
-volatile float g_last_ax = 0.0f, g_last_ay = 0.0f, g_last_az = 0.0f;
+/*
+ * Acquisition is the sensor_bus thread (sensor_utils): the devices are
+ * fetched once per period and published on sensor_bus_chan. This file only
+ * holds consumers:
+ *   fs_sub   - message subscriber, gets every sample, appends it to the log
+ *              (binary record or CSV line, APP_LOG_FORMAT)
+ *   live_sub - subscriber, prints the latest sample when `sens live on`
+ * sample_hist.c adds a listener feeding the RAM history.
+ */
+ZBUS_MSG_SUBSCRIBER_DEFINE(fs_sub);
+ZBUS_CHAN_ADD_OBS(sensor_bus_chan, fs_sub, 1);
+ZBUS_SUBSCRIBER_DEFINE(live_sub, 2);
+ZBUS_CHAN_ADD_OBS(sensor_bus_chan, live_sub, 2);
 
 /* runtime controls */
 static atomic_t g_live_print = ATOMIC_INIT(0);
-//static struct k_mutex g_rate_lock;
-//extern uint32_t g_period_ms ;
-//g_period_ms = 1000;
 
 void sens_set_live(bool en)
 {
 	atomic_set(&g_live_print, en ? 1 : 0);
 }
 
-/* sampling thread */
-void sampler(void *a, void *b, void *c)
+void sens_update_period_ms(uint32_t ms)
 {
+	sensor_bus_set_period_ms(ms);
+}
 
-	while (1) {
-		uint32_t period = sens_get_period_ms();
-		printk("in thread yo \r\n");
-		/* fetch */
-		(void)sensor_sample_fetch(dev_hts);
-		(void)sensor_sample_fetch(dev_lps);
-		(void)sensor_sample_fetch(dev_imu);
-
-		/* HTS221 */
-		struct sensor_value t, h;
-		if (sensor_channel_get(dev_hts, SENSOR_CHAN_AMBIENT_TEMP, &t) == 0) {
-			g_last_temp_c = sensor_value_to_double(&t);
-		}
-		if (sensor_channel_get(dev_hts, SENSOR_CHAN_HUMIDITY, &h) == 0) {
-			g_last_hum = sensor_value_to_double(&h);
-		}
+uint32_t sens_get_period_ms(void)
+{
+	return sensor_bus_get_period_ms();
+}
 
-		/* LPS22HB */
-		struct sensor_value p;
-		if (sensor_channel_get(dev_lps, SENSOR_CHAN_PRESS, &p) == 0) {
-			g_last_press_hpa = sensor_value_to_double(&p);
-		}
+uint32_t sens_get_overruns(void)
+{
+	struct sensor_bus_stats st;
 
-		/* LSM6DSL accel */
-		struct sensor_value ax, ay, az;
-		if (sensor_channel_get(dev_imu, SENSOR_CHAN_ACCEL_X, &ax) == 0 &&
-		    sensor_channel_get(dev_imu, SENSOR_CHAN_ACCEL_Y, &ay) == 0 &&
-		    sensor_channel_get(dev_imu, SENSOR_CHAN_ACCEL_Z, &az) == 0) {
-			g_last_ax = sensor_value_to_double(&ax);
-			g_last_ay = sensor_value_to_double(&ay);
-			g_last_az = sensor_value_to_double(&az);
-		}
+	sensor_bus_get_stats(&st);
+	return st.overruns;
+}
 
-		/* CSV line */
-		char line[160];
-		snprintk(line, sizeof(line), "%llu,%.2f,%.1f,%.2f,%.3f,%.3f,%.3f\r\n",
-			(unsigned long long)k_uptime_get(),
-			(double)g_last_temp_c, (double)g_last_hum, (double)g_last_press_hpa,
-			(double)g_last_ax, (double)g_last_ay, (double)g_last_az);
+/* CSV line of one sample, returns its length */
+static int format_csv(char *line, size_t len, const struct sensor_bus_sample *s)
+{
+	return snprintk(line, len,
+		"%llu," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ","
+		SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "\r\n",
+		(unsigned long long)s->t_ms,
+		SENSOR_FIXP_ARG(s->temp, 2), SENSOR_FIXP_ARG(s->hum, 1),
+		SENSOR_FIXP_ARG(s->press, 2), SENSOR_FIXP_ARG(s->accel[0], 3),
+		SENSOR_FIXP_ARG(s->accel[1], 3), SENSOR_FIXP_ARG(s->accel[2], 3));
+}
 
-		(void)fslog_append(line);
+/* file logging: every sample, at flash speed; lags are absorbed by the zbus pool */
+static void fs_writer(void *a, void *b, void *c)
+{
+	const struct zbus_channel *chan;
+	struct sensor_bus_sample s;
 
-		if (atomic_get(&g_live_print)) {
-			printk("%s", line);
-		}
+	while (zbus_sub_wait_msg(&fs_sub, &chan, &s, K_FOREVER) == 0) {
+#if defined(CONFIG_APP_LOG_BINARY)
+		(void)fslog_append_sample(&s);
+#else
+		char line[160];
 
-		/* hint PM: let CPU idle/sleep until next period */
-		k_msleep(period);
+		format_csv(line, sizeof(line), &s);
+		(void)fslog_append(line);
+#endif
 	}
 }
 
-K_THREAD_STACK_DEFINE(sampler_stack, 2048);
-static struct k_thread sampler_t;
+K_THREAD_DEFINE(fs_writer_tid, 2048, fs_writer, NULL, NULL, NULL, K_PRIO_PREEMPT(7), 0, 0);
 
-static int devices_ready(void)
+/* live console: latest sample only, a slow UART skips samples instead of queueing */
+static void live_printer(void *a, void *b, void *c)
 {
-	if (!device_is_ready(dev_hts) || !device_is_ready(dev_lps) || !device_is_ready(dev_imu)) {
-		LOG_ERR("sensor device(s) not ready");
-		return -ENODEV;
+	const struct zbus_channel *chan;
+	struct sensor_bus_sample s;
+	char line[160];
+
+	while (zbus_sub_wait(&live_sub, &chan, K_FOREVER) == 0) {
+		if (!atomic_get(&g_live_print) ||
+		    zbus_chan_read(chan, &s, K_MSEC(10)) != 0) {
+			continue;
+		}
+		format_csv(line, sizeof(line), &s);
+		printk("%s", line);
 	}
-	return 0;
 }
 
+K_THREAD_DEFINE(live_tid, 1024, live_printer, NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, 0);
+
 int main(void)
 {
-//	k_mutex_init(&g_rate_lock);
+	if (fslog_init()) {
+		LOG_ERR("fs init failed");
+	}
 
-	if (devices_ready()) {
+	/* CPU idles in the bus thread until the next deadline */
+	if (sensor_bus_start(1000)) {
 		LOG_ERR("Missing sensors; check overlay/board.");
 		return 0;
 	}
-
-	if (fslog_init()) {
-		LOG_ERR("fs init failed");
+	if (sensor_bus_present() != (SENSOR_BUS_TEMP | SENSOR_BUS_HUM | SENSOR_BUS_PRESS |
+				     SENSOR_BUS_ACCEL)) {
+		LOG_WRN("some sensors not ready, their columns stay 0");
 	}
 
 	/* optional: put unused devices into runtime suspended state later */
@@ -122,12 +124,8 @@ int main(void)
 		/* example: pm_device_action_run(dev_imu, PM_DEVICE_ACTION_SUSPEND); */
 //	}
 
-	k_thread_create(&sampler_t, sampler_stack, K_THREAD_STACK_SIZEOF(sampler_stack),
-		sampler, NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
-
 	/* shell commands are registered by link */
 	LOG_INF("sensor logger ready. try: sens show | sens cat 1024 | sens rate 2000 | sens live on");
 
 	return 0;
 }
-
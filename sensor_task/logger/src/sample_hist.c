@@ -0,0 +1,209 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/zbus/zbus.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sample_hist.h"
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
+#include "sensor_agg.h"
+
+#define HIST_LEN	CONFIG_APP_HIST_SAMPLES
+
+static struct hist_rec ring[HIST_LEN];
+static atomic_t head;		/* records ever pushed; slot = seq % HIST_LEN */
+
+void hist_push(const struct hist_rec *r)
+{
+	uint32_t h = (uint32_t)atomic_get(&head);
+
+	ring[h % HIST_LEN] = *r;
+	/* atomic_set is a full barrier: the slot is visible before the count */
+	atomic_set(&head, (atomic_val_t)(h + 1));
+}
+
+/* listener: runs in the acquisition thread, hist_push() is O(1) and never waits */
+static void hist_on_sample(const struct zbus_channel *chan)
+{
+	const struct sensor_bus_sample *s = zbus_chan_const_msg(chan);
+	struct hist_rec r = {
+		.t_ms = (uint32_t)s->t_ms,
+		.temp = s->temp, .hum = s->hum, .press = s->press,
+		.accel = { s->accel[0], s->accel[1], s->accel[2] },
+	};
+
+	hist_push(&r);
+}
+
+ZBUS_LISTENER_DEFINE(hist_lis, hist_on_sample);
+ZBUS_CHAN_ADD_OBS(sensor_bus_chan, hist_lis, 0);
+
+uint32_t hist_head(void)
+{
+	return (uint32_t)atomic_get(&head);
+}
+
+uint32_t hist_tail(void)
+{
+	uint32_t h = hist_head();
+
+	return (h > HIST_LEN) ? h - HIST_LEN : 0;
+}
+
+int hist_get(uint32_t seq, struct hist_rec *out)
+{
+	uint32_t h = hist_head();
+
+	if (seq >= h || h - seq > HIST_LEN) {
+		return -ENOENT;
+	}
+
+	*out = ring[seq % HIST_LEN];
+	barrier_dmem_fence_full();
+
+	/*
+	 * While head == seq + HIST_LEN the producer may be rewriting this
+	 * slot (it bumps head only after the copy), so the record is only
+	 * known intact if it is still strictly inside the window.
+	 */
+	h = hist_head();
+	return (h - seq < HIST_LEN) ? 0 : -ENOENT;
+}
+
+/* --- shell: sens hist ... --- */
+
+/* resolve "[n]" (last n) or "<from> <to>" (sequence range) to [from, to) */
+static int parse_range(size_t argc, char **argv, uint32_t def_n, uint32_t *from, uint32_t *to)
+{
+	uint32_t h = hist_head();
+	uint32_t t = hist_tail();
+
+	if (argc == 3) {
+		*from = MAX((uint32_t)strtoul(argv[1], NULL, 10), t);
+		*to = MIN((uint32_t)strtoul(argv[2], NULL, 10) + 1, h);
+	} else {
+		uint32_t n = (argc == 2) ? (uint32_t)strtoul(argv[1], NULL, 10) : def_n;
+
+		*to = h;
+		*from = (h - t > n) ? h - n : t;
+	}
+	return (*from < *to) ? 0 : -ENOENT;
+}
+
+static int cmd_hist_info(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	struct hist_rec a, b;
+	uint32_t h = hist_head();
+	uint32_t t = hist_tail();
+
+	shell_print(sh, "history: %u/%u records (%u bytes), total %u",
+		h - t, HIST_LEN, (unsigned)sizeof(ring), h);
+	if (h == 0) {
+		return 0;
+	}
+	/* the oldest slot is the next one the sampler rewrites; skip it if busy */
+	if (hist_get(t, &a) != 0) {
+		t++;
+	}
+	if (hist_get(t, &a) == 0 && hist_get(h - 1, &b) == 0) {
+		shell_print(sh, "seq %u..%u, %u ms .. %u ms", t, h - 1, a.t_ms, b.t_ms);
+	}
+	return 0;
+}
+
+static void print_rec(const struct shell *sh, uint32_t seq, const struct hist_rec *r)
+{
+	shell_print(sh, "%u,%u," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ","
+		SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT,
+		seq, r->t_ms,
+		SENSOR_FIXP_ARG(r->temp, 2), SENSOR_FIXP_ARG(r->hum, 1),
+		SENSOR_FIXP_ARG(r->press, 2), SENSOR_FIXP_ARG(r->accel[0], 3),
+		SENSOR_FIXP_ARG(r->accel[1], 3), SENSOR_FIXP_ARG(r->accel[2], 3));
+}
+
+static int dump(const struct shell *sh, size_t argc, char **argv, bool header)
+{
+	uint32_t from, to, lost = 0;
+	struct hist_rec r;
+
+	if (parse_range(argc, argv, header ? HIST_LEN : 10, &from, &to)) {
+		shell_print(sh, "no records in range");
+		return 0;
+	}
+	if (header) {
+		shell_print(sh, "seq,ts_ms,temp_c,hum_pct,press_hpa,ax,ay,az");
+	}
+	for (uint32_t s = from; s < to; s++) {
+		if (hist_get(s, &r) == 0) {
+			print_rec(sh, s, &r);
+		} else {
+			lost++;		/* overwritten while printing */
+		}
+	}
+	if (lost) {
+		shell_print(sh, "(%u records overwritten during dump)", lost);
+	}
+	return 0;
+}
+
+static int cmd_hist_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	return dump(sh, argc, argv, false);
+}
+
+static int cmd_hist_export(const struct shell *sh, size_t argc, char **argv)
+{
+	return dump(sh, argc, argv, true);
+}
+
+static int cmd_hist_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	static const char *const name[] = { "temp", "hum", "press", "ax", "ay", "az" };
+	struct sensor_agg agg[ARRAY_SIZE(name)];
+	uint32_t from, to;
+	struct hist_rec r;
+
+	if (parse_range(argc, argv, HIST_LEN, &from, &to)) {
+		shell_print(sh, "no records in range");
+		return 0;
+	}
+	for (int c = 0; c < ARRAY_SIZE(name); c++) {
+		sensor_agg_reset(&agg[c]);
+	}
+	for (uint32_t s = from; s < to; s++) {
+		if (hist_get(s, &r) != 0) continue;
+		sensor_agg_add(&agg[0], r.temp);
+		sensor_agg_add(&agg[1], r.hum);
+		sensor_agg_add(&agg[2], r.press);
+		for (int k = 0; k < 3; k++) {
+			sensor_agg_add(&agg[3 + k], r.accel[k]);
+		}
+	}
+	if (agg[0].n == 0) {
+		shell_print(sh, "no records in range");
+		return 0;
+	}
+
+	shell_print(sh, "seq %u..%u, %u samples (min/mean/max/stddev)", from, to - 1, agg[0].n);
+	for (int c = 0; c < ARRAY_SIZE(name); c++) {
+		shell_print(sh, "%-5s " SENSOR_FIXP_FMT " / " SENSOR_FIXP_FMT " / " SENSOR_FIXP_FMT
+			" / " SENSOR_FIXP_FMT, name[c],
+			SENSOR_FIXP_ARG(agg[c].min, 3), SENSOR_FIXP_ARG(sensor_agg_mean(&agg[c]), 3),
+			SENSOR_FIXP_ARG(agg[c].max, 3), SENSOR_FIXP_ARG(sensor_agg_stddev(&agg[c]), 3));
+	}
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_hist,
+	SHELL_CMD_ARG(dump,   NULL, "print records: [n] | <from_seq> <to_seq>", cmd_hist_dump, 1, 2),
+	SHELL_CMD_ARG(stats,  NULL, "min/mean/max/stddev: [n] | <from_seq> <to_seq>", cmd_hist_stats, 1, 2),
+	SHELL_CMD_ARG(export, NULL, "CSV with header: [n] | <from_seq> <to_seq>", cmd_hist_export, 1, 2),
+	SHELL_SUBCMD_SET_END
+);
+SHELL_SUBCMD_ADD((sens), hist, &sub_hist, "in-RAM sample history (no flash access)",
+	cmd_hist_info, 1, 0);
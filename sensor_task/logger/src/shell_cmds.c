@@ -6,22 +6,31 @@
 
 #include "fs_log.h"
 #include "shell_cmds.h"
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
 
 LOG_MODULE_REGISTER(sens_sh, LOG_LEVEL_INF);
-static struct k_mutex g_rate_lock;
-
-extern volatile float g_last_temp_c, g_last_hum, g_last_press_hpa;
-extern volatile float g_last_ax, g_last_ay, g_last_az;
-
-uint32_t g_period_ms = 1000;
 
 
 static int cmd_sens_show(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
-	shell_print(sh, "T=%.2f C, H=%.1f %%, P=%.2f hPa, A=[%.3f,%.3f,%.3f] g",
-		(double)g_last_temp_c, (double)g_last_hum, (double)g_last_press_hpa,
-		(double)g_last_ax, (double)g_last_ay, (double)g_last_az);
+	struct sensor_bus_sample s;
+	struct sensor_bus_stats st;
+
+	/* latest published sample; the shell never fetches the sensors itself */
+	if (zbus_chan_read(&sensor_bus_chan, &s, K_MSEC(100)) != 0 || s.seq == 0) {
+		shell_print(sh, "no sample yet");
+		return 0;
+	}
+	sensor_bus_get_stats(&st);
+	shell_print(sh, "T=" SENSOR_FIXP_FMT " C, H=" SENSOR_FIXP_FMT " %%, P=" SENSOR_FIXP_FMT
+		" hPa, A=[" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "] m/s2",
+		SENSOR_FIXP_ARG(s.temp, 2), SENSOR_FIXP_ARG(s.hum, 1),
+		SENSOR_FIXP_ARG(s.press, 2), SENSOR_FIXP_ARG(s.accel[0], 3),
+		SENSOR_FIXP_ARG(s.accel[1], 3), SENSOR_FIXP_ARG(s.accel[2], 3));
+	shell_print(sh, "sample #%u at %lld ms; published %u, lost %u, dropped %u", s.seq, s.t_ms,
+		st.published, st.lost, st.dropped);
 	return 0;
 }
 
@@ -43,10 +52,78 @@ static int cmd_sens_clear(const struct shell *sh, size_t argc, char **argv)
 	return rc;
 }
 
+/* commit buffered lines now and show how many flash commits the buffer saved */
+#if defined(CONFIG_APP_LOG_FCB)
+static int cmd_sens_sync(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+	struct sensor_fcb_stats st;
+	size_t pending;
+	uint32_t total;
+
+	fslog_get_stats(&st, &pending);
+	int rc = fslog_sync();
+	int used = fslog_sectors(&total);
+
+	shell_print(sh, "%u records (%u B), %u B were pending; %u entries",
+		st.appends, st.bytes, (uint32_t)pending, st.entries);
+	shell_print(sh, "%d of %u pages in use, %u erased for room, %u formats",
+		used, total, st.rotations, st.formats);
+	if (st.errors) {
+		shell_print(sh, "%u errors, %u B dropped", st.errors, st.dropped);
+	}
+	if (rc) {
+		shell_print(sh, "sync failed: %d", rc);
+	}
+	return rc;
+}
+#else
+static int cmd_sens_sync(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+	struct sensor_sink_stats st;
+	size_t pending;
+
+	fslog_get_stats(&st, &pending);
+	int rc = fslog_sync();
+
+	shell_print(sh, "%u records (%u B), %u B were pending; %u writes, %u syncs, %u opens",
+		st.appends, st.bytes, (uint32_t)pending, st.writes, st.syncs, st.opens);
+	if (st.errors) {
+		shell_print(sh, "%u errors, %u B dropped", st.errors, st.dropped);
+	}
+
+	uint32_t first, last;
+	int segs = fslog_segments(&first, &last);
+
+	if (segs > 0) {
+		shell_print(sh, "%d segments (%u..%u) of %u B, %u rotations, %u removed",
+			segs, first, last, CONFIG_APP_LOG_SEG_SIZE, st.rotations, st.removed);
+	}
+#if defined(CONFIG_APP_LOG_PACK)
+	struct sensor_pack_stats ps;
+
+	fslog_get_pack_stats(&ps);
+	if (ps.records && ps.out) {
+		uint32_t x100 = (uint32_t)((uint64_t)ps.in * 100 / ps.out);
+
+		shell_print(sh, "packed %u B -> %u B (deltas %u B), x%u.%02u; %u cycles/record, max %u",
+			ps.in, ps.out, ps.delta, x100 / 100, x100 % 100,
+			(uint32_t)(ps.cycles / ps.records), ps.max_cycles);
+	}
+#endif
+	if (rc) {
+		shell_print(sh, "sync failed: %d", rc);
+	}
+	return rc;
+}
+#endif
+
 static int cmd_sens_rate(const struct shell *sh, size_t argc, char **argv)
 {
 	if (argc != 2) {
-		shell_print(sh, "rate: %u ms", sens_get_period_ms());
+		shell_print(sh, "rate: %u ms (overruns: %u)", sens_get_period_ms(),
+			    sens_get_overruns());
 		return 0;
 	}
 	uint32_t ms = (uint32_t)strtoul(argv[1], NULL, 10);
@@ -68,33 +145,12 @@ static int cmd_sens_live(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
-SHELL_STATIC_SUBCMD_SET_CREATE(sub_sens,
-	SHELL_CMD(show, NULL, "show last sample", cmd_sens_show),
-	SHELL_CMD(cat,  NULL, "print log (opt: <max_bytes>)", cmd_sens_cat),
-	SHELL_CMD(clear,NULL, "truncate log", cmd_sens_clear),
-	SHELL_CMD(rate, NULL, "get/set period ms", cmd_sens_rate),
-	SHELL_CMD(live, NULL, "enable/disable live prints", cmd_sens_live),
-	SHELL_SUBCMD_SET_END
-);
-void sens_update_period_ms(uint32_t ms)
-{
-	k_mutex_init(&g_rate_lock);
-        k_mutex_lock(&g_rate_lock, K_FOREVER);
-        g_period_ms = ms;
-        k_mutex_unlock(&g_rate_lock);
-}
-
-uint32_t sens_get_period_ms(void)
-{
-        uint32_t ms;
-	k_mutex_init(&g_rate_lock);
-        k_mutex_lock(&g_rate_lock, K_FOREVER);
-        ms = g_period_ms;
-        k_mutex_unlock(&g_rate_lock);
-        return ms;
-}
-
+/* other files (sample_hist.c) add to this set with SHELL_SUBCMD_ADD */
+SHELL_SUBCMD_SET_CREATE(sub_sens, (sens));
+SHELL_SUBCMD_ADD((sens), show,  NULL, "show last sample", cmd_sens_show, 0, 0);
+SHELL_SUBCMD_ADD((sens), cat,   NULL, "print log (opt: <max_bytes>)", cmd_sens_cat, 0, 0);
+SHELL_SUBCMD_ADD((sens), clear, NULL, "remove all log records", cmd_sens_clear, 0, 0);
+SHELL_SUBCMD_ADD((sens), sync,  NULL, "commit buffered log records, show write/storage stats", cmd_sens_sync, 0, 0);
+SHELL_SUBCMD_ADD((sens), rate,  NULL, "get/set period ms", cmd_sens_rate, 0, 0);
+SHELL_SUBCMD_ADD((sens), live,  NULL, "enable/disable live prints", cmd_sens_live, 0, 0);
 SHELL_CMD_REGISTER(sens, &sub_sens, "sensor logging controls", NULL);
-
-void sens_shell_register(void) { /* linker pulls via above */ }
-
@@ -7,31 +7,163 @@
 #include <zephyr/logging/log.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <zephyr/sys/util.h>
+#include "sensor_fixp.h"
 
 /**
  * @file htpg_sensors.h
  * @brief Sensor interface for humidity/temperature, IMU, and pressure sensors.
  *
- * This header provides initialization and data retrieval APIs for
- * commonly used environmental and motion sensors in Zephyr-based
- * applications.
+ * The sensors are described once, in @ref HTPG_SENSOR_TABLE; one generic
+ * read routine, specialised per table entry at compile time, serves all
+ * of them.
  */
 
 /**
- * @brief Initialize humidity and temperature sensor.
+ * @brief Humidity/temperature sample in micro-units (see sensor_fixp.h).
+ */
+struct ht_sample {
+	int32_t		temp;		/**< Temperature in µ°C. */
+	int32_t		hum;		/**< Relative humidity in µ%. */
+};
+
+/**
+ * @brief Pressure sample in micro-units.
+ */
+struct press_sample {
+	int32_t		press;		/**< Pressure in µkPa. */
+};
+
+/**
+ * @brief IMU sample in micro-units.
+ */
+struct imu_sample {
+	int32_t		accel[3];	/**< Accelerometer X/Y/Z in µm/s^2. */
+	int32_t		gyro[3];	/**< Gyroscope X/Y/Z in µrad/s. */
+};
+
+/**
+ * @brief Sensor table, one X() entry per sensor:
  *
- * Probes and configures the humidity/temperature sensor for use.
+ * @code
+ *  X(id, devicetree alias, shell name, default period ms, channel, ...)
+ * @endcode
+ *
+ * Each channel is a tuple @c (sensor_channel, htpg_sample field, values,
+ * scale): the driver channel, where its micro-unit value(s) land in
+ * @ref htpg_sample, how many values it returns (1 or 3) and an integer
+ * factor applied after conversion. The sensor ids, the devices, the read
+ * routines, the RTIO read requests and the shell names are all generated
+ * from this list, so a sensor whose driver follows the fetch/channel_get
+ * model is added here and in @ref htpg_sample only. A missing alias leaves
+ * the sensor in the table but every read fails: -ENODEV from the sync
+ * readers, and no read request (its @c ok bit stays clear) in an async
+ * batch.
+ */
+#define HTPG_SENSOR_TABLE(X)								\
+	X(HTPG_HT,	ht_sensor,	 "ht",	  6000,					\
+	  (SENSOR_CHAN_AMBIENT_TEMP, ht.temp, 1, 1),					\
+	  (SENSOR_CHAN_HUMIDITY,     ht.hum,  1, 1))					\
+	X(HTPG_PRESS,	pressure_sensor, "press", 6000,					\
+	  (SENSOR_CHAN_PRESS,	     press.press, 1, 1))				\
+	X(HTPG_IMU,	imu_sensor,	 "imu",	  6000,					\
+	  (SENSOR_CHAN_ACCEL_XYZ,    imu.accel, 3, 1),					\
+	  (SENSOR_CHAN_GYRO_XYZ,     imu.gyro,  3, 1))
+
+/** @cond INTERNAL_HIDDEN */
+#define HTPG_ENUM_(id, ...)	id,
+/** @endcond */
+
+/**
+ * @brief Sensor identifiers, in table order; @c BIT(id) forms acquisition masks.
+ */
+enum htpg_sensor {
+	HTPG_SENSOR_TABLE(HTPG_ENUM_)
+	HTPG_COUNT,
+};
+
+/** @brief Mask selecting every sensor. */
+#define HTPG_ALL	BIT_MASK(HTPG_COUNT)
+
+/**
+ * @brief Combined sample of all sensors with per-sensor validity.
+ */
+struct htpg_sample {
+	struct ht_sample	ht;		/**< Humidity/temperature. */
+	struct press_sample	press;		/**< Pressure. */
+	struct imu_sample	imu;		/**< Accelerometer/gyroscope. */
+	uint32_t		ok;		/**< @c BIT(id) of every valid sensor. */
+};
+
+/**
+ * @brief One channel of a table entry, as used by the generic readers.
+ */
+struct htpg_chan {
+	enum sensor_channel	chan;		/**< Driver channel. */
+	uint16_t		off;		/**< Byte offset in @ref htpg_sample. */
+	uint8_t			n;		/**< int32 values (1 or 3). */
+	int32_t			scale;		/**< Factor on the micro-unit value. */
+};
+
+/** @brief @ref htpg_chan initialiser from a table channel tuple. */
+#define HTPG_CHAN_DESC(t)	HTPG_CHAN_DESC_ t
+/** @cond INTERNAL_HIDDEN */
+#define HTPG_CHAN_DESC_(c, field, cnt, sc)						\
+	{ .chan = (c), .off = offsetof(struct htpg_sample, field), .n = (cnt), .scale = (sc) }
+/** @endcond */
+
+/**
+ * @brief Check every sensor of the table.
+ *
+ * @return @c BIT(id) of the sensors whose device is ready.
+ */
+uint32_t htpg_sensors_init(void);
+
+/**
+ * @brief Read one sensor into its fields of @p out.
+ *
+ * One fetch, then every channel of the table entry, converted to
+ * micro-units without float math. Sets or clears @c BIT(id) in
+ * @c out->ok; other sensors' fields are left untouched.
+ *
+ * @param id  Sensor.
+ * @param out Destination sample.
  *
  * @retval 0 on success.
- * @retval negative error code on failure.
+ * @retval -ENODEV if the device is missing or not ready.
+ * @retval negative errno from the driver on fetch/channel error.
  */
-int hum_temp_sensor_init(void);
+int htpg_sensor_read(enum htpg_sensor id, struct htpg_sample *out);
+
+/**
+ * @brief Copy the sensors in @p mask from @p src to @p dst.
+ *
+ * Values are copied only for sensors valid in @p src (a failed read keeps
+ * the previous values in @p dst); the validity bits of @p mask are taken
+ * from @p src either way.
+ */
+void htpg_sample_copy(struct htpg_sample *dst, const struct htpg_sample *src, uint32_t mask);
+
+/** @brief Device of sensor @p id, or NULL if its alias is not in devicetree. */
+const struct device *htpg_sensor_dev(enum htpg_sensor id);
+
+/** @brief Shell name of sensor @p id. */
+const char *htpg_sensor_name(enum htpg_sensor id);
+
+/**
+ * @brief Channel list of sensor @p id.
+ *
+ * @param id  Sensor.
+ * @param cnt Set to the number of entries.
+ * @return First entry.
+ */
+const struct htpg_chan *htpg_sensor_chans(enum htpg_sensor id, size_t *cnt);
 
 /**
  * @brief Get humidity and temperature readings as formatted string.
  *
- * Retrieves the latest sensor values and formats them into a
- * null-terminated string stored in @p buf.
+ * Thin formatter on top of htpg_sensor_read(); formats the
+ * values into a null-terminated string stored in @p buf.
  *
  * @param buf      Pointer to buffer for storing the formatted string.
  * @param buf_len  Length of @p buf in bytes.
@@ -42,7 +174,62 @@ int hum_temp_sensor_init(void);
 int hum_temp_sensor_get_string(char *buf, size_t buf_len);
 
 /**
- * @brief Initialize IMU sensor.
+ * @brief Get IMU readings as formatted string.
+ *
+ * Thin formatter on top of htpg_sensor_read().
+ *
+ * @param buf      Pointer to buffer for storing the formatted string.
+ * @param buf_len  Length of @p buf in bytes.
+ *
+ * @retval Number of characters written (excluding null terminator).
+ * @retval negative error code on failure.
+ */
+int imu_sensor_get_string(char *buf, size_t buf_len);
+
+/**
+ * @brief Get pressure reading as formatted string.
+ *
+ * Thin formatter on top of htpg_sensor_read().
+ *
+ * @param buf      Pointer to buffer for storing the formatted string.
+ * @param buf_len  Length of @p buf in bytes.
+ *
+ * @retval Number of characters written (excluding null terminator).
+ * @retval negative error code on failure.
+ */
+int pressure_sensor_get_string(char *buf, size_t buf_len);
+
+#if defined(CONFIG_APP_SENSOR_DRDY)
+/**
+ * @brief Arm data-ready triggers on the HT and IMU sensors.
+ *
+ * Each DRDY interrupt posts @c BIT(id) of its sensor to @p ready, so the
+ * worker blocked on it wakes once per fresh sample. Also requests
+ * @c CONFIG_APP_IMU_ODR_HZ on the IMU.
+ *
+ * @param ready Event object the sensor bits are posted to.
+ *
+ * @retval 0 on success.
+ * @retval negative error code on failure.
+ */
+int htpg_sensors_drdy_enable(struct k_event *ready);
+#endif
+
+#if defined(CONFIG_APP_SENSOR_ASYNC)
+/**
+ * @brief Read the selected sensors as one asynchronous RTIO batch.
+ *
+ * Queues the selected reads back to back, submits them together and
+ * decodes each completion into @p out. A failed or unselected read
+ * leaves the matching bit of @c out->ok clear.
  *
- * Probes and configures the IMU (accelerome*
+ * @param out  Destination sample.
+ * @param mask Sensors to read, @c BIT(enum htpg_sensor) (e.g. @ref HTPG_ALL).
+ *
+ * @retval 0 when the batch completed (check the per-sensor flags).
+ * @retval negative error code if the batch could not be submitted.
+ */
+int htpg_sensors_read_async(struct htpg_sample *out, uint32_t mask);
+#endif
 
+#endif /* HTPG_SENSORS_H */
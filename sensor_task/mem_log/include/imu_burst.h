@@ -0,0 +1,39 @@
+#ifndef IMU_BURST_H
+#define IMU_BURST_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include "htpg_sensors.h"
+
+/**
+ * @file imu_burst.h
+ * @brief Event-triggered IMU burst capture with a pre-trigger ring buffer.
+ *
+ * Every IMU sample published by the sensor cycle is also pushed into a RAM
+ * ring. When the acceleration magnitude reaches the trigger threshold, the
+ * ring keeps filling for @c CONFIG_APP_BURST_POST_SAMPLES more samples and
+ * the whole window (up to @c CONFIG_APP_BURST_PRE_SAMPLES before the trigger,
+ * the trigger sample, and the post-trigger samples) is handed to a writer
+ * thread that appends it to /lfs/imu_burst.bin as one block.
+ *
+ * The capture rate is the IMU sampling rate of the cycle; use the DRDY mode
+ * (overlay-drdy.conf) or a short `sensors period imu` to capture at full rate.
+ */
+
+#if defined(CONFIG_APP_IMU_BURST)
+/**
+ * @brief Feed one IMU sample to the burst ring (no-op while disarmed).
+ *
+ * Must be called from a single context (the IMU producer).
+ *
+ * @param s Sample in µm/s^2 and µrad/s.
+ */
+void imu_burst_feed(const struct imu_sample *s);
+#else
+static inline void imu_burst_feed(const struct imu_sample *s)
+{
+	ARG_UNUSED(s);
+}
+#endif
+
+#endif /* IMU_BURST_H */
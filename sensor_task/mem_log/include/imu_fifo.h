@@ -0,0 +1,84 @@
+#ifndef IMU_FIFO_H
+#define IMU_FIFO_H
+
+#include <zephyr/kernel.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "htpg_sensors.h"
+
+/**
+ * @file imu_fifo.h
+ * @brief LSM6DSL hardware FIFO batch reader.
+ *
+ * Configures the LSM6DSL FIFO in continuous mode with accel and gyro at
+ * the same ODR and drains it in burst I2C reads, so hundreds of samples
+ * cost one wake-up instead of one wake-up each. Timestamps are rebuilt
+ * from the ODR rather than from the (late) read time.
+ *
+ * The Zephyr LSM6DSL driver does not expose the FIFO, so this talks to
+ * the registers directly on the same I2C device; it is not meant to be
+ * combined with @c CONFIG_APP_SENSOR_DRDY.
+ */
+
+/** @brief One FIFO sample set: raw counts plus reconstructed timestamp. */
+struct imu_fifo_sample {
+	int64_t		ts_us;		/**< Uptime of this sample in µs. */
+	int16_t		gyro[3];	/**< Raw gyroscope X/Y/Z counts. */
+	int16_t		accel[3];	/**< Raw accelerometer X/Y/Z counts. */
+};
+
+/** @brief Scale of the raw counts, read back from the full-scale settings. */
+struct imu_fifo_scale {
+	uint32_t	accel_ug;	/**< Accelerometer µg per LSB. */
+	uint32_t	gyro_udps;	/**< Gyroscope µdps per LSB. */
+};
+
+/**
+ * @brief Start FIFO capture at the given output data rate.
+ *
+ * @param odr_hz Requested rate; rounded to the nearest supported ODR
+ *               (13, 26, 52, 104, 208, 416, 833, 1660 Hz).
+ *
+ * @retval 0 on success.
+ * @retval negative error code on bus failure.
+ */
+int imu_fifo_start(uint32_t odr_hz);
+
+/**
+ * @brief Put the FIFO back in bypass mode (discarding its content) and
+ *        restore the accel/gyro ODR found by imu_fifo_start().
+ *
+ * @retval 0 on success.
+ * @retval negative error code on bus failure.
+ */
+int imu_fifo_stop(void);
+
+/**
+ * @brief Drain complete sample sets from the FIFO.
+ *
+ * @param out      Destination array.
+ * @param max      Capacity of @p out in samples.
+ * @param overrun  Set to true if the FIFO overflowed since the last drain
+ *                 (timestamps were re-anchored to the read time).
+ *
+ * @retval Number of samples written to @p out.
+ * @retval negative error code on bus failure.
+ */
+int imu_fifo_drain(struct imu_fifo_sample *out, size_t max, bool *overrun);
+
+/** @brief Actual ODR selected by imu_fifo_start(), in mHz. */
+uint32_t imu_fifo_odr_mhz(void);
+
+/** @brief Scale of the raw counts of the running capture. */
+const struct imu_fifo_scale *imu_fifo_get_scale(void);
+
+/**
+ * @brief Convert a raw FIFO sample to micro-units.
+ *
+ * @param in  Raw sample.
+ * @param out Destination in µm/s^2 and µrad/s.
+ */
+void imu_fifo_to_sample(const struct imu_fifo_sample *in, struct imu_sample *out);
+
+#endif /* IMU_FIFO_H */
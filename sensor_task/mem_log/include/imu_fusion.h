@@ -0,0 +1,48 @@
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <zephyr/kernel.h>
+#include "htpg_sensors.h"
+
+/**
+ * @file imu_fusion.h
+ * @brief Orientation stage on the IMU output of the sensor cycle.
+ *
+ * Runs the fixed-point complementary filter of sensor_fusion.h on every
+ * published IMU sample, in the producer's context, with dt taken from the
+ * sample timestamps. Roll/pitch/yaw are added to the log row and shown
+ * with the quaternion by `sensors orient`.
+ */
+
+#if defined(CONFIG_APP_IMU_FUSION)
+/**
+ * @brief Advance the filter with one IMU sample.
+ *
+ * Must be called from a single context (the IMU producer).
+ *
+ * @param s Sample in µm/s^2 and µrad/s.
+ */
+void imu_fusion_feed(const struct imu_sample *s);
+
+/**
+ * @brief Latest orientation in micro-degrees.
+ *
+ * @param rpy Destination roll, pitch, yaw.
+ *
+ * @retval true if the filter has been seeded.
+ */
+bool imu_fusion_get_rpy(int32_t rpy[3]);
+#else
+static inline void imu_fusion_feed(const struct imu_sample *s)
+{
+	ARG_UNUSED(s);
+}
+
+static inline bool imu_fusion_get_rpy(int32_t rpy[3])
+{
+	ARG_UNUSED(rpy);
+	return false;
+}
+#endif
+
+#endif /* IMU_FUSION_H */
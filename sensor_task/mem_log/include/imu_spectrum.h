@@ -0,0 +1,36 @@
+#ifndef IMU_SPECTRUM_H
+#define IMU_SPECTRUM_H
+
+#include <zephyr/kernel.h>
+#include "htpg_sensors.h"
+
+/**
+ * @file imu_spectrum.h
+ * @brief Vibration spectrum stage on the IMU output of the sensor cycle.
+ *
+ * IMU samples are collected into blocks of @c CONFIG_APP_SPECTRUM_POINTS
+ * (double-buffered). Each full block is handed to an analysis thread that
+ * runs a Q15 real FFT per accelerometer axis (sensor_spectrum.h), sums the
+ * three power spectra and reduces them to the peak frequency and per-band
+ * energy shares. Results are logged, appended to /lfs/imu_spec.csv and
+ * shown by `sensors fft`; `sensors fft bench` times the kernel on
+ * synthetic tones.
+ */
+
+#if defined(CONFIG_APP_IMU_SPECTRUM)
+/**
+ * @brief Feed one IMU sample to the current block.
+ *
+ * Must be called from a single context (the IMU producer).
+ *
+ * @param s Sample in µm/s^2 and µrad/s.
+ */
+void imu_spectrum_feed(const struct imu_sample *s);
+#else
+static inline void imu_spectrum_feed(const struct imu_sample *s)
+{
+	ARG_UNUSED(s);
+}
+#endif
+
+#endif /* IMU_SPECTRUM_H */
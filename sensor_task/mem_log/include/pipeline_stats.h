@@ -0,0 +1,64 @@
+#ifndef PIPELINE_STATS_H
+#define PIPELINE_STATS_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+/**
+ * @file pipeline_stats.h
+ * @brief Per-stage latency instrumentation of the mem_log pipeline.
+ *
+ * Each stage of a logging cycle is timed with the hardware cycle counter
+ * and accumulated as min/avg/max plus a log2 histogram (see sensor_stat.h).
+ * `sensors stats` dumps the table, `sensors stats reset` clears it.
+ * Without @c CONFIG_APP_PIPELINE_STATS the hooks compile to nothing.
+ */
+
+/** @brief Instrumented stages, in pipeline order. */
+enum pipe_stage {
+	PSTAGE_HT_READ,		/**< HTS221 fetch + channel get. */
+	PSTAGE_PRESS_READ,	/**< LPS22HB fetch + channel get. */
+	PSTAGE_IMU_READ,	/**< LSM6DSL fetch + channel get. */
+	PSTAGE_ASYNC_BATCH,	/**< RTIO batch submit → decoded (async mode). */
+	PSTAGE_SNAPSHOT,	/**< Seqlock snapshot copy. */
+	PSTAGE_FORMAT,		/**< Row formatting (snprintk). */
+	PSTAGE_FS_APPEND,	/**< Row into the log buffer (+ write/commit when full). */
+	PSTAGE_CYCLE,		/**< Whole coordinator cycle: acquire + row. */
+	PSTAGE_SPECTRUM,	/**< IMU block FFT + features (off-cycle). */
+	PSTAGE_COUNT
+};
+
+#if defined(CONFIG_APP_PIPELINE_STATS)
+/**
+ * @brief Record one duration of @p stage.
+ *
+ * @param stage  Stage.
+ * @param cycles Duration in hardware cycles.
+ */
+void pstat_record(enum pipe_stage stage, uint32_t cycles);
+
+/** @brief Start timing a stage; pass the result to pstat_end(). */
+static inline uint32_t pstat_begin(void)
+{
+	return k_cycle_get_32();
+}
+
+/** @brief Finish timing @p stage started at @p t0. */
+static inline void pstat_end(enum pipe_stage stage, uint32_t t0)
+{
+	pstat_record(stage, k_cycle_get_32() - t0);
+}
+#else
+static inline uint32_t pstat_begin(void)
+{
+	return 0;
+}
+
+static inline void pstat_end(enum pipe_stage stage, uint32_t t0)
+{
+	ARG_UNUSED(stage);
+	ARG_UNUSED(t0);
+}
+#endif
+
+#endif /* PIPELINE_STATS_H */
@@ -10,19 +10,16 @@
  * @file shell_threads.h
  * @brief Sensor thread interface for shell-based applications.
  *
- * This header declares thread entry functions that handle
- * sensor sampling and reporting for humidity/temperature,
- * pressure, and IMU sensors. These threads are typically
- * created and managed in the main application to provide
- * periodic sensor data acquisition.
+ * This header declares the entry function of the acquisition worker that
+ * samples every sensor of the table in htpg_sensors.h on request of the
+ * logging coordinator.
  */
 
 /**
- * @brief Humidity/temperature sensor thread.
+ * @brief Acquisition worker thread, shared by all sensors.
  *
- * Thread entry function for sampling humidity and temperature
- * from the sensor and reporting results (e.g., via logging
- * or shell output).
+ * Thread entry function that reads the sensors whose bits are posted to
+ * its wake-up event and publishes the samples to the logger snapshot.
  *
  * @param a Unused parameter.
  * @param b Unused parameter.
@@ -30,36 +27,6 @@
  *
  * @return void
  */
-void hum_thread(void *a, void *b, void *c);
-
-/**
- * @brief Pressure sensor thread.
- *
- * Thread entry function for sampling pressure from the sensor
- * and reporting results (e.g., via logging or shell output).
- *
- * @param a Unused parameter.
- * @param b Unused parameter.
- * @param c Unused parameter.
- *
- * @return void
- */
-void press_thread(void *a, void *b, void *c);
-
-/**
- * @brief IMU sensor thread.
- *
- * Thread entry function for sampling IMU (accelerometer
- * and gyroscope) values and reporting results (e.g., via
- * logging or shell output).
- *
- * @param a Unused parameter.
- * @param b Unused parameter.
- * @param c Unused parameter.
- *
- * @return void
- */
-void imu_thread(void *a, void *b, void *c);
+void worker_thread(void *a, void *b, void *c);
 
 #endif /* SHELL_THREADS_H */
-
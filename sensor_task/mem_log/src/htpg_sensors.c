@@ -5,77 +5,157 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <stdio.h>
+#include <string.h>
 
 /** @brief Register log module for sensor operations. */
 LOG_MODULE_REGISTER(sensors);
 
-/** @brief Humidity/temperature sensor device (HTS221). */
-const struct device *const hts_dev = DEVICE_DT_GET(DT_ALIAS(ht_sensor));
+/** @cond INTERNAL_HIDDEN */
+#define HTPG_DEV_(id, alias, ...)	[id] = DEVICE_DT_GET_OR_NULL(DT_ALIAS(alias)),
+#define HTPG_NAME_(id, alias, name, ...)	[id] = name,
+#define HTPG_CHANS_(id, alias, name, period, ...)					\
+	static const struct htpg_chan chans_##id[] = {					\
+		FOR_EACH(HTPG_CHAN_DESC, (,), __VA_ARGS__)				\
+	};
+#define HTPG_CHAN_REF_(id, ...)		[id] = { chans_##id, ARRAY_SIZE(chans_##id) },
+#define HTPG_READER_(id, ...)								\
+	static int read_##id(struct htpg_sample *out)					\
+	{										\
+		return read_chans(devs[id], chans_##id, ARRAY_SIZE(chans_##id), out);	\
+	}
+#define HTPG_READER_REF_(id, ...)	[id] = read_##id,
+/** @endcond */
+
+/** @brief Device of each sensor (NULL when its alias is absent). */
+static const struct device *const devs[HTPG_COUNT] = {
+	HTPG_SENSOR_TABLE(HTPG_DEV_)
+};
+
+/** @brief Shell name of each sensor. */
+static const char *const names[HTPG_COUNT] = {
+	HTPG_SENSOR_TABLE(HTPG_NAME_)
+};
 
-/** @brief IMU sensor device (accelerometer + gyroscope). */
-const struct device *const imu_dev = DEVICE_DT_GET(DT_ALIAS(imu_sensor));
+HTPG_SENSOR_TABLE(HTPG_CHANS_)
 
-/** @brief Pressure sensor device (LPS22HB). */
-const struct device *const pressure_dev = DEVICE_DT_GET(DT_ALIAS(pressure_sensor));
+/** @brief Channel list of each sensor. */
+static const struct {
+	const struct htpg_chan	*c;	/**< First channel. */
+	size_t			n;	/**< Channels. */
+} chans[HTPG_COUNT] = {
+	HTPG_SENSOR_TABLE(HTPG_CHAN_REF_)
+};
 
 /**
- * @brief Retrieve humidity and temperature readings as string.
+ * @brief Generic read: one fetch, then every channel of @p ch.
  *
- * Fetches latest humidity and temperature values from the HTS221 sensor,
- * converts them to human-readable units, logs them, and writes a formatted
- * string into @p buf.
+ * Always inlined into the per-sensor readers below, where @p dev, @p ch and
+ * @p n are constants: the channel loop is unrolled and the offsets, counts
+ * and scales fold into immediate operands, so each sensor gets the code a
+ * hand-written reader would have had.
  *
- * @param buf      Pointer to output buffer.
- * @param buf_len  Size of @p buf in bytes.
+ * @param dev Device.
+ * @param ch  Channels.
+ * @param n   Entries in @p ch.
+ * @param out Destination sample.
  *
- * @retval Number of characters written (excluding null terminator).
- * @retval -1 on failure (e.g., device not ready, fetch/channel error).
+ * @retval 0 on success.
+ * @retval -ENODEV if device is missing or not ready.
+ * @retval negative errno from the driver on fetch/channel error.
  */
-int hum_temp_sensor_get_string(char *buf, size_t buf_len)
+static ALWAYS_INLINE int read_chans(const struct device *dev, const struct htpg_chan *ch,
+				    size_t n, struct htpg_sample *out)
 {
-	int ret;
+	int rc;
 
-	if (!device_is_ready(hts_dev)) return -1;
-	if (sensor_sample_fetch(hts_dev) < 0) return -1;
+	if (dev == NULL || !device_is_ready(dev)) return -ENODEV;
 
-	struct sensor_value temp, hum;
-	if (sensor_channel_get(hts_dev, SENSOR_CHAN_AMBIENT_TEMP, &temp) < 0) return -1;
-	if (sensor_channel_get(hts_dev, SENSOR_CHAN_HUMIDITY, &hum) < 0) return -1;
+	rc = sensor_sample_fetch(dev);
+	if (rc < 0) return rc;
 
-	double t = sensor_value_to_double(&temp);
-	double h = sensor_value_to_double(&hum);
+	for (size_t i = 0; i < n; i++) {
+		struct sensor_value v[3];
+		int32_t *dst = (int32_t *)((uint8_t *)out + ch[i].off);
 
-	LOG_INF("Temperature: %.1f C", t);
-	LOG_INF("Humidity: %.1f %%", h);
+		rc = sensor_channel_get(dev, ch[i].chan, v);
+		if (rc < 0) return rc;
 
-	ret = snprintf(buf, buf_len,
-		       "Temperature: %.1f C, Humidity: %.1f %%\n",
-		       t, h);
-	return ret;
+		for (int k = 0; k < ch[i].n; k++) {
+			dst[k] = sensor_fixp_from_value(&v[k]) * ch[i].scale;
+		}
+	}
+	return 0;
 }
 
-/**
- * @brief Initialize humidity/temperature sensor.
- *
- * Checks if the HTS221 sensor device is ready.
- *
- * @retval 0 on success.
- * @retval -1 if device is not ready.
- */
-int hum_temp_sensor_init(void)
+HTPG_SENSOR_TABLE(HTPG_READER_)
+
+/** @brief Specialised reader of each sensor. */
+static int (*const readers[HTPG_COUNT])(struct htpg_sample *out) = {
+	HTPG_SENSOR_TABLE(HTPG_READER_REF_)
+};
+
+int htpg_sensor_read(enum htpg_sensor id, struct htpg_sample *out)
+{
+	int rc = readers[id](out);
+
+	WRITE_BIT(out->ok, id, rc == 0);
+	return rc;
+}
+
+void htpg_sample_copy(struct htpg_sample *dst, const struct htpg_sample *src, uint32_t mask)
 {
-	if (!device_is_ready(hts_dev)) {
-		LOG_ERR("sensor: %s device not ready.", hts_dev->name);
-		return -1;
+	for (int id = 0; id < HTPG_COUNT; id++) {
+		if (!(mask & BIT(id))) continue;
+
+		if (src->ok & BIT(id)) {
+			for (size_t i = 0; i < chans[id].n; i++) {
+				const struct htpg_chan *c = &chans[id].c[i];
+
+				memcpy((uint8_t *)dst + c->off, (const uint8_t *)src + c->off,
+				       c->n * sizeof(int32_t));
+			}
+		}
+		WRITE_BIT(dst->ok, id, (src->ok & BIT(id)) != 0);
 	}
-	return 0;
+}
+
+const struct device *htpg_sensor_dev(enum htpg_sensor id)
+{
+	return devs[id];
+}
+
+const char *htpg_sensor_name(enum htpg_sensor id)
+{
+	return names[id];
+}
+
+const struct htpg_chan *htpg_sensor_chans(enum htpg_sensor id, size_t *cnt)
+{
+	*cnt = chans[id].n;
+	return chans[id].c;
+}
+
+uint32_t htpg_sensors_init(void)
+{
+	uint32_t ready = 0;
+
+	for (int id = 0; id < HTPG_COUNT; id++) {
+		if (devs[id] == NULL) {
+			LOG_WRN("sensor %s: no devicetree alias", names[id]);
+		} else if (!device_is_ready(devs[id])) {
+			LOG_ERR("sensor %s: %s device not ready.", names[id], devs[id]->name);
+		} else {
+			ready |= BIT(id);
+		}
+	}
+	return ready;
 }
 
 /**
- * @brief Retrieve IMU readings as string.
+ * @brief Retrieve humidity and temperature readings as string.
  *
- * Fetches accelerometer and gyroscope values from the IMU sensor,
- * logs them, and writes formatted string into @p buf.
+ * Thin formatter over htpg_sensor_read(): formats the micro-unit
+ * values with integer-only arithmetic, logs them, and writes a formatted string into @p buf.
  *
  * @param buf      Pointer to output buffer.
  * @param buf_len  Size of @p buf in bytes.
@@ -83,63 +163,62 @@ int hum_temp_sensor_init(void)
  * @retval Number of characters written (excluding null terminator).
  * @retval -1 on failure (e.g., device not ready, fetch/channel error).
  */
-int imu_sensor_get_string(char *buf, size_t buf_len)
+int hum_temp_sensor_get_string(char *buf, size_t buf_len)
 {
-	int ret;
-
-	if (!device_is_ready(imu_dev)) return -1;
-	if (sensor_sample_fetch(imu_dev) < 0) return -1;
+	struct htpg_sample r;
 
-	struct sensor_value ax, ay, az, gx, gy, gz;
+	if (htpg_sensor_read(HTPG_HT, &r) < 0) return -1;
 
-	sensor_sample_fetch_chan(imu_dev, SENSOR_CHAN_ACCEL_XYZ);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_ACCEL_X, &ax);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_ACCEL_Y, &ay);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_ACCEL_Z, &az);
+	const struct ht_sample s = r.ht;
 
-	sensor_sample_fetch_chan(imu_dev, SENSOR_CHAN_GYRO_XYZ);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_GYRO_X, &gx);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_GYRO_Y, &gy);
-	sensor_channel_get(imu_dev, SENSOR_CHAN_GYRO_Z, &gz);
+	LOG_INF("Temperature: " SENSOR_FIXP_FMT " C", SENSOR_FIXP_ARG(s.temp, 1));
+	LOG_INF("Humidity: " SENSOR_FIXP_FMT " %%", SENSOR_FIXP_ARG(s.hum, 1));
 
-	double axd = sensor_value_to_double(&ax);
-	double ayd = sensor_value_to_double(&ay);
-	double azd = sensor_value_to_double(&az);
-	double gxd = sensor_value_to_double(&gx);
-	double gyd = sensor_value_to_double(&gy);
-	double gzd = sensor_value_to_double(&gz);
-
-	LOG_INF("Accel: x=%.2f y=%.2f z=%.2f", axd, ayd, azd);
-	LOG_INF("Gyro : x=%.2f y=%.2f z=%.2f", gxd, gyd, gzd);
-
-	ret = snprintf(buf, buf_len,
-		       "Accel: %.2f, %.2f, %.2f | Gyro: %.2f, %.2f, %.2f\n",
-		       axd, ayd, azd, gxd, gyd, gzd);
-	return ret;
+	return snprintk(buf, buf_len,
+			"Temperature: " SENSOR_FIXP_FMT " C, Humidity: " SENSOR_FIXP_FMT " %%\n",
+			SENSOR_FIXP_ARG(s.temp, 1), SENSOR_FIXP_ARG(s.hum, 1));
 }
 
 /**
- * @brief Initialize IMU sensor.
+ * @brief Retrieve IMU readings as string.
  *
- * Checks if the IMU device is ready.
+ * Thin formatter over htpg_sensor_read(): logs accelerometer and gyroscope
+ * values and writes formatted string into @p buf.
  *
- * @retval 0 on success.
- * @retval -1 if device is not ready.
+ * @param buf      Pointer to output buffer.
+ * @param buf_len  Size of @p buf in bytes.
+ *
+ * @retval Number of characters written (excluding null terminator).
+ * @retval -1 on failure (e.g., device not ready, fetch/channel error).
  */
-int imu_sensor_init(void)
+int imu_sensor_get_string(char *buf, size_t buf_len)
 {
-	if (!device_is_ready(imu_dev)) {
-		LOG_ERR("IMU sensor not ready.");
-		return -1;
-	}
-	return 0;
+	struct htpg_sample r;
+
+	if (htpg_sensor_read(HTPG_IMU, &r) < 0) return -1;
+
+	const struct imu_sample s = r.imu;
+
+	LOG_INF("Accel: x=" SENSOR_FIXP_FMT " y=" SENSOR_FIXP_FMT " z=" SENSOR_FIXP_FMT,
+		SENSOR_FIXP_ARG(s.accel[0], 2), SENSOR_FIXP_ARG(s.accel[1], 2),
+		SENSOR_FIXP_ARG(s.accel[2], 2));
+	LOG_INF("Gyro : x=" SENSOR_FIXP_FMT " y=" SENSOR_FIXP_FMT " z=" SENSOR_FIXP_FMT,
+		SENSOR_FIXP_ARG(s.gyro[0], 2), SENSOR_FIXP_ARG(s.gyro[1], 2),
+		SENSOR_FIXP_ARG(s.gyro[2], 2));
+
+	return snprintk(buf, buf_len,
+			"Accel: " SENSOR_FIXP_FMT ", " SENSOR_FIXP_FMT ", " SENSOR_FIXP_FMT
+			" | Gyro: " SENSOR_FIXP_FMT ", " SENSOR_FIXP_FMT ", " SENSOR_FIXP_FMT "\n",
+			SENSOR_FIXP_ARG(s.accel[0], 2), SENSOR_FIXP_ARG(s.accel[1], 2),
+			SENSOR_FIXP_ARG(s.accel[2], 2), SENSOR_FIXP_ARG(s.gyro[0], 2),
+			SENSOR_FIXP_ARG(s.gyro[1], 2), SENSOR_FIXP_ARG(s.gyro[2], 2));
 }
 
 /**
  * @brief Retrieve pressure reading as string.
  *
- * Fetches latest pressure value from the LPS22HB sensor,
- * logs it, and writes a formatted string into @p buf.
+ * Thin formatter over htpg_sensor_read(): logs the value and writes
+ * a formatted string into @p buf.
  *
  * @param buf      Pointer to output buffer.
  * @param buf_len  Size of @p buf in bytes.
@@ -149,36 +228,87 @@ int imu_sensor_init(void)
  */
 int pressure_sensor_get_string(char *buf, size_t buf_len)
 {
-	int ret;
+	struct htpg_sample r;
+
+	if (htpg_sensor_read(HTPG_PRESS, &r) < 0) return -1;
+
+	const struct press_sample s = r.press;
 
-	if (!device_is_ready(pressure_dev)) return -1;
-	if (sensor_sample_fetch(pressure_dev) < 0) return -1;
+	LOG_INF("Pressure: " SENSOR_FIXP_FMT " kPa", SENSOR_FIXP_ARG(s.press, 1));
+
+	return snprintk(buf, buf_len, "Pressure: " SENSOR_FIXP_FMT " kPa\n",
+			SENSOR_FIXP_ARG(s.press, 1));
+}
 
-	struct sensor_value pressure;
-	if (sensor_channel_get(pressure_dev, SENSOR_CHAN_PRESS, &pressure) < 0) return -1;
 
-	double p = sensor_value_to_double(&pressure);
+#if defined(CONFIG_APP_SENSOR_DRDY)
+/** @brief Event object receiving @c BIT(id) from the DRDY triggers. */
+static struct k_event *drdy_event;
 
-	LOG_INF("Pressure: %.1f kPa", p);
+/**
+ * @brief DRDY trigger handler shared by all sensors.
+ *
+ * Runs in the driver's trigger thread; only wakes the worker, which then
+ * performs the actual register read (clearing DRDY).
+ */
+static void drdy_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+	ARG_UNUSED(trig);
 
-	ret = snprintf(buf, buf_len, "Pressure: %.1f kPa\n", p);
-	return ret;
+	for (int id = 0; id < HTPG_COUNT; id++) {
+		if (dev == devs[id]) {
+			k_event_post(drdy_event, BIT(id));
+			return;
+		}
+	}
 }
 
 /**
- * @brief Initialize pressure sensor.
+ * @brief Arm data-ready triggers on the HT and IMU sensors.
  *
- * Checks if the pressure sensor device is ready.
+ * @param ready Event object the sensor bits are posted to.
  *
  * @retval 0 on success.
- * @retval -1 if device is not ready.
+ * @retval negative errno from @c sensor_trigger_set().
  */
-int pressure_sensor_init(void)
+int htpg_sensors_drdy_enable(struct k_event *ready)
 {
-	if (!device_is_ready(pressure_dev)) {
-		LOG_ERR("sensor: %s device not ready.", pressure_dev->name);
-		return -1;
+	static const struct sensor_trigger ht_trig = {
+		.type = SENSOR_TRIG_DATA_READY,
+		.chan = SENSOR_CHAN_ALL,
+	};
+	static const struct sensor_trigger imu_trig = {
+		.type = SENSOR_TRIG_DATA_READY,
+		.chan = SENSOR_CHAN_ACCEL_XYZ,
+	};
+	const struct sensor_value odr = { .val1 = CONFIG_APP_IMU_ODR_HZ };
+	const struct device *hts_dev = devs[HTPG_HT];
+	const struct device *imu_dev = devs[HTPG_IMU];
+	int rc;
+
+	drdy_event = ready;
+
+	rc = sensor_attr_set(imu_dev, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+	if (rc < 0) {
+		LOG_WRN("IMU accel ODR %d Hz not applied (%d)", CONFIG_APP_IMU_ODR_HZ, rc);
+	}
+	rc = sensor_attr_set(imu_dev, SENSOR_CHAN_GYRO_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+	if (rc < 0) {
+		LOG_WRN("IMU gyro ODR %d Hz not applied (%d)", CONFIG_APP_IMU_ODR_HZ, rc);
+	}
+
+	rc = sensor_trigger_set(hts_dev, &ht_trig, drdy_handler);
+	if (rc < 0) {
+		LOG_ERR("HT DRDY trigger failed (%d)", rc);
+		return rc;
 	}
+
+	rc = sensor_trigger_set(imu_dev, &imu_trig, drdy_handler);
+	if (rc < 0) {
+		LOG_ERR("IMU DRDY trigger failed (%d)", rc);
+		return rc;
+	}
+
 	return 0;
 }
-
+#endif
@@ -0,0 +1,173 @@
+
+/**
+ * @file
+ * @brief Batched asynchronous acquisition of the sensor table over RTIO.
+ *
+ * The table reads are queued as one RTIO submission. Drivers without a native
+ * @c submit hook are served by the sensor subsystem's fallback on the RTIO
+ * work queue, so the caller blocks only once for the whole batch instead of
+ * once per sensor.
+ */
+
+#include "htpg_sensors.h"
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/logging/log.h>
+
+/** @brief Register log module for async sensor operations. */
+LOG_MODULE_REGISTER(sensors_async);
+
+/** @cond INTERNAL_HIDDEN */
+#define HTPG_IODEV_CHAN(t)		HTPG_IODEV_CHAN_ t
+#define HTPG_IODEV_CHAN_(c, ...)	{c, 0}
+#define HTPG_IODEV_(id, alias, name, period, ...)					\
+	IF_ENABLED(DT_HAS_ALIAS(alias),							\
+		   (SENSOR_DT_READ_IODEV(iodev_##id, DT_ALIAS(alias),			\
+					 FOR_EACH(HTPG_IODEV_CHAN, (,), __VA_ARGS__));))
+#define HTPG_IODEV_REF_(id, alias, ...)							\
+	[id] = COND_CODE_1(DT_HAS_ALIAS(alias), (&iodev_##id), (NULL)),
+/** @endcond */
+
+/** @brief One read request per table sensor present in the devicetree, with its channels. */
+HTPG_SENSOR_TABLE(HTPG_IODEV_)
+
+/** @brief RTIO context: room for one batch, buffers from a mempool. */
+RTIO_DEFINE_WITH_MEMPOOL(htpg_rtio, HTPG_COUNT + 1, HTPG_COUNT + 1,
+			 CONFIG_APP_SENSOR_ASYNC_BLOCKS, 32, 4);
+
+/** @brief I/O devices for each sensor id, NULL when its alias is missing. */
+static struct rtio_iodev *const slot_iodev[HTPG_COUNT] = {
+	HTPG_SENSOR_TABLE(HTPG_IODEV_REF_)
+};
+
+/**
+ * @brief Decode one scalar channel to micro-units.
+ *
+ * @retval 0 on success, negative errno otherwise.
+ */
+static int decode_scalar(const struct sensor_decoder_api *dec, const uint8_t *buf,
+			 enum sensor_channel chan, int32_t *out)
+{
+	struct sensor_q31_data data = {0};
+	struct sensor_decode_context ctx = SENSOR_DECODE_CONTEXT_INIT(dec, buf, chan, 0);
+
+	if (sensor_decode(&ctx, &data, 1) <= 0) return -EIO;
+
+	*out = sensor_fixp_from_q31(data.readings[0].value, data.shift);
+	return 0;
+}
+
+/**
+ * @brief Decode one XYZ channel to three micro-unit values.
+ *
+ * @retval 0 on success, negative errno otherwise.
+ */
+static int decode_xyz(const struct sensor_decoder_api *dec, const uint8_t *buf,
+		      enum sensor_channel chan, int32_t out[3])
+{
+	struct sensor_three_axis_data data = {0};
+	struct sensor_decode_context ctx = SENSOR_DECODE_CONTEXT_INIT(dec, buf, chan, 0);
+
+	if (sensor_decode(&ctx, &data, 1) <= 0) return -EIO;
+
+	for (int i = 0; i < 3; i++) {
+		out[i] = sensor_fixp_from_q31(data.readings[0].values[i], data.shift);
+	}
+	return 0;
+}
+
+/**
+ * @brief Decode a completed slot buffer into @p out.
+ *
+ * Walks the slot's table channels, so the decode matches the read request.
+ *
+ * @retval true if all channels of the slot decoded.
+ */
+static bool decode_slot(enum htpg_sensor slot, const uint8_t *buf, struct htpg_sample *out)
+{
+	const struct sensor_decoder_api *dec;
+	const struct htpg_chan *ch;
+	size_t n;
+
+	if (sensor_get_decoder(htpg_sensor_dev(slot), &dec) != 0) return false;
+
+	ch = htpg_sensor_chans(slot, &n);
+	for (size_t i = 0; i < n; i++) {
+		int32_t *dst = (int32_t *)((uint8_t *)out + ch[i].off);
+		int rc = (ch[i].n == 3) ? decode_xyz(dec, buf, ch[i].chan, dst)
+					: decode_scalar(dec, buf, ch[i].chan, dst);
+
+		if (rc != 0) return false;
+		for (int k = 0; k < ch[i].n; k++) {
+			dst[k] *= ch[i].scale;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Read the selected sensors as one asynchronous RTIO batch.
+ *
+ * Acquires one SQE per selected sensor, submits them together and waits
+ * for the batch, then decodes each completion. Completions arrive in any
+ * order; the sensor id travels in the CQE userdata.
+ *
+ * @param out  Destination sample.
+ * @param mask Sensors to read.
+ *
+ * @retval 0 when the batch completed (check the per-sensor flags).
+ * @retval -ENOMEM if the submission queue is exhausted.
+ * @retval negative errno from @c rtio_submit().
+ */
+int htpg_sensors_read_async(struct htpg_sample *out, uint32_t mask)
+{
+	uint32_t queued = 0;
+	int rc;
+
+	out->ok = 0;
+
+	for (int i = 0; i < HTPG_COUNT; i++) {
+		if (!(mask & BIT(i))) continue;
+		if (slot_iodev[i] == NULL) continue;	/* no alias: ok bit stays clear */
+
+		struct rtio_sqe *sqe = rtio_sqe_acquire(&htpg_rtio);
+
+		if (sqe == NULL) {
+			rtio_sqe_drop_all(&htpg_rtio);
+			return -ENOMEM;
+		}
+		rtio_sqe_prep_read_with_pool(sqe, slot_iodev[i], RTIO_PRIO_NORM,
+					     (void *)(uintptr_t)i);
+		queued++;
+	}
+
+	if (queued == 0) return 0;
+
+	rc = rtio_submit(&htpg_rtio, queued);
+	if (rc < 0) {
+		LOG_ERR("batch submit failed (%d)", rc);
+		return rc;
+	}
+
+	for (uint32_t n = 0; n < queued; n++) {
+		struct rtio_cqe *cqe = rtio_cqe_consume_block(&htpg_rtio);
+		enum htpg_sensor slot = (enum htpg_sensor)(uintptr_t)cqe->userdata;
+		int result = cqe->result;
+		uint8_t *buf = NULL;
+		uint32_t buf_len = 0;
+
+		(void)rtio_cqe_get_mempool_buffer(&htpg_rtio, cqe, &buf, &buf_len);
+		rtio_cqe_release(&htpg_rtio, cqe);
+
+		bool ok = (result >= 0) && (buf != NULL) && decode_slot(slot, buf, out);
+
+		WRITE_BIT(out->ok, slot, ok);
+
+		if (buf != NULL) {
+			rtio_release_buffer(&htpg_rtio, buf, buf_len);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file
+ * @brief Event-triggered IMU burst capture: pre-trigger ring plus block writer.
+ *
+ * The IMU producer pushes each sample into @ref ring. A sample whose
+ * acceleration magnitude reaches the threshold starts a burst; once
+ * @c CONFIG_APP_BURST_POST_SAMPLES further samples are in, the window is
+ * copied out of the ring into @ref out and the writer thread appends it to
+ * @ref BURST_PATH as a @ref imu_burst_hdr followed by @c count
+ * @ref imu_burst_rec. The ring keeps filling while the block is written;
+ * a trigger that arrives before the previous block is on flash is counted
+ * as missed.
+ */
+
+#include "imu_burst.h"
+#include "sensor_fixp.h"
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------ config ------------ */
+#define BURST_PATH		"/lfs/imu_burst.bin"	/**< Burst log file in LittleFS. */
+#define BURST_MAGIC		0x54535242		/**< "BRST" little-endian. */
+#define BURST_PRE		CONFIG_APP_BURST_PRE_SAMPLES
+#define BURST_POST		CONFIG_APP_BURST_POST_SAMPLES
+#define RING_LEN		(BURST_PRE + 1 + BURST_POST)	/**< Pre + trigger + post. */
+
+LOG_MODULE_REGISTER(imu_burst);
+
+/** @brief On-flash sample; @c dt_us is relative to the trigger sample. */
+struct imu_burst_rec {
+	int32_t		dt_us;		/**< Offset from the trigger (negative: pre-trigger). */
+	int32_t		accel[3];	/**< Accelerometer X/Y/Z in µm/s^2. */
+	int32_t		gyro[3];	/**< Gyroscope X/Y/Z in µrad/s. */
+} __packed;
+
+/** @brief On-flash block header; followed by @c count x @ref imu_burst_rec. */
+struct imu_burst_hdr {
+	uint32_t	magic;		/**< @ref BURST_MAGIC. */
+	int64_t		t_trig_us;	/**< Uptime of the trigger sample. */
+	int32_t		thr;		/**< Trigger threshold in µm/s^2. */
+	uint16_t	pre;		/**< Records before the trigger sample. */
+	uint16_t	count;		/**< Records in the block (pre + 1 + post). */
+} __packed;
+
+/** @brief Ring slot: full timestamp, made relative when the block is cut. */
+struct ring_slot {
+	int64_t			ts_us;	/**< Uptime of the sample. */
+	struct imu_sample	s;	/**< Reading. */
+};
+
+static struct ring_slot		ring[RING_LEN];	/**< Producer-owned history. */
+static uint32_t			head;		/**< Next slot to write. */
+static uint32_t			fill;		/**< Valid slots (<= RING_LEN). */
+static uint32_t			post_left;	/**< Samples still to collect for the open burst. */
+static uint32_t			trig_pre;	/**< Pre-trigger samples available at the trigger. */
+static int64_t			trig_us;	/**< Trigger timestamp of the open burst. */
+
+static struct imu_burst_hdr	out_hdr;	/**< Block handed to the writer. */
+static struct imu_burst_rec	out[RING_LEN];
+
+static atomic_t			armed;		/**< Capture enabled. */
+static atomic_t			restart;	/**< Producer must drop ring state. */
+static atomic_t			flushing;	/**< @ref out owned by the writer. */
+static atomic_t			thr_um = ATOMIC_INIT(CONFIG_APP_BURST_THRESHOLD_MMS2 * 1000);	/**< Trigger level in µm/s^2. */
+static uint32_t			n_trig, n_blocks, n_missed, n_errors;	/**< Shell counters. */
+
+K_SEM_DEFINE(semBurst, 0, 1);	/**< Producer → writer: @ref out is ready. */
+
+/** @brief Squared magnitude in (mm/s^2)^2; mm keeps three int32 axes in range. */
+static inline int64_t accel_mag2(const struct imu_sample *s)
+{
+	int64_t m = 0;
+
+	for (int k = 0; k < 3; k++) {
+		int64_t a = s->accel[k] / 1000;
+
+		m += a * a;
+	}
+	return m;
+}
+
+/**
+ * @brief Copy the closed burst out of the ring and wake the writer.
+ *
+ * The newest @c trig_pre + 1 + @ref BURST_POST slots are the burst.
+ */
+static void hand_off(void)
+{
+	uint32_t count = trig_pre + 1U + BURST_POST;
+	uint32_t idx = (head + RING_LEN - count) % RING_LEN;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const struct ring_slot *r = &ring[idx];
+
+		out[i].dt_us = (int32_t)(r->ts_us - trig_us);
+		memcpy(out[i].accel, r->s.accel, sizeof(out[i].accel));
+		memcpy(out[i].gyro, r->s.gyro, sizeof(out[i].gyro));
+		idx = (idx + 1U) % RING_LEN;
+	}
+
+	out_hdr = (struct imu_burst_hdr){
+		.magic     = BURST_MAGIC,
+		.t_trig_us = trig_us,
+		.thr       = (int32_t)atomic_get(&thr_um),
+		.pre       = (uint16_t)trig_pre,
+		.count     = (uint16_t)count,
+	};
+	atomic_set(&flushing, 1);
+	k_sem_give(&semBurst);
+}
+
+void imu_burst_feed(const struct imu_sample *s)
+{
+	if (!atomic_get(&armed)) return;
+
+	if (atomic_cas(&restart, 1, 0)) {
+		head = fill = post_left = 0;
+	}
+
+	int64_t now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	ring[head].ts_us = now_us;
+	ring[head].s = *s;
+	head = (head + 1U) % RING_LEN;
+	fill = MIN(fill + 1U, (uint32_t)RING_LEN);
+
+	if (post_left > 0) {
+		if (--post_left == 0) hand_off();
+		return;
+	}
+
+	int64_t thr = atomic_get(&thr_um) / 1000;
+
+	if (accel_mag2(s) < thr * thr) return;
+
+	n_trig++;
+	if (atomic_get(&flushing)) {
+		/* previous block still being written; @ref out is busy */
+		n_missed++;
+		return;
+	}
+
+	trig_us = now_us;
+	trig_pre = MIN(fill - 1U, (uint32_t)BURST_PRE);
+	post_left = BURST_POST;
+	if (post_left == 0) hand_off();
+}
+
+/**
+ * @brief Append the block in @ref out to @ref BURST_PATH.
+ * @return 0 on success, negative errno otherwise.
+ */
+static int write_block(void)
+{
+	struct fs_file_t file;
+	int rc;
+
+	fs_file_t_init(&file);
+	rc = fs_open(&file, BURST_PATH, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (rc < 0) return rc;
+
+	rc = fs_write(&file, &out_hdr, sizeof(out_hdr));
+	if (rc >= 0) rc = fs_write(&file, out, (size_t)out_hdr.count * sizeof(out[0]));
+	fs_close(&file);
+	return (rc < 0) ? rc : 0;
+}
+
+/**
+ * @brief Writer thread: persist each handed-off burst, then release @ref out.
+ *
+ * @param a Unused.
+ * @param b Unused.
+ * @param c Unused.
+ */
+static void burst_thread(void *a, void *b, void *c)
+{
+	for (;;) {
+		k_sem_take(&semBurst, K_FOREVER);
+
+		int rc = write_block();
+
+		if (rc < 0) {
+			n_errors++;
+			LOG_ERR("burst write failed (%d)", rc);
+		} else {
+			n_blocks++;
+			LOG_INF("burst: %u samples (%u pre-trigger) -> %s",
+				out_hdr.count, out_hdr.pre, BURST_PATH);
+		}
+		atomic_set(&flushing, 0);
+	}
+}
+
+K_THREAD_DEFINE(burst_tid, 2048, burst_thread, NULL, NULL, NULL, 7, 0, 0);
+
+/**
+ * @brief Shell cmd: `sensors burst [on|off | thr <m/s^2>]`.
+ *
+ * Without arguments prints the settings and counters.
+ */
+static int cmd_burst(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 2 && (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0)) {
+		atomic_set(&restart, 1);
+		atomic_set(&armed, argv[1][1] == 'n');
+	} else if (argc == 3 && strcmp(argv[1], "thr") == 0) {
+		int32_t thr;
+
+		if (sensor_fixp_parse(argv[2], &thr) < 0 || thr <= 0) {
+			shell_error(sh, "usage: sensors burst [on|off | thr <m/s^2>]");
+			return -EINVAL;
+		}
+		atomic_set(&thr_um, thr);
+	} else if (argc != 1) {
+		shell_error(sh, "usage: sensors burst [on|off | thr <m/s^2>]");
+		return -EINVAL;
+	}
+
+	atomic_val_t thr = atomic_get(&thr_um);
+
+	shell_print(sh, "burst %s, |a| >= " SENSOR_FIXP_FMT " m/s^2, %d pre + %d post -> %s",
+		    atomic_get(&armed) ? "armed" : "off", SENSOR_FIXP_ARG(thr, 2),
+		    BURST_PRE, BURST_POST, BURST_PATH);
+	shell_print(sh, "triggers=%u blocks=%u missed=%u errors=%u",
+		    n_trig, n_blocks, n_missed, n_errors);
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((sensors), burst, NULL, "Triggered IMU burst capture", cmd_burst, 1, 2);
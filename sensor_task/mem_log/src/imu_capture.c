@@ -0,0 +1,239 @@
+
+/**
+ * @file
+ * @brief High-rate IMU capture: drains the LSM6DSL FIFO and logs sample blocks.
+ *
+ * A capture thread wakes a few times per second (often enough that the FIFO
+ * is at most half full at the selected ODR), drains every complete sample
+ * set from the FIFO and appends them to @ref FIFO_PATH in blocks of up to
+ * @ref DRAIN_MAX_SETS: a @ref imu_block_hdr followed by @c count raw sets.
+ * Sample @c i of a block was taken at @c t0_us + i * @c period_ns / 1000.
+ */
+
+#include "imu_fifo.h"
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------ config ------------ */
+#define FIFO_PATH		"/lfs/imu_fifo.bin"	/**< Block log file in LittleFS. */
+#define DRAIN_PERIOD_MS		200			/**< Longest FIFO drain interval. */
+#define DRAIN_MAX_SETS		128			/**< Sets per block. */
+#define FIFO_SETS		341			/**< 4 KiB FIFO / 12-byte set. */
+#define STOP_TIMEOUT		K_SECONDS(2)		/**< Longest wait for the thread to stop. */
+#define IMU_BLOCK_MAGIC		0x46554D49		/**< "IMUF" little-endian. */
+
+LOG_MODULE_REGISTER(imu_capture);
+
+/** @brief On-flash block header; followed by @c count x 6 int16 (Gxyz, Axyz). */
+struct imu_block_hdr {
+	uint32_t	magic;		/**< @ref IMU_BLOCK_MAGIC. */
+	int64_t		t0_us;		/**< Timestamp of the first set. */
+	uint32_t	period_ns;	/**< Sample spacing. */
+	uint32_t	accel_ug;	/**< Accelerometer µg per LSB. */
+	uint32_t	gyro_udps;	/**< Gyroscope µdps per LSB. */
+	uint16_t	count;		/**< Number of sets in the block. */
+	uint16_t	flags;		/**< Bit 0: FIFO overrun before this block. */
+} __packed;
+
+static struct k_thread		cap_thread_data;
+static K_THREAD_STACK_DEFINE(cap_stack, 2048);
+static k_tid_t			cap_tid;
+
+K_SEM_DEFINE(semCapStart, 0, 1);	/**< Shell → capture thread start. */
+K_SEM_DEFINE(semCapDone, 0, 1);		/**< Capture thread → shell: FIFO stopped. */
+static atomic_t			cap_running;	/**< Capture active. */
+static bool			cap_owned;	/**< Started, @ref semCapDone not yet taken (shell only). */
+static int64_t			cap_until_ms;	/**< Stop time (0: until `fifo stop`). */
+static uint32_t			cap_blocks, cap_sets, cap_overruns;
+
+static struct imu_fifo_sample	sets[DRAIN_MAX_SETS];
+static int16_t			raw[DRAIN_MAX_SETS][6];
+
+/**
+ * @brief Append one drained block to @ref FIFO_PATH.
+ * @param n		Number of sets in @ref sets.
+ * @param overrun	FIFO overflowed before this block.
+ * @return 0 on success, negative errno otherwise.
+ */
+static int write_block(int n, bool overrun)
+{
+	const struct imu_fifo_scale *sc = imu_fifo_get_scale();
+	struct imu_block_hdr hdr = {
+		.magic     = IMU_BLOCK_MAGIC,
+		.t0_us     = sets[0].ts_us,
+		.period_ns = (uint32_t)(1000000000000ULL / imu_fifo_odr_mhz()),
+		.accel_ug  = sc->accel_ug,
+		.gyro_udps = sc->gyro_udps,
+		.count     = (uint16_t)n,
+		.flags     = overrun ? BIT(0) : 0,
+	};
+	struct fs_file_t file;
+	int rc;
+
+	for (int i = 0; i < n; i++) {
+		memcpy(&raw[i][0], sets[i].gyro, sizeof(sets[i].gyro));
+		memcpy(&raw[i][3], sets[i].accel, sizeof(sets[i].accel));
+	}
+
+	fs_file_t_init(&file);
+	rc = fs_open(&file, FIFO_PATH, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (rc < 0) return rc;
+
+	rc = fs_write(&file, &hdr, sizeof(hdr));
+	if (rc >= 0) rc = fs_write(&file, raw, (size_t)n * sizeof(raw[0]));
+	fs_close(&file);
+	return (rc < 0) ? rc : 0;
+}
+
+/** @brief Drain interval: @ref DRAIN_PERIOD_MS, shorter when the FIFO would pass half full. */
+static int64_t drain_period_ms(void)
+{
+	int64_t half_ms = (int64_t)FIFO_SETS * 1000000 / 2 / imu_fifo_odr_mhz();
+
+	return MAX(MIN(half_ms, (int64_t)DRAIN_PERIOD_MS), 1);
+}
+
+/**
+ * @brief Capture thread: idle until started, then drain/log every drain_period_ms().
+ *
+ * Each wake-up drains until the FIFO holds less than one block. Signals
+ * @ref semCapDone once the FIFO is stopped, whether by `fifo stop` or by
+ * the time limit.
+ *
+ * @param a Unused.
+ * @param b Unused.
+ * @param c Unused.
+ */
+static void capture_thread(void *a, void *b, void *c)
+{
+	for (;;) {
+		k_sem_take(&semCapStart, K_FOREVER);
+
+		int64_t next = k_uptime_get();
+		int64_t period = drain_period_ms();
+
+		while (atomic_get(&cap_running)) {
+			bool overrun;
+			int n;
+
+			do {
+				n = imu_fifo_drain(sets, ARRAY_SIZE(sets), &overrun);
+				if (n < 0) {
+					LOG_ERR("drain failed (%d)", n);
+				} else if (n > 0) {
+					cap_overruns += overrun ? 1 : 0;
+					if (write_block(n, overrun) == 0) {
+						cap_blocks++;
+						cap_sets += n;
+					}
+				}
+			} while (n == (int)ARRAY_SIZE(sets) && atomic_get(&cap_running));
+
+			if (cap_until_ms && k_uptime_get() >= cap_until_ms) {
+				atomic_set(&cap_running, 0);
+				break;
+			}
+
+			next += period;
+			int64_t sleep_ms = next - k_uptime_get();
+			k_msleep(sleep_ms > 0 ? (int32_t)sleep_ms : 0);	/* `fifo stop` wakes it */
+		}
+
+		(void)imu_fifo_stop();
+		LOG_INF("capture done: %u blocks, %u sets, %u overruns", cap_blocks, cap_sets, cap_overruns);
+		k_sem_give(&semCapDone);
+	}
+}
+
+/**
+ * @brief Shell cmd: `sensors fifo start [odr_hz] [seconds]`.
+ */
+static int cmd_fifo_start(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t odr = (argc > 1) ? strtoul(argv[1], NULL, 10) : 416;
+	uint32_t secs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+
+	if (atomic_get(&cap_running)) {
+		shell_print(sh, "FIFO capture already running.");
+		return 0;
+	}
+	/* the last capture may still be stopping (time limit): let it finish */
+	if (cap_owned) {
+		if (k_sem_take(&semCapDone, STOP_TIMEOUT) < 0) {
+			shell_error(sh, "previous capture still stopping");
+			return -EBUSY;
+		}
+		cap_owned = false;
+	}
+
+	int rc = imu_fifo_start(odr);
+	if (rc < 0) {
+		shell_error(sh, "FIFO start failed (%d)", rc);
+		return rc;
+	}
+
+	if (!cap_tid) {
+		cap_tid = k_thread_create(&cap_thread_data, cap_stack,
+			K_THREAD_STACK_SIZEOF(cap_stack),
+			capture_thread, NULL, NULL, NULL, 5, 0, K_NO_WAIT);
+	}
+
+	cap_blocks = cap_sets = cap_overruns = 0;
+	cap_until_ms = secs ? k_uptime_get() + (int64_t)secs * 1000 : 0;
+	atomic_set(&cap_running, 1);
+	cap_owned = true;
+	k_sem_give(&semCapStart);
+
+	shell_print(sh, "FIFO capture at %u Hz -> %s", imu_fifo_odr_mhz() / 1000U, FIFO_PATH);
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `sensors fifo stop`; returns once the FIFO is stopped
+ *        and the IMU is back at its previous rate.
+ */
+static int cmd_fifo_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	if (!cap_owned) {
+		shell_print(sh, "FIFO capture not running.");
+		return 0;
+	}
+	atomic_set(&cap_running, 0);
+	k_wakeup(cap_tid);
+	if (k_sem_take(&semCapDone, STOP_TIMEOUT) < 0) {
+		shell_error(sh, "FIFO capture still stopping");
+		return -EBUSY;
+	}
+	cap_owned = false;
+	shell_print(sh, "FIFO capture stopped: %u blocks, %u sets, %u overruns.",
+		    cap_blocks, cap_sets, cap_overruns);
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `sensors fifo status`.
+ */
+static int cmd_fifo_status(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	shell_print(sh, "running=%d blocks=%u sets=%u overruns=%u",
+		(int)atomic_get(&cap_running), cap_blocks, cap_sets, cap_overruns);
+	return 0;
+}
+
+/** @brief `sensors fifo` subcommands. */
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_fifo,
+	SHELL_CMD_ARG(start,	NULL, "Start capture [odr_hz] [seconds]",	cmd_fifo_start, 1, 2),
+	SHELL_CMD(stop,		NULL, "Stop capture",				cmd_fifo_stop),
+	SHELL_CMD(status,	NULL, "Capture counters",			cmd_fifo_status),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((sensors), fifo, &sub_fifo, "LSM6DSL FIFO batch capture", NULL, 0, 0);
@@ -0,0 +1,220 @@
+
+/**
+ * @file
+ * @brief LSM6DSL FIFO configuration and burst drain (register level).
+ */
+
+#include "imu_fifo.h"
+
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdlib.h>
+
+/** @brief Register log module for the IMU FIFO. */
+LOG_MODULE_REGISTER(imu_fifo);
+
+/* ------------ LSM6DSL registers ------------ */
+#define REG_FIFO_CTRL3		0x08	/**< Gyro/accel FIFO decimation. */
+#define REG_FIFO_CTRL5		0x0A	/**< FIFO ODR and mode. */
+#define REG_CTRL1_XL		0x10	/**< Accel ODR / full scale. */
+#define REG_CTRL2_G		0x11	/**< Gyro ODR / full scale. */
+#define REG_FIFO_STATUS1	0x3A	/**< DIFF_FIFO[7:0] (unread words). */
+#define REG_FIFO_DATA_OUT_L	0x3E	/**< FIFO output; rolls back to itself on burst reads. */
+
+#define FIFO_MODE_BYPASS	0x00
+#define FIFO_MODE_CONTINUOUS	0x06
+#define FIFO_NO_DECIMATION	0x09	/**< DEC_FIFO_GYRO=1, DEC_FIFO_XL=1. */
+#define FIFO_STATUS2_OVER_RUN	BIT(6)
+
+#define WORDS_PER_SET		6	/**< Gx Gy Gz Ax Ay Az. */
+#define SETS_PER_READ		32	/**< Sets per I2C burst (384 bytes). */
+
+/** @brief I2C bus/address of the IMU. */
+static const struct i2c_dt_spec imu_i2c = I2C_DT_SPEC_GET(DT_ALIAS(imu_sensor));
+
+/** @brief Supported ODRs in mHz; index + 1 is the register code. */
+static const uint32_t odr_mhz_tbl[] = {
+	12500, 26000, 52000, 104000, 208000, 416000, 833000, 1666000,
+};
+
+/** @brief Accel µg/LSB indexed by FS_XL[1:0] (±2, ±16, ±4, ±8 g). */
+static const uint32_t accel_ug_tbl[] = { 61, 488, 122, 244 };
+
+/** @brief Gyro µdps/LSB indexed by FS_G[1:0] (245, 500, 1000, 2000 dps). */
+static const uint32_t gyro_udps_tbl[] = { 8750, 17500, 35000, 70000 };
+
+static struct imu_fifo_scale	scale;		/**< Scale of the running capture. */
+static uint32_t			odr_mhz;	/**< Selected ODR. */
+static int64_t			last_ts_ns;	/**< Timestamp of the last drained set. */
+static bool			have_last;	/**< @ref last_ts_ns is valid. */
+static uint8_t			saved_ctrl1;	/**< CTRL1_XL before the capture. */
+static uint8_t			saved_ctrl2;	/**< CTRL2_G before the capture. */
+static bool			saved;		/**< Capture running, @ref saved_ctrl1 / @ref saved_ctrl2 valid. */
+
+/** @brief Sample period in ns at the selected ODR. */
+static inline int64_t period_ns(void)
+{
+	return (int64_t)1000000000000 / odr_mhz;
+}
+
+int imu_fifo_start(uint32_t odr_hz)
+{
+	uint8_t code = 1, ctrl1, ctrl2;
+	int rc;
+
+	if (!device_is_ready(imu_i2c.bus)) return -ENODEV;
+
+	/* nearest supported rate */
+	for (uint8_t i = 0; i < ARRAY_SIZE(odr_mhz_tbl); i++) {
+		if (odr_hz * 1000U >= odr_mhz_tbl[i] * 3U / 4U) {
+			code = i + 1;
+		}
+	}
+	odr_mhz = odr_mhz_tbl[code - 1];
+
+	rc = i2c_reg_read_byte_dt(&imu_i2c, REG_CTRL1_XL, &ctrl1);
+	if (rc == 0) rc = i2c_reg_read_byte_dt(&imu_i2c, REG_CTRL2_G, &ctrl2);
+	if (rc < 0) return rc;
+
+	/* rates of the normal cycle, put back by imu_fifo_stop() */
+	if (!saved) {
+		saved_ctrl1 = ctrl1;
+		saved_ctrl2 = ctrl2;
+		saved = true;
+	}
+
+	/* keep the driver's full-scale choice, only change the rate */
+	scale.accel_ug = accel_ug_tbl[(ctrl1 >> 2) & 0x3];
+	scale.gyro_udps = (ctrl2 & BIT(1)) ? 4375 : gyro_udps_tbl[(ctrl2 >> 2) & 0x3];
+
+	/* bypass first: empties the FIFO */
+	rc = i2c_reg_write_byte_dt(&imu_i2c, REG_FIFO_CTRL5, FIFO_MODE_BYPASS);
+	if (rc == 0) rc = i2c_reg_write_byte_dt(&imu_i2c, REG_CTRL1_XL, (code << 4) | (ctrl1 & 0x0F));
+	if (rc == 0) rc = i2c_reg_write_byte_dt(&imu_i2c, REG_CTRL2_G, (code << 4) | (ctrl2 & 0x0F));
+	if (rc == 0) rc = i2c_reg_write_byte_dt(&imu_i2c, REG_FIFO_CTRL3, FIFO_NO_DECIMATION);
+	if (rc == 0) rc = i2c_reg_write_byte_dt(&imu_i2c, REG_FIFO_CTRL5,
+						(code << 3) | FIFO_MODE_CONTINUOUS);
+	if (rc < 0) {
+		LOG_ERR("FIFO setup failed (%d)", rc);
+		return rc;
+	}
+
+	have_last = false;
+	LOG_INF("FIFO running at %u.%03u Hz", odr_mhz / 1000U, odr_mhz % 1000U);
+	return 0;
+}
+
+int imu_fifo_stop(void)
+{
+	int rc = i2c_reg_write_byte_dt(&imu_i2c, REG_FIFO_CTRL5, FIFO_MODE_BYPASS);
+
+	if (rc == 0 && saved) {
+		rc = i2c_reg_write_byte_dt(&imu_i2c, REG_CTRL1_XL, saved_ctrl1);
+		if (rc == 0) rc = i2c_reg_write_byte_dt(&imu_i2c, REG_CTRL2_G, saved_ctrl2);
+		if (rc == 0) saved = false;
+	}
+	return rc;
+}
+
+/**
+ * @brief Discard words until the next read starts at a set boundary (gyro X).
+ *
+ * @param pattern Current FIFO pattern index (0 = gyro X).
+ * @retval Number of words discarded, or negative errno.
+ */
+static int align_to_set(uint16_t pattern)
+{
+	uint8_t junk[2 * WORDS_PER_SET];
+	uint16_t skip = (WORDS_PER_SET - (pattern % WORDS_PER_SET)) % WORDS_PER_SET;
+
+	if (skip == 0U) return 0;
+
+	int rc = i2c_burst_read_dt(&imu_i2c, REG_FIFO_DATA_OUT_L, junk, skip * 2U);
+	return (rc < 0) ? rc : skip;
+}
+
+int imu_fifo_drain(struct imu_fifo_sample *out, size_t max, bool *overrun)
+{
+	uint8_t st[4];
+	uint8_t raw[SETS_PER_READ * WORDS_PER_SET * 2];
+	int rc;
+
+	*overrun = false;
+
+	rc = i2c_burst_read_dt(&imu_i2c, REG_FIFO_STATUS1, st, sizeof(st));
+	if (rc < 0) return rc;
+
+	uint16_t words = st[0] | ((st[1] & 0x07) << 8);
+	uint16_t pattern = st[2] | ((st[3] & 0x03) << 8);
+	int64_t now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	*overrun = (st[1] & FIFO_STATUS2_OVER_RUN) != 0;
+
+	rc = align_to_set(pattern);
+	if (rc < 0) return rc;
+	words = (words > rc) ? words - rc : 0;
+
+	size_t sets = MIN((size_t)(words / WORDS_PER_SET), max);
+	size_t done = 0;
+
+	while (done < sets) {
+		size_t n = MIN(sets - done, (size_t)SETS_PER_READ);
+
+		rc = i2c_burst_read_dt(&imu_i2c, REG_FIFO_DATA_OUT_L, raw, n * WORDS_PER_SET * 2);
+		if (rc < 0) return rc;
+
+		for (size_t i = 0; i < n; i++) {
+			const uint8_t *p = &raw[i * WORDS_PER_SET * 2];
+			struct imu_fifo_sample *s = &out[done + i];
+
+			for (int k = 0; k < 3; k++) {
+				s->gyro[k]  = (int16_t)sys_get_le16(&p[2 * k]);
+				s->accel[k] = (int16_t)sys_get_le16(&p[6 + 2 * k]);
+			}
+		}
+		done += n;
+	}
+
+	if (sets == 0) return 0;
+
+	/*
+	 * Timestamps: continue the previous burst one period at a time so the
+	 * series stays evenly spaced; re-anchor to "newest sample = now" after
+	 * an overrun or if the continuation drifted by more than half a burst.
+	 */
+	int64_t per = period_ns();
+	int64_t anchored = now_us * 1000 - (int64_t)(sets - 1) * per;
+	int64_t t0 = have_last ? last_ts_ns + per : anchored;
+
+	if (*overrun || !have_last || llabs(t0 - anchored) > (int64_t)sets * per / 2) {
+		t0 = anchored;
+	}
+	for (size_t i = 0; i < sets; i++) {
+		out[i].ts_us = (t0 + (int64_t)i * per) / 1000;
+	}
+	last_ts_ns = t0 + (int64_t)(sets - 1) * per;
+	have_last = true;
+
+	return (int)sets;
+}
+
+uint32_t imu_fifo_odr_mhz(void)
+{
+	return odr_mhz;
+}
+
+const struct imu_fifo_scale *imu_fifo_get_scale(void)
+{
+	return &scale;
+}
+
+void imu_fifo_to_sample(const struct imu_fifo_sample *in, struct imu_sample *out)
+{
+	for (int k = 0; k < 3; k++) {
+		/* µg → µm/s^2 (g = 9.80665 m/s^2) */
+		out->accel[k] = (int32_t)((int64_t)in->accel[k] * scale.accel_ug * 980665 / 100000);
+		/* µdps → µrad/s (pi/180 = 0.017453293) */
+		out->gyro[k] = (int32_t)((int64_t)in->gyro[k] * scale.gyro_udps * 17453293 / 1000000000);
+	}
+}
@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief IMU orientation stage: complementary filter at the IMU rate, bench.
+ *
+ * The filter runs inline in the IMU producer (its cost per sample is what
+ * `sensors orient bench` reports), so its rate is whatever the cycle or the
+ * DRDY interrupt delivers. A gap of more than @ref GAP_US between two
+ * samples (cycle stopped or paused) reseeds roll/pitch from gravity instead
+ * of integrating over the gap.
+ */
+
+#include "imu_fusion.h"
+#include "sensor_fusion.h"
+#include "sensor_cordic.h"
+#include "sensor_fixp.h"
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------ config ------------ */
+#define ALPHA_Q15	((CONFIG_APP_FUSION_ALPHA_PERMILLE * 32768) / 1000)	/**< Gyro weight. */
+#define GAP_US		1000000		/**< Longest sample gap integrated. */
+#define BENCH_HZ	100		/**< Synthetic sample rate. */
+#define BENCH_RATE	1570796		/**< Synthetic roll rate, µrad/s (90 deg/s). */
+
+static struct sensor_fusion	filt;		/**< Producer-owned filter. */
+static int64_t			last_us;	/**< Timestamp of the previous sample. */
+static atomic_t			reseed = ATOMIC_INIT(1);	/**< Shell → producer: reset. */
+
+static struct k_spinlock	pub_lock;	/**< Guards @ref pub. */
+static struct sensor_fusion	pub;		/**< Copy of @ref filt for readers. */
+
+void imu_fusion_feed(const struct imu_sample *s)
+{
+	int64_t now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+	int64_t dt = now_us - last_us;
+
+	last_us = now_us;
+	if (atomic_cas(&reseed, 1, 0) || dt <= 0 || dt > GAP_US) {
+		sensor_fusion_init(&filt, ALPHA_Q15);
+	}
+	sensor_fusion_update(&filt, s->accel, s->gyro, (uint32_t)dt);
+
+	k_spinlock_key_t key = k_spin_lock(&pub_lock);
+	pub = filt;
+	k_spin_unlock(&pub_lock, key);
+}
+
+/** @brief µrad → micro-degrees. */
+static inline int32_t urad_to_udeg(int32_t v)
+{
+	return (int32_t)((int64_t)v * 180000000 / SENSOR_CORDIC_PI);
+}
+
+bool imu_fusion_get_rpy(int32_t rpy[3])
+{
+	k_spinlock_key_t key = k_spin_lock(&pub_lock);
+	struct sensor_fusion f = pub;
+	k_spin_unlock(&pub_lock, key);
+
+	rpy[0] = urad_to_udeg(f.roll);
+	rpy[1] = urad_to_udeg(f.pitch);
+	rpy[2] = urad_to_udeg(f.yaw);
+	return f.valid;
+}
+
+/**
+ * @brief Shell cmd: `sensors orient` - latest roll/pitch/yaw and quaternion.
+ */
+static int cmd_orient_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	k_spinlock_key_t key = k_spin_lock(&pub_lock);
+	struct sensor_fusion f = pub;
+	k_spin_unlock(&pub_lock, key);
+
+	if (!f.valid) {
+		shell_print(sh, "no IMU samples yet");
+		return 0;
+	}
+
+	int32_t q[4];
+
+	sensor_fusion_quat(&f, q);
+	shell_print(sh, "RPY=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ") deg, "
+		    "%u gated, alpha %d/1000",
+		    SENSOR_FIXP_ARG(urad_to_udeg(f.roll), 2), SENSOR_FIXP_ARG(urad_to_udeg(f.pitch), 2),
+		    SENSOR_FIXP_ARG(urad_to_udeg(f.yaw), 2), f.gated, CONFIG_APP_FUSION_ALPHA_PERMILLE);
+	/* Q30 → micro-units for printing */
+	shell_print(sh, "q=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ","
+		    SENSOR_FIXP_FMT ")",
+		    SENSOR_FIXP_ARG((int32_t)(((int64_t)q[0] * 1000000) >> 30), 4),
+		    SENSOR_FIXP_ARG((int32_t)(((int64_t)q[1] * 1000000) >> 30), 4),
+		    SENSOR_FIXP_ARG((int32_t)(((int64_t)q[2] * 1000000) >> 30), 4),
+		    SENSOR_FIXP_ARG((int32_t)(((int64_t)q[3] * 1000000) >> 30), 4));
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `sensors orient reset` - reseed from gravity, yaw = 0.
+ */
+static int cmd_orient_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	atomic_set(&reseed, 1);
+	shell_print(sh, "orientation reset on next IMU sample");
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `sensors orient bench [n]`.
+ *
+ * Runs @p n updates (default 1000) of a private filter on a synthetic roll
+ * at 90 deg/s sampled at @ref BENCH_HZ, timing only the filter update, and
+ * prints cycles per update plus the tracking error at the end.
+ */
+static int cmd_orient_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000;
+	struct sensor_fusion f;
+	int32_t gyro[3] = { BENCH_RATE, 0, 0 };
+	int32_t accel[3] = { 0, 0, SENSOR_FUSION_G };
+	int64_t truth = 0;
+	uint64_t sum = 0;
+	uint32_t best = UINT32_MAX;
+
+	if (n == 0) return -EINVAL;
+
+	sensor_fusion_init(&f, ALPHA_Q15);
+	for (uint32_t i = 0; i < n; i++) {
+		int32_t s, c;
+
+		sensor_cordic_sincos(sensor_cordic_wrap(truth), &s, &c);
+		accel[1] = (int32_t)(((int64_t)s * SENSOR_FUSION_G) >> 30);
+		accel[2] = (int32_t)(((int64_t)c * SENSOR_FUSION_G) >> 30);
+
+		uint32_t t0 = k_cycle_get_32();
+
+		sensor_fusion_update(&f, accel, gyro, 1000000 / BENCH_HZ);
+
+		uint32_t dt = k_cycle_get_32() - t0;
+
+		sum += dt;
+		best = MIN(best, dt);
+		truth += BENCH_RATE / BENCH_HZ;
+	}
+
+	int32_t err = sensor_cordic_wrap((int64_t)f.roll - sensor_cordic_wrap(truth - BENCH_RATE / BENCH_HZ));
+
+	shell_print(sh, "%u updates: avg %u cyc (%u us), min %u cyc; roll error " SENSOR_FIXP_FMT " deg",
+		    n, (uint32_t)(sum / n), k_cyc_to_us_floor32((uint32_t)(sum / n)), best,
+		    SENSOR_FIXP_ARG(urad_to_udeg(err), 3));
+	return 0;
+}
+
+/** @brief `sensors orient` subcommands. */
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_orient,
+	SHELL_CMD(reset,	NULL, "Reseed from gravity, zero yaw",		cmd_orient_reset),
+	SHELL_CMD_ARG(bench,	NULL, "Cycles per filter update [n]",		cmd_orient_bench, 1, 1),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((sensors), orient, &sub_orient, "IMU orientation (complementary filter)",
+		 cmd_orient_show, 1, 0);
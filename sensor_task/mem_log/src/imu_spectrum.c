@@ -0,0 +1,263 @@
+/**
+ * @file
+ * @brief IMU vibration spectrum stage: block collection, FFT features, bench.
+ *
+ * The IMU producer fills one of two accelerometer blocks; a full block is
+ * handed to the analysis thread while the producer continues in the other
+ * one. If the analysis of the previous block is still running when the
+ * next block fills, that block is dropped (counted) instead of stalling the
+ * sensor cycle. The sample rate of each block is measured from its first and
+ * last timestamp, so the same code serves the timer-clocked and DRDY modes.
+ */
+
+#include "imu_spectrum.h"
+#include "sensor_spectrum.h"
+#include "sensor_fixp.h"
+#include "pipeline_stats.h"
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------ config ------------ */
+#define SPEC_PATH	"/lfs/imu_spec.csv"				/**< Feature log in LittleFS. */
+#define SPEC_N		CONFIG_APP_SPECTRUM_POINTS			/**< Samples per block. */
+#define SPEC_FS_UM	(CONFIG_APP_SPECTRUM_FULL_SCALE_MMS2 * 1000)	/**< Q15 full scale, µm/s^2. */
+#define BENCH_RUNS	16						/**< Blocks per bench. */
+
+LOG_MODULE_REGISTER(imu_spectrum);
+
+SENSOR_SPECTRUM_DEFINE(spec, SPEC_N);
+K_MUTEX_DEFINE(spec_lock);	/**< Serializes @ref spec between analysis and bench. */
+
+static int32_t		blk[2][SPEC_N][3];	/**< Accelerometer X/Y/Z blocks, µm/s^2. */
+static int64_t		blk_t0[2], blk_t1[2];	/**< First/last sample uptime, µs. */
+static uint32_t		cur;			/**< Block being filled (producer). */
+static uint32_t		pos;			/**< Samples in @ref cur. */
+static uint32_t		ready = 1;		/**< Block owned by analysis/bench. */
+static atomic_t		busy;			/**< @ref ready in use; producer drops blocks. */
+static uint32_t		n_blocks, n_dropped;	/**< Shell counters. */
+
+static struct k_spinlock		res_lock;	/**< Guards @ref res and @ref res_fs_mhz. */
+static struct sensor_spectrum_result	res;		/**< Features of the latest block. */
+static uint32_t				res_fs_mhz;	/**< Sample rate of that block. */
+
+K_SEM_DEFINE(semSpec, 0, 1);	/**< Producer → analysis: @ref ready is full. */
+
+void imu_spectrum_feed(const struct imu_sample *s)
+{
+	int64_t now_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	if (pos == 0) blk_t0[cur] = now_us;
+	memcpy(blk[cur][pos], s->accel, sizeof(blk[cur][pos]));
+	if (++pos < SPEC_N) return;
+
+	blk_t1[cur] = now_us;
+	pos = 0;
+	/* claim @ref ready before swapping: the bench claims it the same way */
+	if (!atomic_cas(&busy, 0, 1)) {
+		/* analysis or bench lags: refill the same block */
+		n_dropped++;
+		return;
+	}
+	ready = cur;
+	cur ^= 1U;
+	k_sem_give(&semSpec);
+}
+
+/**
+ * @brief Run the three accelerometer axes of @p b through @ref spec.
+ *
+ * @param b   Block, @c SPEC_N x XYZ micro-units.
+ * @param fs  Sample rate in mHz.
+ * @param out Destination.
+ */
+static void analyse(const int32_t (*b)[3], uint32_t fs, struct sensor_spectrum_result *out)
+{
+	k_mutex_lock(&spec_lock, K_FOREVER);
+	sensor_spectrum_clear(&spec);
+	for (int k = 0; k < 3; k++) {
+		sensor_spectrum_add(&spec, &b[0][k], 3, SPEC_FS_UM);
+	}
+	sensor_spectrum_features(&spec, fs, out);
+	k_mutex_unlock(&spec_lock);
+}
+
+/**
+ * @brief Append one feature row to @ref SPEC_PATH.
+ *
+ * Columns: uptime ms, fs Hz, peak Hz, total power, then the band shares (‰).
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+static int append_row(int64_t t_ms, uint32_t fs, const struct sensor_spectrum_result *r)
+{
+	char line[160];
+	int n = snprintk(line, sizeof(line), "%lld,%u.%03u,%u.%03u,%llu", t_ms,
+			 fs / 1000U, fs % 1000U, r->peak_mhz / 1000U, r->peak_mhz % 1000U,
+			 (unsigned long long)r->total);
+
+	for (int b = 0; b < SENSOR_SPECTRUM_BANDS; b++) {
+		n += snprintk(line + n, sizeof(line) - n, ",%u", r->band_pm[b]);
+	}
+	n += snprintk(line + n, sizeof(line) - n, "\n");
+
+	struct fs_file_t file;
+	int rc;
+
+	fs_file_t_init(&file);
+	rc = fs_open(&file, SPEC_PATH, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (rc < 0) return rc;
+
+	rc = fs_write(&file, line, n);
+	fs_close(&file);
+	return (rc < 0) ? rc : 0;
+}
+
+/**
+ * @brief Analysis thread: features of each handed-off block.
+ *
+ * @param a Unused.
+ * @param b Unused.
+ * @param c Unused.
+ */
+static void spectrum_thread(void *a, void *b, void *c)
+{
+	if (sensor_spectrum_init(&spec) < 0) {
+		LOG_ERR("unsupported FFT length %d", SPEC_N);
+		return;
+	}
+
+	for (;;) {
+		k_sem_take(&semSpec, K_FOREVER);
+
+		int64_t span_us = blk_t1[ready] - blk_t0[ready];
+		uint32_t fs = (span_us > 0) ?
+			(uint32_t)((int64_t)(SPEC_N - 1) * 1000000000LL / span_us) : 0;
+		struct sensor_spectrum_result r;
+		uint32_t t0 = pstat_begin();
+
+		analyse(blk[ready], fs, &r);
+		pstat_end(PSTAGE_SPECTRUM, t0);
+		atomic_set(&busy, 0);
+
+		k_spinlock_key_t key = k_spin_lock(&res_lock);
+		res = r;
+		res_fs_mhz = fs;
+		k_spin_unlock(&res_lock, key);
+		n_blocks++;
+
+		LOG_INF("fs %u.%03u Hz peak %u.%03u Hz",
+			fs / 1000U, fs % 1000U, r.peak_mhz / 1000U, r.peak_mhz % 1000U);
+		int rc = append_row(k_uptime_get(), fs, &r);
+		if (rc < 0) LOG_ERR("feature write failed (%d)", rc);
+	}
+}
+
+K_THREAD_DEFINE(spec_tid, 2048, spectrum_thread, NULL, NULL, NULL, 8, 0, 0);
+
+/**
+ * @brief Print a feature set.
+ */
+static void print_result(const struct shell *sh, uint32_t fs, const struct sensor_spectrum_result *r)
+{
+	shell_print(sh, "fs=%u.%03u Hz peak=%u.%03u Hz (bin %u mHz) total=%llu",
+		    fs / 1000U, fs % 1000U, r->peak_mhz / 1000U, r->peak_mhz % 1000U,
+		    fs / SPEC_N, (unsigned long long)r->total);
+	for (int b = 0; b < SENSOR_SPECTRUM_BANDS; b++) {
+		uint32_t lo = (uint32_t)((uint64_t)fs * b / (2 * SENSOR_SPECTRUM_BANDS));
+		uint32_t hi = (uint32_t)((uint64_t)fs * (b + 1) / (2 * SENSOR_SPECTRUM_BANDS));
+
+		shell_print(sh, "  %4u-%4u Hz %4u", lo / 1000U, hi / 1000U, r->band_pm[b]);
+	}
+}
+
+/**
+ * @brief Shell cmd: `sensors fft` - features of the latest block.
+ */
+static int cmd_fft_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	struct sensor_spectrum_result r;
+	uint32_t fs;
+
+	k_spinlock_key_t key = k_spin_lock(&res_lock);
+	r = res;
+	fs = res_fs_mhz;
+	k_spin_unlock(&res_lock, key);
+
+	shell_print(sh, "%d-point blocks: %u analysed, %u dropped, %u/%d filling",
+		    SPEC_N, n_blocks, n_dropped, pos, SPEC_N);
+	if (n_blocks) print_result(sh, fs, &r);
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: `sensors fft bench [tone_hz] [fs_hz]`.
+ *
+ * Feeds a synthetic three-axis block (1 g on Z, a tone of 2 m/s^2 on X and
+ * Y plus a 0.5 m/s^2 third harmonic on X) through the same kernel as the
+ * stage, @ref BENCH_RUNS times, and prints cycles per block and per sample
+ * with the detected peak. Claims the analysis block, so blocks filled by a
+ * running sensor cycle meanwhile are dropped.
+ */
+static int cmd_fft_bench(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t tone = (argc > 1) ? strtoul(argv[1], NULL, 10) : 50;
+	uint32_t fs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 416;
+	struct sensor_spectrum_result r;
+
+	if (fs == 0 || tone == 0 || 2 * tone >= fs) {
+		shell_error(sh, "need 0 < tone_hz < fs_hz / 2");
+		return -EINVAL;
+	}
+	if (!atomic_cas(&busy, 0, 1)) {
+		shell_error(sh, "analysis in progress, retry");
+		return -EBUSY;
+	}
+
+	int32_t (*b)[3] = blk[ready];
+
+	/* arm_sin_q15 maps [0, 1) in Q15 to [0, 2 pi) */
+	for (uint32_t i = 0; i < SPEC_N; i++) {
+		q15_t p1 = (q15_t)(((uint64_t)i * tone * 32768U / fs) & 0x7FFF);
+		q15_t p3 = (q15_t)(((uint64_t)i * 3U * tone * 32768U / fs) & 0x7FFF);
+		int32_t s1 = arm_sin_q15(p1), s3 = arm_sin_q15(p3);
+
+		/* 64-bit: a Q15 sine times 2e6 µm/s^2 does not fit int32 */
+		b[i][0] = (int32_t)(((int64_t)s1 * 2000000 + (int64_t)s3 * 500000) / 32768);
+		b[i][1] = (int32_t)((int64_t)s1 * 2000000 / 32768);
+		b[i][2] = 9806650;
+	}
+
+	uint32_t best = UINT32_MAX, sum = 0;
+
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		uint32_t t0 = k_cycle_get_32();
+
+		analyse(b, fs * 1000U, &r);
+
+		uint32_t dt = k_cycle_get_32() - t0;
+
+		sum += dt;
+		best = MIN(best, dt);
+	}
+	atomic_set(&busy, 0);
+
+	shell_print(sh, "%d-point x3 axes: avg %u cyc (%u us), min %u cyc, %u cyc/sample",
+		    SPEC_N, sum / BENCH_RUNS, k_cyc_to_us_floor32(sum / BENCH_RUNS),
+		    best, best / SPEC_N);
+	print_result(sh, fs * 1000U, &r);
+	return 0;
+}
+
+/** @brief `sensors fft` subcommands. */
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_fft,
+	SHELL_CMD_ARG(bench,	NULL, "Time the FFT stage [tone_hz] [fs_hz]",	cmd_fft_bench, 1, 2),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((sensors), fft, &sub_fft, "IMU vibration spectrum", cmd_fft_show, 1, 0);
@@ -8,7 +8,7 @@ LOG_MODULE_REGISTER(main);
 /**
  * @brief Main entry point of the Sensor Shell Logging Demo.
  *
- * - Initializes on-board sensors (HTS221, LPS22HB, LSM6DSL).  
+ * - Checks the sensors of the table in htpg_sensors.h (HTS221, LPS22HB, LSM6DSL).  
  * - Mounts LittleFS filesystem on the designated flash partition.  
  * - After setup, shell commands (`start_sensors`, `stop_sensors`, `clear_logs`)  
  *   can be used to control periodic sensor logging.  
@@ -24,9 +24,7 @@ int main(void)
 {
 	LOG_INF("Sensor shell logging demo starting...");
 
-	hum_temp_sensor_init();
-	pressure_sensor_init();
-	imu_sensor_init();
+	(void)htpg_sensors_init();
 
 	mount_sens();
 
@@ -0,0 +1,87 @@
+
+/**
+ * @file
+ * @brief Stage latency table of the mem_log pipeline and `sensors stats`.
+ */
+
+#include "pipeline_stats.h"
+#include "sensor_stat.h"
+#include <zephyr/shell/shell.h>
+#include <string.h>
+
+/** @brief One accumulator per stage, indexed by @ref pipe_stage. */
+static struct sensor_stat stats[PSTAGE_COUNT] = {
+	[PSTAGE_HT_READ]	= SENSOR_STAT_INIT("ht_read"),
+	[PSTAGE_PRESS_READ]	= SENSOR_STAT_INIT("press_read"),
+	[PSTAGE_IMU_READ]	= SENSOR_STAT_INIT("imu_read"),
+	[PSTAGE_ASYNC_BATCH]	= SENSOR_STAT_INIT("async_batch"),
+	[PSTAGE_SNAPSHOT]	= SENSOR_STAT_INIT("snapshot"),
+	[PSTAGE_FORMAT]		= SENSOR_STAT_INIT("format"),
+	[PSTAGE_FS_APPEND]	= SENSOR_STAT_INIT("fs_append"),
+	[PSTAGE_CYCLE]		= SENSOR_STAT_INIT("cycle"),
+	[PSTAGE_SPECTRUM]	= SENSOR_STAT_INIT("spectrum"),
+};
+
+void pstat_record(enum pipe_stage stage, uint32_t cycles)
+{
+	sensor_stat_record(&stats[stage], cycles);
+}
+
+/**
+ * @brief Print one stage: summary line, then its non-empty histogram buckets.
+ * @param sh	Shell instance.
+ * @param s	Copy of the stage statistics.
+ */
+static void print_stage(const struct shell *sh, const struct sensor_stat *s)
+{
+	shell_print(sh, "%-12s %8u %8u %8u %8u", s->name, s->count,
+		    sensor_stat_cyc_to_us(s->min),
+		    sensor_stat_cyc_to_us(s->sum / s->count),
+		    sensor_stat_cyc_to_us(s->max));
+
+	for (int b = 0; b < SENSOR_STAT_BUCKETS; b++) {
+		if (s->hist[b] == 0) continue;
+
+		shell_print(sh, "    [%7u, %7u) us %8u",
+			    sensor_stat_cyc_to_us(b ? BIT64(b) : 0),
+			    sensor_stat_cyc_to_us(BIT64(b + 1)), s->hist[b]);
+	}
+}
+
+/**
+ * @brief Shell cmd: dump (`stats`) or clear (`stats reset`) the stage table.
+ *
+ * Durations are in microseconds; histogram buckets are powers of two in
+ * cycles, shown with their µs bounds.
+ *
+ * @param sh	Shell instance.
+ * @param argc	1 or 2.
+ * @param argv	Optional "reset".
+ * @return 0 on success, -EINVAL on unknown argument.
+ */
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "usage: sensors stats [reset]");
+			return -EINVAL;
+		}
+		for (int i = 0; i < PSTAGE_COUNT; i++) {
+			sensor_stat_reset(&stats[i]);
+		}
+		shell_print(sh, "stats cleared");
+		return 0;
+	}
+
+	shell_print(sh, "%-12s %8s %8s %8s %8s", "stage", "count", "min_us", "avg_us", "max_us");
+	for (int i = 0; i < PSTAGE_COUNT; i++) {
+		struct sensor_stat s;
+
+		sensor_stat_get(&stats[i], &s);
+		if (s.count == 0) continue;
+		print_stage(sh, &s);
+	}
+	return 0;
+}
+
+SHELL_SUBCMD_ADD((sensors), stats, NULL, "Stage latency stats [reset]", cmd_stats, 1, 1);
@@ -3,11 +3,39 @@
  * @file
  * @brief Shell-driven periodic sensor logger (HT, Pressure, IMU) with tickless scheduling.
  *
- * Workers only update a shared snapshot under mutex; the coordinator triggers the
- * chain HT→PRESS→IMU, then writes a single compact line to LittleFS each period.
+ * Workers only publish into a shared seqlock-protected snapshot. The coordinator
+ * is a multi-rate scheduler driven by one drift-free @c k_timer tick (the GCD
+ * of the per-sensor periods): on every tick only the sensors that are due are
+ * triggered (one after another on the shared bus) before a single compact row
+ * with per-channel validity is appended to the log, as a binary record
+ * (sensor_rec.h, @c CONFIG_APP_LOG_BINARY, packed with sensor_pack.h under
+ * @c CONFIG_APP_LOG_PACK) or a text line. The log file stays open
+ * behind a RAM buffer (sensor_sink.h) that is committed when full, after
+ * @c CONFIG_APP_LOG_FLUSH_MS, and on stop/pause/clear; the log is split into
+ * segments of @c CONFIG_APP_LOG_SEG_SIZE, the oldest removed beyond
+ * @c CONFIG_APP_LOG_BUDGET.
+ * All sensors are read by one worker thread woken through a @c k_event, one
+ * bit per sensor of the table in htpg_sensors.h, so adding a sensor adds no
+ * thread or stack.
+ * With @c CONFIG_APP_SENSOR_ASYNC the worker triggers are replaced by one batched RTIO read
+ * issued from the coordinator, and the worker thread is not created. With
+ * @c CONFIG_APP_SENSOR_DRDY the HT and IMU reads are woken by the sensors'
+ * data-ready interrupts instead. With @c CONFIG_APP_EXECUTOR_WORKQ the
+ * coordinator and the reads are not threads but @c k_work items chained on
+ * one dedicated work queue.
  */
 
 #include "shell_threads.h"
+#include "sensor_seqlock.h"
+#include "sensor_period.h"
+#include "pipeline_stats.h"
+#include "sensor_agg.h"
+#include "sensor_sink.h"
+#include "sensor_rec.h"
+#include "sensor_pack.h"
+#include "imu_burst.h"
+#include "imu_spectrum.h"
+#include "imu_fusion.h"
 #include <zephyr/kernel.h>
 #include <zephyr/fs/fs.h>
 #include <zephyr/fs/littlefs.h>
@@ -15,44 +43,100 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/shell/shell.h>
 #include <string.h>
+#include <stdlib.h>
+#include <errno.h>
 
 /* ------------ config ------------ */
-#define LOG_PERIOD_MS		6000		/**< Logging period in milliseconds (set 60000 for 60 s). */
-#define SENSOR_PATH		"/lfs/sensor.txt"	/**< Log file path in LittleFS. */
+#define MIN_PERIOD_MS		10		/**< Fastest accepted per-sensor period (and tick). */
+#if defined(CONFIG_APP_LOG_BINARY)
+#define SENSOR_PATH		"/lfs/sensor.bin"	/**< Log segment base path in LittleFS. */
+#else
+#define SENSOR_PATH		"/lfs/sensor.txt"	/**< Log segment base path in LittleFS. */
+#endif
+#define SCHED_PATH		"/lfs/sched.cfg"	/**< Persisted per-sensor periods. */
+#define SCHED_MAGIC		0x53434844		/**< "SCHD" tag of @ref SCHED_PATH. */
 
 LOG_MODULE_REGISTER(shell_threads);
 
+/**
+ * @brief @ref SENSOR_PATH segments (@c .0, @c .1, ...), the newest kept open
+ *        behind a RAM buffer (coordinator appends).
+ */
+SENSOR_SINK_SEG_DEFINE(log_sink, SENSOR_PATH, CONFIG_APP_LOG_BUF_SIZE, CONFIG_APP_LOG_FLUSH_MS,
+		       CONFIG_APP_LOG_SEG_SIZE, CONFIG_APP_LOG_BUDGET / CONFIG_APP_LOG_SEG_SIZE);
+
 /* ------------ threads & stacks ------------ */
-static struct k_thread		hum_thread_data, press_thread_data, imu_thread_data, coord_thread_data;
-static K_THREAD_STACK_DEFINE(hum_stack,   2048);
-static K_THREAD_STACK_DEFINE(press_stack, 2048);
-static K_THREAD_STACK_DEFINE(imu_stack,   2048);
-static K_THREAD_STACK_DEFINE(coord_stack, 3072);
-
-static k_tid_t			hum_tid, press_tid, imu_tid, coord_tid;
-
-/* ------------ semaphores (chain + control) ------------ */
-K_SEM_DEFINE(semHT,	0, 1);		/**< Coordinator → HT worker trigger. */
-K_SEM_DEFINE(semPress,	0, 1);		/**< HT → PRESS handoff. */
-K_SEM_DEFINE(semGyro,	0, 1);		/**< PRESS → IMU handoff. */
-K_SEM_DEFINE(semDone,	0, 1);		/**< IMU → Coordinator cycle completion. */
-
-/** @brief Aggregated sensor snapshot shared between workers and coordinator. */
-struct sensor_data {
-	float		temp;		/**< Temperature in °C. */
-	float		hum;		/**< Relative humidity in %. */
-	float		press;		/**< Pressure in kPa. */
-	float		ax, ay, az;	/**< Accelerometer axes (SI units as provided by driver). */
-	float		gx, gy, gz;	/**< Gyroscope axes (SI units as provided by driver). */
-	bool		ht_ok;		/**< Humidity/temperature reading validity. */
-	bool		press_ok;	/**< Pressure reading validity. */
-	bool		imu_ok;		/**< IMU reading validity. */
+#if defined(CONFIG_APP_EXECUTOR_WORKQ)
+static struct k_work_q		exec_q;
+static K_THREAD_STACK_DEFINE(exec_stack, CONFIG_APP_EXECUTOR_STACK_SIZE);
+#else
+#if !defined(CONFIG_APP_SENSOR_ASYNC)
+static struct k_thread		worker_thread_data;
+static K_THREAD_STACK_DEFINE(worker_stack, CONFIG_APP_WORKER_STACK_SIZE);
+#endif
+static struct k_thread		coord_thread_data;
+static K_THREAD_STACK_DEFINE(coord_stack, CONFIG_APP_COORD_STACK_SIZE);
+
+static bool			threads_created;	/**< Threads live from first start on. */
+#endif
+
+/* ------------ lifecycle control ------------ */
+#define CTRL_RUN	BIT(0)		/**< Sampling enabled; cleared to pause/stop. */
+#define CTRL_PARKED	BIT(1)		/**< Coordinator idle between cycles, tick disarmed. */
+
+#define PARK_TIMEOUT	K_SECONDS(5)	/**< Longest wait for an in-flight cycle to finish. */
+
+/** @brief Lifecycle state, changed from the shell only. */
+enum run_state {
+	RUN_STOPPED,		/**< Never started or stopped: next start resets. */
+	RUN_RUNNING,		/**< Sampling. */
+	RUN_PAUSED,		/**< Parked; resume keeps snapshot and schedule. */
+};
+
+K_EVENT_DEFINE(g_ctrl);				/**< Shell ↔ executor control bits. */
+static enum run_state		g_state;	/**< Current lifecycle state. */
+
+/* ------------ worker wake-up (trigger + control) ------------ */
+K_EVENT_DEFINE(g_wake);			/**< Coordinator or DRDY → worker, @c BIT(htpg_sensor). */
+K_SEM_DEFINE(semDone,	0, 1);		/**< Worker → Coordinator read completion. */
+
+static struct sensor_period	g_tick;	/**< Coordinator tick, GCD of @ref g_period_ms. */
+
+#if defined(CONFIG_APP_SENSOR_DRDY)
+/* DRDY mode: HT/IMU run at sensor ODR, only PRESS is triggered. */
+#define SELF_CLOCKED	(BIT(HTPG_HT) | BIT(HTPG_IMU))	/**< Sensors not triggered. */
+#else
+#define SELF_CLOCKED	0
+#endif
+
+/** @brief Persisted scheduler configuration (@ref SCHED_PATH). */
+struct sched_cfg {
+	uint32_t	magic;			/**< @ref SCHED_MAGIC. */
+	uint32_t	period_ms[HTPG_COUNT];	/**< Per-sensor period. */
+};
+
+/** @cond INTERNAL_HIDDEN */
+#define PERIOD_INIT_(id, alias, name, period, ...)	[id] = ATOMIC_INIT(period),
+/** @endcond */
+
+/** @brief Per-sensor periods in ms (written by shell, read by coordinator). */
+static atomic_t g_period_ms[HTPG_COUNT] = {
+	HTPG_SENSOR_TABLE(PERIOD_INIT_)
 };
 
-static struct sensor_data	g_sd;		/**< Live shared snapshot (protected by @ref g_sd_mtx). */
-static struct k_mutex		g_sd_mtx;	/**< Mutex protecting @ref g_sd. */
+static struct htpg_sample	g_sd;		/**< Live shared snapshot (published via @ref g_sd_lock). */
+static struct sensor_seqlock	g_sd_lock;	/**< Sequence lock: writers serialize, readers never block. */
 
 /* ------------ helpers ------------ */
+/**
+ * @brief Take a consistent copy of the live snapshot without blocking writers.
+ * @param[out] out	Destination snapshot.
+ */
+static inline void snapshot_get(struct htpg_sample *out)
+{
+	SENSOR_SEQLOCK_READ(&g_sd_lock, out, &g_sd);
+}
+
 /**
  * @brief Get current uptime as seconds and millisecond remainder.
  * @param[out] sec	Seconds since boot.
@@ -65,173 +149,904 @@ static inline void ts_now(uint32_t *sec, uint32_t *mms)
 	*mms = (uint32_t)(ms % 1000U);
 }
 
-/**
- * @brief Parse "Temperature/Humidity" line into floats.
- * @param s	Input string (e.g., "Temperature: 24.3 C, Humidity: 55.0 %").
- * @param t	Output temperature (°C).
- * @param h	Output humidity (%).
- * @return true on success; false otherwise.
- */
-static bool parse_ht(const char *s, float *t, float *h)
-{
-	/* expects: "Temperature: %.1f C, Humidity: %.1f %%\n" */
-	return (sscanf(s, "Temperature: %f C, Humidity: %f %%", t, h) == 2);
-}
+/* ------------ per-sensor read + publish (no FS; update g_sd only) ------------ */
+/** @brief Pipeline stage timing each sensor's read. */
+static const enum pipe_stage read_stage[HTPG_COUNT] = {
+	[HTPG_HT]	= PSTAGE_HT_READ,
+	[HTPG_PRESS]	= PSTAGE_PRESS_READ,
+	[HTPG_IMU]	= PSTAGE_IMU_READ,
+};
 
 /**
- * @brief Parse "Pressure" line into float.
- * @param s	Input string (e.g., "Pressure: 101.3 kPa").
- * @param p	Output pressure (kPa).
- * @return true on success; false otherwise.
+ * @brief Feed a valid IMU sample to the inline IMU stages.
+ * @param imu	Fresh sample.
  */
-static bool parse_press(const char *s, float *p)
+static void imu_stages_feed(const struct imu_sample *imu)
 {
-	/* expects: "Pressure: %.1f kPa\n" */
-	return (sscanf(s, "Pressure: %f", p) == 1);
+	imu_burst_feed(imu);
+	imu_spectrum_feed(imu);
+	imu_fusion_feed(imu);
 }
 
 /**
- * @brief Parse "IMU" line (Accel/Gyro) into six floats.
- * @param s	Input string (e.g., "Accel: ax, ay, az | Gyro: gx, gy, gz").
- * @param ax,ay,az	Accel outputs.
- * @param gx,gy,gz	Gyro outputs.
- * @return true on success; false otherwise.
+ * @brief Read one sensor via htpg_sensor_read() and publish it into @ref g_sd.
+ * @param id	Sensor to read.
  */
-static bool parse_imu(const char *s, float *ax, float *ay, float *az, float *gx, float *gy, float *gz)
+static void publish(enum htpg_sensor id)
 {
-	/* expects: "Accel: %f, %f, %f | Gyro: %f, %f, %f\n" */
-	return (sscanf(s, "Accel: %f, %f, %f | Gyro: %f, %f, %f", ax, ay, az, gx, gy, gz) == 6);
+	struct htpg_sample	s;
+	uint32_t		t0 = pstat_begin();
+
+	(void)htpg_sensor_read(id, &s);
+	pstat_end(read_stage[id], t0);
+
+	if (id == HTPG_IMU && (s.ok & BIT(HTPG_IMU))) {
+		imu_stages_feed(&s.imu);
+	}
+
+	k_spinlock_key_t key = sensor_seqlock_write_begin(&g_sd_lock);
+	htpg_sample_copy(&g_sd, &s, BIT(id));
+	sensor_seqlock_write_end(&g_sd_lock, key);
 }
 
-/* ------------ worker threads (no FS; update g_sd only) ------------ */
+/* ------------ worker thread ------------ */
 /**
- * @brief Humidity/Temperature worker.
+ * @brief Acquisition worker shared by all sensors.
  *
- * Waits on @ref semHT, fetches HT data via @c hum_temp_sensor_get_string(),
- * parses values, updates @ref g_sd under @ref g_sd_mtx, then signals @ref semPress.
+ * Waits on @ref g_wake for any sensor bit. Bits posted by the coordinator
+ * are read in table order (the bus is shared) and acknowledged with one
+ * @ref semDone; in @c CONFIG_APP_SENSOR_DRDY mode the self-clocked bits are
+ * posted by the data-ready interrupts and are read while @ref CTRL_RUN is
+ * set only.
  *
  * @param a Unused.
  * @param b Unused.
  * @param c Unused.
  */
-void hum_thread(void *a, void *b, void *c)
+void worker_thread(void *a, void *b, void *c)
 {
-	char	buf[128];
-
 	for (;;) {
-		k_sem_take(&semHT, K_FOREVER);
-
-		bool	ok = false;
-		if (hum_temp_sensor_get_string(buf, sizeof(buf)) > 0) {
-			float	t, h;
-			ok = parse_ht(buf, &t, &h);
-			if (ok) {
-				k_mutex_lock(&g_sd_mtx, K_FOREVER);
-				g_sd.temp = t;
-				g_sd.hum  = h;
-				g_sd.ht_ok = true;
-				k_mutex_unlock(&g_sd_mtx);
+		uint32_t bits = k_event_wait(&g_wake, HTPG_ALL, false, K_FOREVER);
+		uint32_t trig = bits & ~SELF_CLOCKED;
+
+		k_event_clear(&g_wake, bits);
+
+		for (int i = 0; i < HTPG_COUNT; i++) {
+			if (trig & BIT(i)) publish(i);
+		}
+		if (trig) {
+			k_sem_give(&semDone);
+		}
+
+		if (bits & SELF_CLOCKED) {
+			/* self-clocked: hold here while paused/stopped */
+			k_event_wait(&g_ctrl, CTRL_RUN, false, K_FOREVER);
+			for (int i = 0; i < HTPG_COUNT; i++) {
+				if (bits & SELF_CLOCKED & BIT(i)) publish(i);
 			}
 		}
+	}
+}
+
+/* ------------ async acquisition ------------ */
+#if defined(CONFIG_APP_SENSOR_ASYNC)
+/**
+ * @brief Acquire the due sensors as one RTIO batch and publish to @ref g_sd.
+ *
+ * Replaces the worker handoff: all due reads are in flight at once and only
+ * the coordinator blocks while the bus transactions complete.
+ *
+ * @param due	Sensors to read, @c BIT(enum htpg_sensor).
+ */
+static void acquire_async(uint32_t due)
+{
+	struct htpg_sample	s;
+	uint32_t		t0 = pstat_begin();
+
+	if (htpg_sensors_read_async(&s, due) < 0) {
+		s.ok = 0;
+	}
+	pstat_end(PSTAGE_ASYNC_BATCH, t0);
+
+	if (due & s.ok & BIT(HTPG_IMU)) {
+		imu_stages_feed(&s.imu);
+	}
+
+	k_spinlock_key_t key = sensor_seqlock_write_begin(&g_sd_lock);
+	htpg_sample_copy(&g_sd, &s, due);
+	sensor_seqlock_write_end(&g_sd_lock, key);
+}
+#endif
+
+#if !defined(CONFIG_APP_EXECUTOR_WORKQ)
+/**
+ * @brief Acquire the due sensors and publish them to @ref g_sd.
+ *
+ * Triggered mode hands the due sensors to the worker in one event and waits
+ * for it to read them one after another (the bus is shared); sensors clocked
+ * by their own DRDY are not triggered, their latest sample is simply
+ * included in the row.
+ *
+ * @param due	Sensors to read, @c BIT(enum htpg_sensor).
+ */
+static void acquire(uint32_t due)
+{
+#if defined(CONFIG_APP_SENSOR_ASYNC)
+	acquire_async(due);
+#else
+	due &= ~SELF_CLOCKED;
+	if (due) {
+		k_event_post(&g_wake, due);
+		k_sem_take(&semDone, K_FOREVER);
+	}
+#endif
+}
+#endif
+
+/* ------------ scheduler config ------------ */
+/**
+ * @brief Load per-sensor periods from @ref SCHED_PATH (keeps defaults if absent).
+ */
+static void sched_load(void)
+{
+	struct sched_cfg	cfg;
+	struct fs_file_t	file;
 
-		if (!ok) {
-			k_mutex_lock(&g_sd_mtx, K_FOREVER);
-			g_sd.ht_ok = false;
-			k_mutex_unlock(&g_sd_mtx);
+	fs_file_t_init(&file);
+	if (fs_open(&file, SCHED_PATH, FS_O_READ) != 0) return;
+
+	if (fs_read(&file, &cfg, sizeof(cfg)) == sizeof(cfg) && cfg.magic == SCHED_MAGIC) {
+		for (int i = 0; i < HTPG_COUNT; i++) {
+			atomic_set(&g_period_ms[i], MAX(cfg.period_ms[i], MIN_PERIOD_MS));
 		}
+	}
+	fs_close(&file);
+}
+
+/**
+ * @brief Persist the current per-sensor periods to @ref SCHED_PATH.
+ * @return 0 on success, negative errno otherwise.
+ */
+static int sched_save(void)
+{
+	struct sched_cfg	cfg = { .magic = SCHED_MAGIC };
+	struct fs_file_t	file;
+	int			rc;
 
-		k_sem_give(&semPress);
+	for (int i = 0; i < HTPG_COUNT; i++) {
+		cfg.period_ms[i] = (uint32_t)atomic_get(&g_period_ms[i]);
 	}
+
+	fs_file_t_init(&file);
+	rc = fs_open(&file, SCHED_PATH, FS_O_CREATE | FS_O_WRITE);
+	if (rc < 0) return rc;
+
+	rc = fs_truncate(&file, 0);
+	if (rc == 0) rc = fs_write(&file, &cfg, sizeof(cfg));
+	fs_close(&file);
+	return (rc < 0) ? rc : 0;
 }
 
 /**
- * @brief Pressure worker.
+ * @brief Coordinator tick: GCD of the per-sensor periods.
  *
- * Waits on @ref semPress, fetches pressure via @c pressure_sensor_get_string(),
- * parses value, updates @ref g_sd, then signals @ref semGyro.
+ * Every period is a whole number of ticks, so one timer serves all rates.
+ * Periods that share no useful divisor degrade to a fast tick; keep them
+ * multiples of a common base (e.g. 10 ms) to keep the CPU idle.
  *
- * @param a Unused.
- * @param b Unused.
- * @param c Unused.
+ * @return Tick in milliseconds.
  */
-void press_thread(void *a, void *b, void *c)
+static uint32_t sched_tick_ms(void)
 {
-	char	buf[128];
+	uint32_t g = (uint32_t)atomic_get(&g_period_ms[0]);
 
-	for (;;) {
-		k_sem_take(&semPress, K_FOREVER);
-
-		bool	ok = false;
-		if (pressure_sensor_get_string(buf, sizeof(buf)) > 0) {
-			float	p;
-			ok = parse_press(buf, &p);
-			if (ok) {
-				k_mutex_lock(&g_sd_mtx, K_FOREVER);
-				g_sd.press = p;
-				g_sd.press_ok = true;
-				k_mutex_unlock(&g_sd_mtx);
-			}
+	for (int i = 1; i < HTPG_COUNT; i++) {
+		uint32_t b = (uint32_t)atomic_get(&g_period_ms[i]);
+
+		while (b) {
+			uint32_t t = g % b;
+			g = b;
+			b = t;
+		}
+	}
+	return g;
+}
+
+static uint32_t sched_elapsed[HTPG_COUNT];	/**< Time since each sensor was last due. */
+
+/** @brief Make every sensor due on the next sched_due(). */
+static void sched_reset(void)
+{
+	for (int i = 0; i < HTPG_COUNT; i++) {
+		sched_elapsed[i] = (uint32_t)atomic_get(&g_period_ms[i]);
+	}
+}
+
+/**
+ * @brief Advance the schedule by @p n ticks and collect the due sensors.
+ *
+ * A sensor is due once its period has elapsed; periods missed by an overrun
+ * are skipped, not burst (and counted by @ref g_tick).
+ *
+ * @param n	Ticks elapsed since the previous call (>= 1).
+ * @return Due sensors, @c BIT(enum htpg_sensor).
+ */
+static uint32_t sched_due(uint32_t n)
+{
+	uint32_t	due = 0;
+	uint32_t	tick = sensor_period_get(&g_tick);
+
+	for (int i = 0; i < HTPG_COUNT; i++) {
+		uint32_t period = (uint32_t)atomic_get(&g_period_ms[i]);
+
+		sched_elapsed[i] += (n - 1) * tick;
+		if (sched_elapsed[i] >= period) {
+			due |= BIT(i);
+			sched_elapsed[i] %= period;
+		}
+		sched_elapsed[i] += tick;
+	}
+	return due;
+}
+
+/**
+ * @brief Format one channel group's validity tag.
+ * @param due	Sensors sampled in this row.
+ * @param id	Sensor to describe.
+ * @param ok	Validity mask of the snapshot (@c htpg_sample::ok).
+ * @return 'Y' fresh and valid, 'N' fresh but failed, '-' not sampled this row.
+ */
+static inline char valid_tag(uint32_t due, enum htpg_sensor id, uint32_t ok)
+{
+	if (!(due & BIT(id))) return '-';
+	return (ok & BIT(id)) ? 'Y' : 'N';
+}
+
+/* ------------ log rows ------------ */
+/** @brief Logged channels, in row order (raw rows and aggregation windows). */
+enum agg_chan {
+	AGG_T, AGG_H, AGG_P, AGG_AX, AGG_AY, AGG_AZ, AGG_GX, AGG_GY, AGG_GZ, AGG_COUNT
+};
+
+#if defined(CONFIG_APP_LOG_BINARY)
+/** @brief Record tags in @ref SENSOR_PATH. */
+enum log_tag {
+	TAG_ROW,		/**< One cycle, @ref row_chans. */
+	TAG_AGG,		/**< One aggregation window, @ref agg_chans. */
+};
+
+/** @brief Extra channels of a raw row, after the @ref agg_chan ones. */
+enum row_chan {
+	ROW_FAILED = AGG_COUNT,	/**< Due sensors whose read failed, BIT(htpg_sensor). */
+	ROW_ROLL, ROW_PITCH, ROW_YAW, ROW_COUNT
+};
+
+/**
+ * @brief Raw row: 30 B instead of up to ~120 B of text.
+ *
+ * Channels of sensors not due (text '-') or failed (text 'N') are stored
+ * as missing; @c failed tells the two apart.
+ */
+static const struct sensor_rec_chan row_chans[ROW_COUNT] = {
+	[AGG_T]		= SENSOR_REC_CHAN("T", "C", 2, -2),
+	[AGG_H]		= SENSOR_REC_CHAN("H", "%RH", 2, -2),
+	[AGG_P]		= SENSOR_REC_CHAN("P", "kPa", 2, -2),
+	[AGG_AX]	= SENSOR_REC_CHAN("Ax", "m/s2", 2, -2),
+	[AGG_AY]	= SENSOR_REC_CHAN("Ay", "m/s2", 2, -2),
+	[AGG_AZ]	= SENSOR_REC_CHAN("Az", "m/s2", 2, -2),
+	[AGG_GX]	= SENSOR_REC_CHAN("Gx", "rad/s", 2, -3),
+	[AGG_GY]	= SENSOR_REC_CHAN("Gy", "rad/s", 2, -3),
+	[AGG_GZ]	= SENSOR_REC_CHAN("Gz", "rad/s", 2, -3),
+	[ROW_FAILED]	= SENSOR_REC_CHAN_RAW("failed", "mask", 1),
+	[ROW_ROLL]	= SENSOR_REC_CHAN("roll", "deg", 2, -2),
+	[ROW_PITCH]	= SENSOR_REC_CHAN("pitch", "deg", 2, -2),
+	[ROW_YAW]	= SENSOR_REC_CHAN("yaw", "deg", 2, -2),
+};
+
+/** @brief Per-window fields of an aggregation record, before the channels. */
+enum agg_field {
+	AGGF_CYCLES,		/**< Cycles in the window. */
+	AGGF_DT,		/**< Window length in ms. */
+	AGGF_CHAN,		/**< First of @ref AGG_STATS values per channel. */
+};
+
+/** @brief Values per aggregated channel: min, mean, max, sd, count. */
+#define AGG_STATS	5
+
+/** @cond INTERNAL_HIDDEN */
+#define AGG_REC_CHANS_(_l, _unit, _exp)							\
+	SENSOR_REC_CHAN(_l "_min", _unit, 2, _exp),					\
+	SENSOR_REC_CHAN(_l "_mean", _unit, 2, _exp),					\
+	SENSOR_REC_CHAN(_l "_max", _unit, 2, _exp),					\
+	SENSOR_REC_CHAN(_l "_sd", _unit, 2, (_exp) - 1),				\
+	SENSOR_REC_CHAN_RAW(_l "_n", "", 4)
+/** @endcond */
+
+/** @brief Aggregation window: 121 B instead of up to ~600 B of text. */
+static const struct sensor_rec_chan agg_chans[AGGF_CHAN + AGG_COUNT * AGG_STATS] = {
+	SENSOR_REC_CHAN_RAW("cycles", "", 4),
+	SENSOR_REC_CHAN_RAW("dt", "ms", 4),
+	AGG_REC_CHANS_("T", "C", -2),
+	AGG_REC_CHANS_("H", "%RH", -2),
+	AGG_REC_CHANS_("P", "kPa", -2),
+	AGG_REC_CHANS_("Ax", "m/s2", -2),
+	AGG_REC_CHANS_("Ay", "m/s2", -2),
+	AGG_REC_CHANS_("Az", "m/s2", -2),
+	AGG_REC_CHANS_("Gx", "rad/s", -3),
+	AGG_REC_CHANS_("Gy", "rad/s", -3),
+	AGG_REC_CHANS_("Gz", "rad/s", -3),
+};
+
+/** @brief Record types of @ref SENSOR_PATH, indexed by @ref log_tag. */
+static const struct sensor_rec_type log_types[] = {
+	[TAG_ROW] = SENSOR_REC_TYPE(TAG_ROW, "row", row_chans),
+	[TAG_AGG] = SENSOR_REC_TYPE(TAG_AGG, "agg", agg_chans),
+};
+
+#if defined(CONFIG_APP_LOG_PACK)
+/** @brief Packs records for @ref log_sink, restarted with every segment. */
+SENSOR_PACK_DEFINE(log_pack, log_types);
+#endif
+
+/** @brief Upper bound of a record of @p _chans (widths are at most 4). */
+#define REC_MAX(_chans)	(SENSOR_REC_PREFIX + 4 * ARRAY_SIZE(_chans))
+
+/** @brief File header written by @ref log_sink into every new log. */
+static uint8_t log_hdr[SENSOR_REC_HDR_LEN + ARRAY_SIZE(log_types) * SENSOR_REC_TYPE_LEN +
+		       (ARRAY_SIZE(row_chans) + ARRAY_SIZE(agg_chans)) * SENSOR_REC_CHAN_LEN];
+static size_t log_hdr_len;	/**< Bytes of @ref log_hdr, 0 until built. */
+
+/** @brief Build @ref log_hdr and hand it to @ref log_sink (once). */
+static void log_hdr_init(void)
+{
+	if (log_hdr_len) return;
+
+#if defined(CONFIG_APP_LOG_PACK)
+	log_hdr_len = sensor_pack_header(&log_pack, log_hdr, sizeof(log_hdr));
+	(void)sensor_sink_set_filter(&log_sink, sensor_pack_filter, &log_pack);
+#else
+	log_hdr_len = sensor_rec_header(log_types, ARRAY_SIZE(log_types), log_hdr, sizeof(log_hdr));
+#endif
+	sensor_sink_set_header(&log_sink, log_hdr, log_hdr_len);
+}
+
+/**
+ * @brief Pack one raw row.
+ * @param[out] out	Destination, REC_MAX(row_chans) bytes.
+ * @param due		Sensors sampled in this row.
+ * @param snap		Snapshot after acquisition.
+ * @return record bytes.
+ */
+static size_t row_encode(uint8_t *out, uint32_t due, const struct htpg_sample *snap)
+{
+	uint32_t	fresh = due & snap->ok;
+	int32_t		v[ROW_COUNT];
+	int32_t		rpy[3];
+
+	for (int i = 0; i < ROW_COUNT; i++) {
+		v[i] = SENSOR_REC_NONE;
+	}
+	if (fresh & BIT(HTPG_HT)) {
+		v[AGG_T] = snap->ht.temp;
+		v[AGG_H] = snap->ht.hum;
+	}
+	if (fresh & BIT(HTPG_PRESS)) {
+		v[AGG_P] = snap->press.press;
+	}
+	if (fresh & BIT(HTPG_IMU)) {
+		for (int i = 0; i < 3; i++) {
+			v[AGG_AX + i] = snap->imu.accel[i];
+			v[AGG_GX + i] = snap->imu.gyro[i];
+		}
+		if (imu_fusion_get_rpy(rpy)) {
+			v[ROW_ROLL] = rpy[0];
+			v[ROW_PITCH] = rpy[1];
+			v[ROW_YAW] = rpy[2];
 		}
+	}
+	v[ROW_FAILED] = (int32_t)(due & ~snap->ok);
+
+	return sensor_rec_encode(&log_types[TAG_ROW], k_uptime_get_32(), v, out);
+}
+#else
+/** @brief Row labels of the aggregated channels. */
+static const char *const agg_label[AGG_COUNT] = {
+	"T", "H", "P", "Ax", "Ay", "Az", "Gx", "Gy", "Gz",
+};
+
+/**
+ * @brief Format one raw row as text.
+ *
+ * Sensors not sampled in this row are tagged '-' and their values omitted.
+ *
+ * @param[out] line	Destination.
+ * @param len		Size of @p line.
+ * @param due		Sensors sampled in this row.
+ * @param snap		Snapshot after acquisition.
+ * @return characters written, at most @p len - 1.
+ */
+static int row_format(char *line, size_t len, uint32_t due, const struct htpg_sample *snap)
+{
+	uint32_t	sec, mms;
+	int		n;
+
+	ts_now(&sec, &mms);
+
+	n = snprintk(line, len, "[%u.%03u] HT[%c]", sec, mms,
+		     valid_tag(due, HTPG_HT, snap->ok));
+	if (due & BIT(HTPG_HT)) {
+		n += snprintk(line + n, len - n, " T=" SENSOR_FIXP_FMT "C H=" SENSOR_FIXP_FMT "%%",
+			      SENSOR_FIXP_ARG(snap->ht.temp, 2), SENSOR_FIXP_ARG(snap->ht.hum, 2));
+	}
+	n += snprintk(line + n, len - n, " | P[%c]", valid_tag(due, HTPG_PRESS, snap->ok));
+	if (due & BIT(HTPG_PRESS)) {
+		n += snprintk(line + n, len - n, "=" SENSOR_FIXP_FMT "kPa",
+			      SENSOR_FIXP_ARG(snap->press.press, 2));
+	}
+	n += snprintk(line + n, len - n, " | IMU[%c]", valid_tag(due, HTPG_IMU, snap->ok));
+	if (due & BIT(HTPG_IMU)) {
+		n += snprintk(line + n, len - n,
+			" A=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ") G=("
+			SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ")",
+			SENSOR_FIXP_ARG(snap->imu.accel[0], 2), SENSOR_FIXP_ARG(snap->imu.accel[1], 2),
+			SENSOR_FIXP_ARG(snap->imu.accel[2], 2), SENSOR_FIXP_ARG(snap->imu.gyro[0], 2),
+			SENSOR_FIXP_ARG(snap->imu.gyro[1], 2), SENSOR_FIXP_ARG(snap->imu.gyro[2], 2));
+	}
+	int32_t rpy[3];
+
+	if ((due & BIT(HTPG_IMU)) && imu_fusion_get_rpy(rpy)) {
+		n += snprintk(line + n, len - n,
+			" RPY=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ")",
+			SENSOR_FIXP_ARG(rpy[0], 1), SENSOR_FIXP_ARG(rpy[1], 1),
+			SENSOR_FIXP_ARG(rpy[2], 1));
+	}
+	n += snprintk(line + n, len - n, "\r\n");
+	return MIN(n, (int)len - 1);
+}
+#endif
+
+/* ------------ coordinator (deadline scheduler, writes once per wake) ------------ */
+/**
+ * @brief Append one formatted row to @ref SENSOR_PATH through @ref log_sink.
+ *
+ * Usually a copy into RAM; the row that fills the buffer also pays for
+ * its write and commit, which shows up as the max of the `fs_append` stage.
+ *
+ * @param row	Record or text line.
+ * @param n	Bytes in @p row.
+ */
+static void log_append(const void *row, size_t n)
+{
+	uint32_t	t0 = pstat_begin();
+	int		rc = sensor_sink_append(&log_sink, row, n);
+
+	pstat_end(PSTAGE_FS_APPEND, t0);
+	if (rc < 0) {
+		LOG_ERR("log append failed (%d)", rc);
+	}
+}
+
+/**
+ * @brief Append one row for the sensors in @p due to @ref SENSOR_PATH.
+ * @param due	Sensors sampled in this row.
+ * @param snap	Snapshot taken for this cycle.
+ */
+static void write_row(uint32_t due, const struct htpg_sample *snap)
+{
+	uint32_t	t0 = pstat_begin();
+	size_t		n;
+
+#if defined(CONFIG_APP_LOG_BINARY)
+	uint8_t row[REC_MAX(row_chans)];
+
+	n = row_encode(row, due, snap);
+#else
+	char row[320];
+
+	n = row_format(row, sizeof(row), due, snap);
+#endif
+	pstat_end(PSTAGE_FORMAT, t0);
+
+	log_append(row, n);
+}
 
-		if (!ok) {
-			k_mutex_lock(&g_sd_mtx, K_FOREVER);
-			g_sd.press_ok = false;
-			k_mutex_unlock(&g_sd_mtx);
+/* ------------ aggregation stage ------------ */
+static struct sensor_agg	g_agg[AGG_COUNT];	/**< Window state (coordinator-owned). */
+static uint32_t			agg_cycles;		/**< Cycles in the current window. */
+static int64_t			agg_start_ms;		/**< Uptime at window start. */
+static atomic_t			agg_restart = ATOMIC_INIT(1);	/**< Shell → coordinator: drop the window. */
+
+/** @brief Window length in cycles (0: no count limit). */
+static atomic_t g_agg_samples = ATOMIC_INIT(CONFIG_APP_AGG_SAMPLES);
+/** @brief Window length in seconds (0: no time limit). */
+static atomic_t g_agg_secs = ATOMIC_INIT(CONFIG_APP_AGG_SECONDS);
+
+/** @brief Aggregation is on when either window limit is set. */
+static inline bool agg_enabled(void)
+{
+	return atomic_get(&g_agg_samples) || atomic_get(&g_agg_secs);
+}
+
+/** @brief Start a new, empty window. */
+static void agg_reset(void)
+{
+	for (int i = 0; i < AGG_COUNT; i++) {
+		sensor_agg_reset(&g_agg[i]);
+	}
+	agg_cycles = 0;
+	agg_start_ms = k_uptime_get();
+}
+
+/**
+ * @brief Fold the fresh, valid channels of @p snap into the window.
+ * @param snap	Snapshot after acquisition.
+ * @param due	Sensors sampled this cycle.
+ */
+static void agg_feed(const struct htpg_sample *snap, uint32_t due)
+{
+	uint32_t fresh = due & snap->ok;
+
+	if (fresh & BIT(HTPG_HT)) {
+		sensor_agg_add(&g_agg[AGG_T], snap->ht.temp);
+		sensor_agg_add(&g_agg[AGG_H], snap->ht.hum);
+	}
+	if (fresh & BIT(HTPG_PRESS)) {
+		sensor_agg_add(&g_agg[AGG_P], snap->press.press);
+	}
+	if (fresh & BIT(HTPG_IMU)) {
+		for (int i = 0; i < 3; i++) {
+			sensor_agg_add(&g_agg[AGG_AX + i], snap->imu.accel[i]);
+			sensor_agg_add(&g_agg[AGG_GX + i], snap->imu.gyro[i]);
 		}
+	}
+	agg_cycles++;
+}
+
+/**
+ * @brief Append the window summary to @ref SENSOR_PATH and start a new one.
+ *
+ * One row per window: `[t] AGG n=<cycles> dt=<ms>` then, for every channel
+ * with samples, `<label>=min/mean/max/sd(count)`; as a record, channels
+ * without samples are missing with count 0. Empty windows write nothing.
+ */
+static void agg_emit(void)
+{
+	uint32_t	dt = (uint32_t)(k_uptime_get() - agg_start_ms);
+	uint32_t	t0 = pstat_begin();
+	size_t		n;
+
+	if (agg_cycles == 0) return;
+
+#if defined(CONFIG_APP_LOG_BINARY)
+	uint8_t	row[REC_MAX(agg_chans)];
+	int32_t	v[ARRAY_SIZE(agg_chans)];
 
-		k_sem_give(&semGyro);
+	v[AGGF_CYCLES] = (int32_t)agg_cycles;
+	v[AGGF_DT] = (int32_t)dt;
+	for (int i = 0; i < AGG_COUNT; i++) {
+		const struct sensor_agg *a = &g_agg[i];
+		int32_t *f = &v[AGGF_CHAN + i * AGG_STATS];
+		bool some = a->n > 0;
+
+		f[0] = some ? a->min : SENSOR_REC_NONE;
+		f[1] = some ? sensor_agg_mean(a) : SENSOR_REC_NONE;
+		f[2] = some ? a->max : SENSOR_REC_NONE;
+		f[3] = some ? sensor_agg_stddev(a) : SENSOR_REC_NONE;
+		f[4] = (int32_t)a->n;
+	}
+	n = sensor_rec_encode(&log_types[TAG_AGG], k_uptime_get_32(), v, row);
+#else
+	char		row[640];
+	uint32_t	sec, mms;
+	int		len;
+
+	ts_now(&sec, &mms);
+	len = snprintk(row, sizeof(row), "[%u.%03u] AGG n=%u dt=%u", sec, mms, agg_cycles, dt);
+
+	for (int i = 0; i < AGG_COUNT && len < (int)sizeof(row); i++) {
+		const struct sensor_agg *a = &g_agg[i];
+
+		if (a->n == 0) continue;
+
+		len += snprintk(row + len, sizeof(row) - len,
+			" %s=" SENSOR_FIXP_FMT "/" SENSOR_FIXP_FMT "/" SENSOR_FIXP_FMT "/"
+			SENSOR_FIXP_FMT "(%u)", agg_label[i],
+			SENSOR_FIXP_ARG(a->min, 2), SENSOR_FIXP_ARG(sensor_agg_mean(a), 2),
+			SENSOR_FIXP_ARG(a->max, 2), SENSOR_FIXP_ARG(sensor_agg_stddev(a), 3), a->n);
 	}
+	if (len < (int)sizeof(row)) {
+		len += snprintk(row + len, sizeof(row) - len, "\r\n");
+	}
+	n = MIN(len, (int)sizeof(row) - 1);
+#endif
+	pstat_end(PSTAGE_FORMAT, t0);
+
+	log_append(row, n);
+	agg_reset();
+}
+
+/* ------------ deadband (change-only) stage ------------ */
+/** @brief Deadband channel groups. */
+enum db_chan {
+	DB_T, DB_H, DB_P, DB_ACCEL, DB_GYRO, DB_COUNT
+};
+
+/** @brief Shell names of the deadband groups. */
+static const char *const db_name[DB_COUNT] = {
+	"t", "h", "p", "accel", "gyro",
+};
+
+/**
+ * @brief Per-group thresholds in micro-units; 0 keeps the group from
+ *        triggering a row on its own (the IMU is not slow-changing).
+ */
+static atomic_t g_db_thr[DB_COUNT] = {
+	ATOMIC_INIT(100000),	/* 0.1 °C */
+	ATOMIC_INIT(500000),	/* 0.5 %RH */
+	ATOMIC_INIT(50000),	/* 0.05 kPa */
+	ATOMIC_INIT(0),
+	ATOMIC_INIT(0),
+};
+
+static atomic_t g_db_on = ATOMIC_INIT(IS_ENABLED(CONFIG_APP_DEADBAND));	/**< Deadband enabled. */
+static atomic_t g_db_heartbeat_s = ATOMIC_INIT(CONFIG_APP_DEADBAND_HEARTBEAT_S);	/**< Max row gap. */
+static atomic_t db_restart = ATOMIC_INIT(1);	/**< Shell → coordinator: forget @ref db_last. */
+
+static struct htpg_sample	db_last;	/**< Values of the last written row (coordinator-owned). */
+static int64_t			db_last_ms;	/**< Uptime of the last written row. */
+static uint32_t			db_suppressed;	/**< Rows skipped since start (for `deadband`). */
+
+/** @brief |a - b| >= thr for a non-zero threshold. */
+static inline bool db_moved(int32_t a, int32_t b, atomic_val_t thr)
+{
+	int64_t d = (int64_t)a - b;
+
+	return thr && ((d < 0) ? -d : d) >= thr;
 }
 
 /**
- * @brief IMU worker.
+ * @brief Decide whether the cycle is worth a row.
  *
- * Waits on @ref semGyro, fetches IMU via @c imu_sensor_get_string(),
- * parses six axes, updates @ref g_sd, then signals @ref semDone.
+ * True on the first cycle, on any validity change of a due sensor, when a
+ * due channel moved past its group threshold since the last written row,
+ * or when the heartbeat interval has elapsed.
  *
- * @param a Unused.
- * @param b Unused.
- * @param c Unused.
+ * @param snap	Snapshot after acquisition.
+ * @param due	Sensors sampled this cycle.
+ * @return true to write the row.
  */
-void imu_thread(void *a, void *b, void *c)
+static bool db_changed(const struct htpg_sample *snap, uint32_t due)
 {
-	char	buf[192];
+	const struct htpg_sample *l = &db_last;
+	int64_t hb_ms = (int64_t)atomic_get(&g_db_heartbeat_s) * 1000;
 
-	for (;;) {
-		k_sem_take(&semGyro, K_FOREVER);
-
-		bool	ok = false;
-		if (imu_sensor_get_string(buf, sizeof(buf)) > 0) {
-			float	ax, ay, az, gx, gy, gz;
-			ok = parse_imu(buf, &ax, &ay, &az, &gx, &gy, &gz);
-			if (ok) {
-				k_mutex_lock(&g_sd_mtx, K_FOREVER);
-				g_sd.ax = ax; g_sd.ay = ay; g_sd.az = az;
-				g_sd.gx = gx; g_sd.gy = gy; g_sd.gz = gz;
-				g_sd.imu_ok = true;
-				k_mutex_unlock(&g_sd_mtx);
+	if (atomic_cas(&db_restart, 1, 0)) return true;
+	if (hb_ms && k_uptime_get() - db_last_ms >= hb_ms) return true;
+
+	if ((snap->ok ^ l->ok) & due) return true;
+
+	if (due & BIT(HTPG_HT)) {
+		if (db_moved(snap->ht.temp, l->ht.temp, atomic_get(&g_db_thr[DB_T])) ||
+		    db_moved(snap->ht.hum, l->ht.hum, atomic_get(&g_db_thr[DB_H]))) return true;
+	}
+	if (due & BIT(HTPG_PRESS)) {
+		if (db_moved(snap->press.press, l->press.press, atomic_get(&g_db_thr[DB_P]))) return true;
+	}
+	if (due & BIT(HTPG_IMU)) {
+		atomic_val_t ta = atomic_get(&g_db_thr[DB_ACCEL]);
+		atomic_val_t tg = atomic_get(&g_db_thr[DB_GYRO]);
+
+		for (int i = 0; i < 3; i++) {
+			if (db_moved(snap->imu.accel[i], l->imu.accel[i], ta) ||
+			    db_moved(snap->imu.gyro[i], l->imu.gyro[i], tg)) return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Remember the channels of a written row as the new reference.
+ * @param snap	Snapshot that was logged.
+ * @param due	Sensors in the row (others, and failed reads, keep their previous
+ *		reference).
+ */
+static void db_commit(const struct htpg_sample *snap, uint32_t due)
+{
+	htpg_sample_copy(&db_last, snap, due);
+	db_last_ms = k_uptime_get();
+}
+
+/**
+ * @brief Output stage of a cycle: raw row (optionally change-only), or fold
+ *        into the aggregation window and emit a summary row when complete.
+ *
+ * Aggregation takes precedence; the deadband only filters raw rows.
+ *
+ * @param due	Sensors sampled this cycle.
+ */
+static void log_cycle(uint32_t due)
+{
+	struct htpg_sample	snap;
+	uint32_t		t0 = pstat_begin();
+
+	/* one snapshot per cycle: the deadband reference is exactly the row written */
+	snapshot_get(&snap);
+	pstat_end(PSTAGE_SNAPSHOT, t0);
+
+	if (!agg_enabled()) {
+		if (atomic_get(&g_db_on)) {
+			if (!db_changed(&snap, due)) {
+				db_suppressed++;
+				return;
 			}
+			db_commit(&snap, due);
 		}
+		write_row(due, &snap);
+		return;
+	}
+
+	uint32_t	samples = (uint32_t)atomic_get(&g_agg_samples);
+	uint32_t	secs = (uint32_t)atomic_get(&g_agg_secs);
+
+	if (atomic_cas(&agg_restart, 1, 0)) {
+		agg_reset();
+	}
+
+	agg_feed(&snap, due);
+
+	if ((samples && agg_cycles >= samples) ||
+	    (secs && k_uptime_get() - agg_start_ms >= (int64_t)secs * 1000)) {
+		agg_emit();
+	}
+}
 
-		if (!ok) {
-			k_mutex_lock(&g_sd_mtx, K_FOREVER);
-			g_sd.imu_ok = false;
-			k_mutex_unlock(&g_sd_mtx);
+#if defined(CONFIG_APP_EXECUTOR_WORKQ)
+/* ------------ work-queue executor ------------ */
+static struct k_work	cycle_work;		/**< Tick → compute due set, start chain. */
+static struct k_work	row_work;		/**< Chain tail: write the row. */
+static struct k_work	sensor_work[HTPG_COUNT];	/**< One read+publish item per sensor. */
+static atomic_t		chain_busy;		/**< A cycle's chain is still in flight. */
+static uint32_t		chain_due;		/**< Sensors of the in-flight cycle. */
+static uint32_t		chain_t0;		/**< Cycle start (pipeline stats). */
+
+/**
+ * @brief Submit the next link of the chain: the first due sensor at or after
+ *        @p from, or the row writer when none is left.
+ * @param from	First sensor id to consider.
+ */
+static void chain_next(int from)
+{
+	for (int i = from; i < HTPG_COUNT; i++) {
+		if (chain_due & BIT(i)) {
+			k_work_submit_to_queue(&exec_q, &sensor_work[i]);
+			return;
 		}
+	}
+	k_work_submit_to_queue(&exec_q, &row_work);
+}
+
+/** @brief Tick expiry (ISR): hand the cycle to the executor queue. */
+static void tick_expired(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+	k_work_submit_to_queue(&exec_q, &cycle_work);
+}
+
+/**
+ * @brief Cycle item: collect the due sensors and start the chain.
+ *
+ * If the previous chain has not finished, the tick is left pending so the
+ * next poll reports it as an overrun and sched_due() skips it.
+ */
+static void cycle_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (!atomic_cas(&chain_busy, 0, 1)) return;
+
+	chain_due = sched_due(MAX(sensor_period_poll(&g_tick), 1U));
+	if (!chain_due) {
+		atomic_clear(&chain_busy);
+		return;
+	}
+	chain_t0 = pstat_begin();
+	chain_next(0);
+}
+
+/** @brief Sensor item: read+publish one sensor, then chain to the next. */
+static void sensor_handler(struct k_work *work)
+{
+	int id = work - sensor_work;
+
+	publish(id);
+	chain_next(id + 1);
+}
+
+/** @brief Row item: write the cycle's row and release the chain. */
+static void row_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	log_cycle(chain_due);
+	pstat_end(PSTAGE_CYCLE, chain_t0);
+	atomic_clear(&chain_busy);
+}
+
+/**
+ * @brief Arm the work-queue executor (creates the queue on first use).
+ *
+ * The queue thread is created once; afterwards run/park only arm and
+ * disarm the tick.
+ *
+ * @param sh	Shell instance.
+ */
+static void executor_run(const struct shell *sh)
+{
+	static bool	q_started;
 
-		k_sem_give(&semDone);
+	if (!q_started) {
+		k_work_queue_start(&exec_q, exec_stack, K_THREAD_STACK_SIZEOF(exec_stack),
+				   4, NULL);
+		k_thread_name_set(&exec_q.thread, "sensor_exec");
+		k_work_init(&cycle_work, cycle_handler);
+		k_work_init(&row_work, row_handler);
+		for (int i = 0; i < HTPG_COUNT; i++) {
+			k_work_init(&sensor_work[i], sensor_handler);
+		}
+		q_started = true;
+		shell_print(sh, "Executor work queue created.");
 	}
+
+	sensor_period_init_notify(&g_tick, sched_tick_ms(), tick_expired);
+	atomic_clear(&chain_busy);
+	k_event_post(&g_ctrl, CTRL_RUN);
+	sensor_period_start(&g_tick);
+	k_work_submit_to_queue(&exec_q, &cycle_work);	/* first cycle right away */
+}
+
+/**
+ * @brief Park the work-queue executor: disarm the tick, let the in-flight
+ *        chain run to its row, and wait until the queue is idle.
+ * @param sh	Shell instance.
+ * @return 0 once idle.
+ */
+static int executor_park(const struct shell *sh)
+{
+	ARG_UNUSED(sh);
+
+	k_event_clear(&g_ctrl, CTRL_RUN);
+	sensor_period_stop(&g_tick);
+	/* chained submissions from the queue itself are still accepted */
+	k_work_queue_drain(&exec_q, false);
+	atomic_clear(&chain_busy);
+	return 0;
 }
 
-/* ------------ coordinator (periodic, writes once) ------------ */
 /**
- * @brief Coordinator thread: triggers chain and appends one line to the log per period.
+ * @brief Check that no chain is in flight before the shell resets state.
+ * @param sh	Shell instance.
+ * @return 0; executor_park() only returns once the queue is idle.
+ */
+static int executor_idle(const struct shell *sh)
+{
+	ARG_UNUSED(sh);
+	return 0;
+}
+#else
+/**
+ * @brief Coordinator thread: multi-rate scheduler on a periodic @c k_timer.
  *
- * Flow per cycle:
- * 1) Give @ref semHT and wait for @ref semDone (HT→PRESS→IMU completes).  
- * 2) Snapshot @ref g_sd under @ref g_sd_mtx.  
- * 3) Timestamp and write a single compact line to @ref SENSOR_PATH.  
- * 4) Sleep until next absolute deadline (tickless-friendly).
+ * Parks on @ref CTRL_RUN while paused or stopped. Flow per tick while
+ * running:
+ * 1) Collect the due sensors with sched_due().
+ * 2) Acquire only those sensors (worker triggers, or one RTIO batch with
+ *    @c CONFIG_APP_SENSOR_ASYNC).
+ * 3) Write one row with per-channel validity to @ref SENSOR_PATH.
+ * 4) Block in sensor_period_wait(); deadlines are kept by the timer, so the
+ *    work above does not shift the schedule. A period change from the shell
+ *    re-rates @ref g_tick in place.
+ * A pause/stop disarms the tick, which releases step 4; the cycle in
+ * progress always completes (no bus transaction or file write is cut).
  *
  * @param a Unused.
  * @param b Unused.
@@ -239,125 +1054,467 @@ void imu_thread(void *a, void *b, void *c)
  */
 static void coordinator_thread(void *a, void *b, void *c)
 {
-	int64_t		next_deadline = k_uptime_get();
-	struct fs_file_t	file;
-	char		line[320];
-
 	for (;;) {
-		next_deadline += LOG_PERIOD_MS;
+		k_event_post(&g_ctrl, CTRL_PARKED);
+		k_event_wait(&g_ctrl, CTRL_RUN, false, K_FOREVER);
+		k_event_clear(&g_ctrl, CTRL_PARKED);
 
-		k_sem_give(&semHT);
-		k_sem_take(&semDone, K_FOREVER);
+		uint32_t	n = 1;
 
-		struct sensor_data snap;
-		k_mutex_lock(&g_sd_mtx, K_FOREVER);
-		snap = g_sd;
-		k_mutex_unlock(&g_sd_mtx);
-
-		uint32_t sec, mms; ts_now(&sec, &mms);
-
-		int n = snprintk(line, sizeof(line),
-			"[%lu.%03lu] HT[%c] T=%.2fC H=%.2f%% | P[%c]=%.2fkPa | "
-			"IMU[%c] A=(%.2f,%.2f,%.2f) G=(%.2f,%.2f,%.2f)\r\n",
-			sec, mms,
-			snap.ht_ok ? 'Y' : 'N',  snap.temp, snap.hum,
-			snap.press_ok ? 'Y' : 'N', snap.press,
-			snap.imu_ok ? 'Y' : 'N', snap.ax, snap.ay, snap.az, snap.gx, snap.gy, snap.gz);
-
-		if (n > 0) {
-			fs_file_t_init(&file);
-			if (fs_open(&file, SENSOR_PATH, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND) == 0) {
-				fs_write(&file, line, (size_t)n);
-				fs_close(&file);
+		sensor_period_start(&g_tick);
+		while (k_event_test(&g_ctrl, CTRL_RUN)) {
+			uint32_t	due = sched_due(n);
+
+			if (due) {
+				uint32_t t0 = pstat_begin();
+
+				acquire(due);
+				log_cycle(due);
+				pstat_end(PSTAGE_CYCLE, t0);
 			}
+			n = sensor_period_wait(&g_tick);
+			if (n == 0) break;
 		}
+		/* a pause racing with our own start may have left the tick armed */
+		sensor_period_stop(&g_tick);
+	}
+}
 
-		int64_t	now = k_uptime_get();
-		int64_t	sleep_ms = next_deadline - now;
-		if (sleep_ms < 1) sleep_ms = 1;
-		k_msleep((int)sleep_ms);
+/**
+ * @brief Create the threads on first use, then let the coordinator run.
+ *
+ * Worker and coordinator are created once and parked between runs, so a
+ * restart only re-arms the tick.
+ *
+ * @param sh	Shell instance.
+ */
+static void executor_run(const struct shell *sh)
+{
+	/* executor_idle() passed: coordinator parked (or not yet created) */
+	sensor_period_init(&g_tick, sched_tick_ms());
+	k_event_clear(&g_ctrl, CTRL_PARKED);
+	k_event_post(&g_ctrl, CTRL_RUN);
+
+	if (!threads_created) {
+#if !defined(CONFIG_APP_SENSOR_ASYNC)
+		k_thread_create(&worker_thread_data, worker_stack, K_THREAD_STACK_SIZEOF(worker_stack),
+			worker_thread, NULL, NULL, NULL, 5, 0, K_NO_WAIT);
+		shell_print(sh, "Acquisition worker created.");
+#endif
+		k_thread_create(&coord_thread_data, coord_stack, K_THREAD_STACK_SIZEOF(coord_stack),
+			coordinator_thread, NULL, NULL, NULL, 4, 0, K_NO_WAIT);
+		shell_print(sh, "Coordinator created.");
+		threads_created = true;
 	}
+#if defined(CONFIG_APP_SENSOR_DRDY)
+	static bool drdy_armed;
+	if (!drdy_armed) {
+		drdy_armed = (htpg_sensors_drdy_enable(&g_wake) == 0);
+		shell_print(sh, "DRDY triggers %s.", drdy_armed ? "armed" : "FAILED");
+	}
+	/* one read per DRDY sensor clears any line left high while parked */
+	k_event_post(&g_wake, SELF_CLOCKED);
+#endif
+}
+
+/**
+ * @brief Wait until the coordinator is parked (or not yet created), so
+ *        @ref g_tick and @ref g_sd may be reset.
+ * @param sh	Shell instance.
+ * @return 0 once parked, -EBUSY if a cycle did not finish in time.
+ */
+static int executor_idle(const struct shell *sh)
+{
+	if (threads_created && k_event_wait(&g_ctrl, CTRL_PARKED, false, PARK_TIMEOUT) == 0) {
+		shell_warn(sh, "cycle still in progress; repeat the command once it completes");
+		return -EBUSY;
+	}
+	return 0;
+}
+
+/**
+ * @brief Park the coordinator: disarm the tick and wait for the cycle in
+ *        progress (bus reads + row write) to complete.
+ *
+ * The worker is never interrupted; triggered reads are done once the
+ * coordinator is parked, DRDY reads finish and the worker holds on
+ * @ref CTRL_RUN.
+ *
+ * @param sh	Shell instance.
+ * @return 0 once parked, -EBUSY if the cycle did not finish in time (the
+ *         coordinator parks after it, the caller keeps its state).
+ */
+static int executor_park(const struct shell *sh)
+{
+	k_event_clear(&g_ctrl, CTRL_RUN);
+	sensor_period_stop(&g_tick);
+	return executor_idle(sh);
 }
+#endif
 
 /* ------------ shell cmds ------------ */
 /**
- * @brief Shell cmd: start all sensor workers and coordinator (idempotent).
+ * @brief Parse a decimal shell argument.
+ * @param s	Argument.
+ * @param out	Value.
+ * @return true on success; false on an empty argument, a sign, trailing
+ *	   characters or a value above UINT32_MAX.
+ */
+static bool parse_u32(const char *s, uint32_t *out)
+{
+	char		*end;
+	unsigned long	v;
+
+	if (*s < '0' || *s > '9') return false;
+	errno = 0;
+	v = strtoul(s, &end, 10);
+	if (errno != 0 || *end != '\0' || v > UINT32_MAX) return false;
+	*out = (uint32_t)v;
+	return true;
+}
+
+/** @brief Print the active periods after a (re)start. */
+static void print_running(const struct shell *sh, const char *what)
+{
+	char	buf[96];
+	int	n = 0;
+
+	for (int i = 0; i < HTPG_COUNT && n < (int)sizeof(buf); i++) {
+		n += snprintk(buf + n, sizeof(buf) - n, "%s=%d ms, ", htpg_sensor_name(i),
+			      (int)atomic_get(&g_period_ms[i]));
+	}
+	shell_print(sh, "Logging %s (%stick=%u ms).", what, buf, sensor_period_get(&g_tick));
+}
+
+/**
+ * @brief Shell cmd: start logging (idempotent; resumes when paused).
  *
- * Creates workers if not already running, initializes mutex and clears snapshot.
+ * From stopped: clears the snapshot, loads the persisted periods and
+ * restarts the schedule so every sensor is sampled at once. Threads (or the
+ * work queue) are created on the first start only and reused afterwards.
  *
  * @param sh	Shell instance.
  * @param argc	Unused.
  * @param argv	Unused.
- * @return 0 on success.
+ * @return 0 on success, -EBUSY if the last cycle has not finished yet.
  */
 static int cmd_start_sensor(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
 
-	if (!hum_tid) {
-		k_mutex_init(&g_sd_mtx);
-		memset(&g_sd, 0, sizeof(g_sd));
+	if (g_state == RUN_RUNNING) {
+		shell_print(sh, "Already running.");
+		return 0;
+	}
+	/* nothing below may run beside a cycle still finishing */
+	int rc = executor_idle(sh);
 
-		hum_tid = k_thread_create(&hum_thread_data, hum_stack,
-			K_THREAD_STACK_SIZEOF(hum_stack),
-			hum_thread, NULL, NULL, NULL, 5, 0, K_NO_WAIT);
-		shell_print(sh, "HT worker started.");
-	}
-	if (!press_tid) {
-		press_tid = k_thread_create(&press_thread_data, press_stack,
-			K_THREAD_STACK_SIZEOF(press_stack),
-			press_thread, NULL, NULL, NULL, 5, 0, K_NO_WAIT);
-		shell_print(sh, "PRESS worker started.");
-	}
-	if (!imu_tid) {
-		imu_tid = k_thread_create(&imu_thread_data, imu_stack,
-			K_THREAD_STACK_SIZEOF(imu_stack),
-			imu_thread, NULL, NULL, NULL, 5, 0, K_NO_WAIT);
-		shell_print(sh, "IMU worker started.");
-	}
-	if (!coord_tid) {
-		coord_tid = k_thread_create(&coord_thread_data, coord_stack,
-			K_THREAD_STACK_SIZEOF(coord_stack),
-			coordinator_thread, NULL, NULL, NULL, 4, 0, K_NO_WAIT);
-		shell_print(sh, "Coordinator started (period=%d ms).", LOG_PERIOD_MS);
+	if (rc < 0) return rc;
+
+	switch (g_state) {
+	case RUN_RUNNING:
+	case RUN_PAUSED:
+		break;
+	case RUN_STOPPED: {
+#if defined(CONFIG_APP_LOG_BINARY)
+		log_hdr_init();
+#endif
+		k_spinlock_key_t key = sensor_seqlock_write_begin(&g_sd_lock);
+		memset(&g_sd, 0, sizeof(g_sd));
+		sensor_seqlock_write_end(&g_sd_lock, key);
+		sched_load();
+		sched_reset();
+		atomic_set(&agg_restart, 1);
+		atomic_set(&db_restart, 1);
+		break;
 	}
+	}
+
+	executor_run(sh);
+	print_running(sh, g_state == RUN_PAUSED ? "resumed" : "started");
+	g_state = RUN_RUNNING;
 
 	return 0;
 }
 
 /**
- * @brief Shell cmd: stop coordinator and workers; drain semaphores.
+ * @brief Shell cmd: pause logging, keeping snapshot and schedule.
  *
- * Aborts all running threads (if any) and clears semaphore counts so that
- * the next `start_sensors` begins from a clean state.
+ * The cycle in progress completes first; nothing is aborted.
+ *
+ * @param sh	Shell instance.
+ * @param argc	Unused.
+ * @param argv	Unused.
+ * @return 0 on success, -EBUSY if the cycle did not finish in time.
+ */
+static int cmd_pause(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	if (g_state != RUN_RUNNING) {
+		shell_print(sh, "Not running.");
+		return 0;
+	}
+	int rc = executor_park(sh);
+
+	if (rc < 0) return rc;	/* still running until the cycle parks; retry */
+	g_state = RUN_PAUSED;
+	(void)sensor_sink_flush(&log_sink);
+	shell_print(sh, "Logging paused.");
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: resume a paused logger where it left off.
  *
  * @param sh	Shell instance.
  * @param argc	Unused.
  * @param argv	Unused.
  * @return 0 on success.
  */
+static int cmd_resume(const struct shell *sh, size_t argc, char **argv)
+{
+	if (g_state != RUN_PAUSED) {
+		shell_print(sh, "Not paused.");
+		return 0;
+	}
+	return cmd_start_sensor(sh, argc, argv);
+}
+
+/**
+ * @brief Shell cmd: stop logging gracefully.
+ *
+ * Lets the cycle in progress finish, then parks the executor; threads stay
+ * alive for the next `start_sensors`, which starts from a clean state.
+ *
+ * @param sh	Shell instance.
+ * @param argc	Unused.
+ * @param argv	Unused.
+ * @return 0 on success, -EBUSY if the cycle did not finish in time.
+ */
 static int cmd_stop_sensors(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
 
-	if (coord_tid) { k_thread_abort(coord_tid); coord_tid = NULL; shell_print(sh, "Coordinator stopped."); }
-	if (hum_tid)   { k_thread_abort(hum_tid);   hum_tid   = NULL; shell_print(sh, "HT worker stopped."); }
-	if (press_tid) { k_thread_abort(press_tid); press_tid = NULL; shell_print(sh, "PRESS worker stopped."); }
-	if (imu_tid)   { k_thread_abort(imu_tid);   imu_tid   = NULL; shell_print(sh, "IMU worker stopped."); }
+	int rc = 0;
+
+	if (g_state == RUN_STOPPED) {
+		shell_print(sh, "Not running.");
+		return 0;
+	}
+	if (g_state == RUN_RUNNING) {
+		rc = executor_park(sh);
+		if (rc < 0) return rc;	/* keep the state until the cycle parks; retry */
+	}
+	if (agg_enabled()) {
+		agg_emit();	/* executor parked: flush the partial window */
+	}
+	(void)sensor_sink_flush(&log_sink);
+	g_state = RUN_STOPPED;
+	shell_print(sh, "Logging stopped (overruns: %u).", sensor_period_overruns(&g_tick));
+	return rc;
+}
+
+/**
+ * @brief Shell cmd: stop then start (reloads persisted periods).
+ *
+ * @param sh	Shell instance.
+ * @param argc	Unused.
+ * @param argv	Unused.
+ * @return 0 on success.
+ */
+static int cmd_restart(const struct shell *sh, size_t argc, char **argv)
+{
+	int rc = cmd_stop_sensors(sh, argc, argv);
+
+	if (rc < 0) return rc;
+	return cmd_start_sensor(sh, argc, argv);
+}
+
+/**
+ * @brief Shell cmd: get/set per-sensor periods (`period [ht|press|imu] [ms]`).
+ *
+ * New periods are persisted to @ref SCHED_PATH and take effect immediately
+ * by re-rating the coordinator tick, without restarting any thread. The
+ * listing also reports the tick and the coordinator's overrun count.
+ *
+ * @param sh	Shell instance.
+ * @param argc	1: list all, 2: show one, 3: set one.
+ * @param argv	Sensor name and period.
+ * @return 0 on success, -EINVAL on bad arguments.
+ */
+static int cmd_period(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 1) {
+		for (int i = 0; i < HTPG_COUNT; i++) {
+			shell_print(sh, "%-5s %d ms", htpg_sensor_name(i), (int)atomic_get(&g_period_ms[i]));
+		}
+		shell_print(sh, "tick  %u ms, %u expiries, %u overruns", sched_tick_ms(),
+			    sensor_period_expiries(&g_tick), sensor_period_overruns(&g_tick));
+		return 0;
+	}
+
+	int id = -1;
+	for (int i = 0; i < HTPG_COUNT; i++) {
+		if (strcmp(argv[1], htpg_sensor_name(i)) == 0) id = i;
+	}
+	if (id < 0) {
+		shell_error(sh, "unknown sensor '%s' (see `sensors period`)", argv[1]);
+		return -EINVAL;
+	}
+
+	if (argc == 3) {
+		uint32_t ms;
+
+		if (!parse_u32(argv[2], &ms)) {
+			shell_error(sh, "usage: sensors period [<sensor> [<ms>]], ms a decimal number");
+			return -EINVAL;
+		}
+		ms = MAX(ms, (uint32_t)MIN_PERIOD_MS);
+		atomic_set(&g_period_ms[id], ms);
+		if (g_state == RUN_RUNNING) {
+			sensor_period_set(&g_tick, sched_tick_ms());
+		}
+		int rc = sched_save();
+		if (rc < 0) {
+			shell_warn(sh, "period not persisted (%d)", rc);
+		}
+	}
+	shell_print(sh, "%s %d ms", htpg_sensor_name(id), (int)atomic_get(&g_period_ms[id]));
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: configure the aggregation window.
+ *
+ * `agg` shows the window, `agg samples <n>` / `agg secs <t>` set a limit
+ * (a window closes at whichever limit comes first; 0 clears a limit) and
+ * `agg off` clears both, going back to one raw row per cycle. The current
+ * window is dropped on any change.
+ *
+ * @param sh	Shell instance.
+ * @param argc	1 to 3.
+ * @param argv	Sub-option and value.
+ * @return 0 on success, -EINVAL on bad arguments.
+ */
+static int cmd_agg(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t v;
+
+	if (argc == 2 && strcmp(argv[1], "off") == 0) {
+		atomic_clear(&g_agg_samples);
+		atomic_clear(&g_agg_secs);
+	} else if (argc == 3 && strcmp(argv[1], "samples") == 0 && parse_u32(argv[2], &v)) {
+		atomic_set(&g_agg_samples, (atomic_val_t)v);
+	} else if (argc == 3 && strcmp(argv[1], "secs") == 0 && parse_u32(argv[2], &v)) {
+		atomic_set(&g_agg_secs, (atomic_val_t)v);
+	} else if (argc != 1) {
+		shell_error(sh, "usage: sensors agg [off | samples <n> | secs <t>]");
+		return -EINVAL;
+	}
+	if (argc > 1) {
+		atomic_set(&agg_restart, 1);
+	}
+
+	if (!agg_enabled()) {
+		shell_print(sh, "aggregation off (raw rows)");
+	} else {
+		shell_print(sh, "aggregation window: %u samples, %u s (0 = no limit)",
+			    (uint32_t)atomic_get(&g_agg_samples), (uint32_t)atomic_get(&g_agg_secs));
+	}
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: configure change-only logging.
+ *
+ * `deadband` shows the settings, `deadband on|off` toggles it,
+ * `deadband <t|h|p|accel|gyro> <delta>` sets a group threshold in the
+ * channel's unit (0: the group never triggers a row by itself) and
+ * `deadband heartbeat <s>` bounds the gap between rows (0: no heartbeat).
+ *
+ * @param sh	Shell instance.
+ * @param argc	1 to 3.
+ * @param argv	Sub-option and value.
+ * @return 0 on success, -EINVAL on bad arguments.
+ */
+static int cmd_deadband(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 2 && (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0)) {
+		atomic_set(&g_db_on, argv[1][1] == 'n');
+		atomic_set(&db_restart, 1);
+	} else if (argc == 3 && strcmp(argv[1], "heartbeat") == 0) {
+		uint32_t s;
+
+		if (!parse_u32(argv[2], &s)) {
+			shell_error(sh, "usage: sensors deadband heartbeat <s>");
+			return -EINVAL;
+		}
+		atomic_set(&g_db_heartbeat_s, (atomic_val_t)s);
+	} else if (argc == 3) {
+		int	id = -1;
+		int32_t	thr;
+
+		for (int i = 0; i < DB_COUNT; i++) {
+			if (strcmp(argv[1], db_name[i]) == 0) id = i;
+		}
+		if (id < 0 || sensor_fixp_parse(argv[2], &thr) < 0 || thr < 0) {
+			shell_error(sh, "usage: sensors deadband [on|off | t|h|p|accel|gyro <delta> | heartbeat <s>]");
+			return -EINVAL;
+		}
+		atomic_set(&g_db_thr[id], thr);
+	} else if (argc != 1) {
+		shell_error(sh, "usage: sensors deadband [on|off | t|h|p|accel|gyro <delta> | heartbeat <s>]");
+		return -EINVAL;
+	}
 
-	/* drain sems for a clean next start */
-	while (k_sem_count_get(&semHT)    > 0) k_sem_take(&semHT,    K_NO_WAIT);
-	while (k_sem_count_get(&semPress) > 0) k_sem_take(&semPress, K_NO_WAIT);
-	while (k_sem_count_get(&semGyro)  > 0) k_sem_take(&semGyro,  K_NO_WAIT);
-	while (k_sem_count_get(&semDone)  > 0) k_sem_take(&semDone,  K_NO_WAIT);
+	shell_print(sh, "deadband %s, heartbeat %u s, %u rows suppressed",
+		    atomic_get(&g_db_on) ? "on" : "off",
+		    (uint32_t)atomic_get(&g_db_heartbeat_s), db_suppressed);
+	for (int i = 0; i < DB_COUNT; i++) {
+		atomic_val_t thr = atomic_get(&g_db_thr[i]);
 
+		shell_print(sh, "  %-5s " SENSOR_FIXP_FMT, db_name[i], SENSOR_FIXP_ARG(thr, 3));
+	}
 	return 0;
 }
 
 /**
- * @brief Shell cmd: delete the sensor log file.
+ * @brief Shell cmd: print the latest snapshot.
  *
- * Removes @ref SENSOR_PATH; ignores ENOENT (already absent).
+ * Reads @ref g_sd through the sequence lock, so it never delays a worker.
+ *
+ * @param sh	Shell instance.
+ * @param argc	Unused.
+ * @param argv	Unused.
+ * @return 0 on success.
+ */
+static int cmd_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	struct htpg_sample snap;
+	snapshot_get(&snap);
+
+	shell_print(sh, "HT[%c] T=" SENSOR_FIXP_FMT "C H=" SENSOR_FIXP_FMT "%% | P[%c]="
+		SENSOR_FIXP_FMT "kPa | IMU[%c] A=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ","
+		SENSOR_FIXP_FMT ") G=(" SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT "," SENSOR_FIXP_FMT ")",
+		(snap.ok & BIT(HTPG_HT)) ? 'Y' : 'N',
+		SENSOR_FIXP_ARG(snap.ht.temp, 2), SENSOR_FIXP_ARG(snap.ht.hum, 2),
+		(snap.ok & BIT(HTPG_PRESS)) ? 'Y' : 'N',
+		SENSOR_FIXP_ARG(snap.press.press, 2),
+		(snap.ok & BIT(HTPG_IMU)) ? 'Y' : 'N',
+		SENSOR_FIXP_ARG(snap.imu.accel[0], 2), SENSOR_FIXP_ARG(snap.imu.accel[1], 2),
+		SENSOR_FIXP_ARG(snap.imu.accel[2], 2), SENSOR_FIXP_ARG(snap.imu.gyro[0], 2),
+		SENSOR_FIXP_ARG(snap.imu.gyro[1], 2), SENSOR_FIXP_ARG(snap.imu.gyro[2], 2));
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: delete every segment of the sensor log.
+ *
+ * Commits @ref log_sink, then removes all @ref SENSOR_PATH segments. The
+ * next row starts again at segment 0.
  *
  * @param shell	Shell instance.
  * @param argc	Unused.
@@ -368,24 +1525,176 @@ static int cmd_clear_logs(const struct shell *shell, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
 
-	int ret = fs_unlink(SENSOR_PATH);
-	if (ret < 0 && ret != -ENOENT) {
-		shell_fprintf(shell, SHELL_ERROR, "Failed to remove %s (%d)\n", SENSOR_PATH, ret);
+	int ret = sensor_sink_clear(&log_sink);
+	if (ret < 0) {
+		shell_fprintf(shell, SHELL_ERROR, "Failed to remove %s.* (%d)\n", SENSOR_PATH, ret);
 		return ret;
 	}
-	shell_fprintf(shell, SHELL_NORMAL, "Log cleared: %s\n", SENSOR_PATH);
+	shell_fprintf(shell, SHELL_NORMAL, "Log cleared: %s.*\n", SENSOR_PATH);
 	return 0;
 }
 
+/** @brief State of `sensors cat` across segments. */
+struct cat_ctx {
+	const struct shell	*sh;		/**< Output. */
+	size_t			left;		/**< Bytes still to print. */
+	int			count;		/**< Records printed (binary log). */
+};
+
+#if defined(CONFIG_APP_LOG_BINARY)
+/** @brief sensor_rec_dump() / sensor_pack_dump() line sink: one shell line. */
+static void cat_print(void *ctx, const char *line)
+{
+	shell_print((const struct shell *)ctx, "%s", line);
+}
+
+/** @brief sensor_sink_for_each() callback: one segment decoded to CSV. */
+static int cat_file(const char *path, void *arg)
+{
+	struct cat_ctx *c = arg;
+#if defined(CONFIG_APP_LOG_PACK)
+	int rc = sensor_pack_dump(&log_pack, path, log_hdr, log_hdr_len, &c->left, cat_print,
+				  (void *)c->sh);
+#else
+	int rc = sensor_rec_dump(path, log_hdr, log_hdr_len, log_types, ARRAY_SIZE(log_types),
+				 &c->left, cat_print, (void *)c->sh);
+#endif
+
+	if (rc < 0) return rc;
+	c->count += rc;
+	return c->left == 0;
+}
+#else
+/** @brief sensor_sink_for_each() callback: one segment as stored. */
+static int cat_file(const char *path, void *arg)
+{
+	struct cat_ctx		*c = arg;
+	struct fs_file_t	file;
+	char			buf[128];
+	ssize_t			rd;
+	int			rc;
+
+	fs_file_t_init(&file);
+	rc = fs_open(&file, path, FS_O_READ);
+	if (rc < 0) return rc;
+
+	while (c->left > 0 && (rd = fs_read(&file, buf, MIN(c->left, sizeof(buf)))) > 0) {
+		shell_fprintf(c->sh, SHELL_NORMAL, "%.*s", (int)rd, buf);
+		c->left -= rd;
+	}
+	fs_close(&file);
+	return c->left == 0;
+}
+#endif
+
+/**
+ * @brief Shell cmd: print the log (`cat [max_bytes]`), records decoded to CSV.
+ *
+ * Flushes @ref log_sink first, so rows still in RAM are included, then
+ * prints the segments oldest first; each starts with its column headers.
+ *
+ * @param sh	Shell instance.
+ * @param argc	1 or 2.
+ * @param argv	Optional byte limit (record bytes for a binary log).
+ * @return 0 on success, negative errno on failure.
+ */
+static int cmd_cat(const struct shell *sh, size_t argc, char **argv)
+{
+	struct cat_ctx	c = {
+		.sh = sh,
+		.left = (argc == 2) ? strtoul(argv[1], NULL, 10) : SIZE_MAX,
+	};
+	int		rc;
+
+	(void)sensor_sink_flush(&log_sink);
+#if defined(CONFIG_APP_LOG_BINARY)
+	log_hdr_init();
+#endif
+	rc = sensor_sink_for_each(&log_sink, cat_file, &c);
+	if (rc < 0) {
+		shell_error(sh, "cat %s failed (%d)", SENSOR_PATH, rc);
+		return rc;
+	}
+	if (IS_ENABLED(CONFIG_APP_LOG_BINARY)) {
+		shell_print(sh, "%d records", c.count);
+	}
+	return 0;
+}
+
+/**
+ * @brief Shell cmd: log buffer counters (`sink`), or commit it now (`sink flush`).
+ *
+ * @param sh	Shell instance.
+ * @param argc	1 or 2.
+ * @param argv	Optional "flush".
+ * @return 0 on success, -EINVAL on unknown argument, negative errno on a
+ *         failed flush.
+ */
+static int cmd_sink(const struct shell *sh, size_t argc, char **argv)
+{
+	struct sensor_sink_stats	st;
+	size_t				fill;
+	int				rc = 0;
+
+	if (argc == 2) {
+		if (strcmp(argv[1], "flush") != 0) {
+			shell_error(sh, "usage: sensors sink [flush]");
+			return -EINVAL;
+		}
+		rc = sensor_sink_flush(&log_sink);
+	}
+
+	sensor_sink_get_stats(&log_sink, &st, &fill);
+	shell_print(sh, "%s: %u rows, %u B; %u B in RAM of %u, flush after %u ms",
+		    SENSOR_PATH, st.appends, st.bytes, (uint32_t)fill,
+		    CONFIG_APP_LOG_BUF_SIZE, CONFIG_APP_LOG_FLUSH_MS);
+	shell_print(sh, "%u fs_write, %u fs_sync, %u fs_open, %u errors, %u B dropped",
+		    st.writes, st.syncs, st.opens, st.errors, st.dropped);
+
+	uint32_t	first, last;
+	int		segs = sensor_sink_segments(&log_sink, &first, &last);
+
+	if (segs > 0) {
+		shell_print(sh, "%d segments (%u..%u) of %u B, budget %u B; %u rotations, %u removed",
+			    segs, first, last, CONFIG_APP_LOG_SEG_SIZE, CONFIG_APP_LOG_BUDGET,
+			    st.rotations, st.removed);
+	}
+#if defined(CONFIG_APP_LOG_PACK)
+	struct sensor_pack_stats	ps;
+
+	sensor_pack_get_stats(&log_pack, &ps);
+	if (ps.records && ps.out) {
+		uint32_t	x100 = (uint32_t)((uint64_t)ps.in * 100 / ps.out);
+
+		shell_print(sh, "packed %u B -> %u B (deltas %u B), x%u.%02u; "
+			    "%u cycles/record, max %u, %u restarts",
+			    ps.in, ps.out, ps.delta, x100 / 100, x100 % 100,
+			    (uint32_t)(ps.cycles / ps.records), ps.max_cycles, ps.restarts);
+	}
+#endif
+	return rc;
+}
+
 /* ------------ shell reg ------------ */
-/** @brief Subcommands for `sensors` top-level shell command. */
-SHELL_STATIC_SUBCMD_SET_CREATE(sub_sensors,
-	SHELL_CMD(start_sensors,	NULL, "Start periodic sensor logging",	cmd_start_sensor),
-	SHELL_CMD(stop_sensors,		NULL, "Stop sensor logging",		cmd_stop_sensors),
-	SHELL_CMD(clear_logs,		NULL, "Clear sensor log file",		cmd_clear_logs),
-	SHELL_SUBCMD_SET_END
-);
+/**
+ * @brief Subcommands for `sensors` top-level shell command.
+ *
+ * Other modules (e.g. imu_capture.c) extend this set with SHELL_SUBCMD_ADD.
+ */
+SHELL_SUBCMD_SET_CREATE(sub_sensors, (sensors));
+
+SHELL_SUBCMD_ADD((sensors), start_sensors,	NULL, "Start periodic sensor logging",	cmd_start_sensor, 0, 0);
+SHELL_SUBCMD_ADD((sensors), stop_sensors,	NULL, "Stop sensor logging",		cmd_stop_sensors, 0, 0);
+SHELL_SUBCMD_ADD((sensors), pause,		NULL, "Pause sensor logging",		cmd_pause, 0, 0);
+SHELL_SUBCMD_ADD((sensors), resume,		NULL, "Resume paused logging",		cmd_resume, 0, 0);
+SHELL_SUBCMD_ADD((sensors), restart,		NULL, "Stop + start (reload config)",	cmd_restart, 0, 0);
+SHELL_SUBCMD_ADD((sensors), clear_logs,		NULL, "Remove all sensor log segments",	cmd_clear_logs, 0, 0);
+SHELL_SUBCMD_ADD((sensors), cat,		NULL, "Print the log [max_bytes]",	cmd_cat, 1, 1);
+SHELL_SUBCMD_ADD((sensors), sink,		NULL, "Log buffer counters [flush]",	cmd_sink, 1, 1);
+SHELL_SUBCMD_ADD((sensors), show,		NULL, "Print latest snapshot",		cmd_show, 0, 0);
+SHELL_SUBCMD_ADD((sensors), agg,		NULL, "Aggregation [off|samples <n>|secs <t>]", cmd_agg, 1, 2);
+SHELL_SUBCMD_ADD((sensors), deadband,		NULL, "Change-only logging settings",	cmd_deadband, 1, 2);
+SHELL_SUBCMD_ADD((sensors), period,		NULL, "Get/set period [<sensor>] [ms]", cmd_period, 1, 2);
 
 /** @brief Register `sensors` shell command group. */
 SHELL_CMD_REGISTER(sensors, &sub_sensors, "Sensor logging commands", NULL);
-
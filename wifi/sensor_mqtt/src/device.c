@@ -8,17 +8,17 @@
 LOG_MODULE_REGISTER(app_device, LOG_LEVEL_DBG);
 
 #include <zephyr/kernel.h>
-#include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/led.h>
 #include <zephyr/random/random.h>
+#include <zephyr/zbus/zbus.h>
 
 #include "device.h"
+#include "sensor_bus.h"
+#include "sensor_fixp.h"
 
-#define SENSOR_CHAN     SENSOR_CHAN_AMBIENT_TEMP
 #define SENSOR_UNIT     "Celsius"
 
-/* Devices */
-static const struct device *sensor = DEVICE_DT_GET_OR_NULL(DT_ALIAS(ambient_temp0));
+/* Devices (the temperature sensor is owned by the sensor_bus service) */
 static const struct device *leds = DEVICE_DT_GET_OR_NULL(DT_INST(0, gpio_leds));
 
 /* Command handlers */
@@ -52,35 +52,45 @@ void device_command_handler(uint8_t *command)
 	LOG_ERR("Unknown command: %s", command);
 }
 
+/* Render a micro-unit value into the sample's JSON number token */
+static void sample_set_value(struct sensor_sample *sample, int32_t micro)
+{
+	int len = snprintk(sample->value_buf, sizeof(sample->value_buf),
+			   SENSOR_FIXP_FMT, SENSOR_FIXP_ARG(micro, 2));
+
+	sample->unit = SENSOR_UNIT;
+	sample->value.start = sample->value_buf;
+	sample->value.length = MIN((size_t)len, sizeof(sample->value_buf) - 1);
+}
+
 int device_read_sensor(struct sensor_sample *sample)
 {
+	struct sensor_bus_sample s;
 	int rc;
-	struct sensor_value sensor_val;
 
-	/* Read sample only if a real sensor device is present
-	 * otherwise return a dummy value
+	/* Use the latest sample published by the acquisition service;
+	 * without a temperature source return a dummy value
 	 */
-	if (sensor == NULL) {
-		sample->unit = SENSOR_UNIT;
-		sample->value = 20.0 + (double)sys_rand32_get() / UINT32_MAX * 5.0;
+	if (!(sensor_bus_present() & SENSOR_BUS_TEMP)) {
+		sample_set_value(sample, 20 * SENSOR_FIXP_ONE +
+				 (int32_t)(((uint64_t)sys_rand32_get() * 5U * SENSOR_FIXP_ONE) /
+					   UINT32_MAX));
 		return 0;
 	}
 
-	rc = sensor_sample_fetch(sensor);
+	rc = zbus_chan_read(&sensor_bus_chan, &s, K_MSEC(100));
 	if (rc) {
-		LOG_ERR("Failed to fetch sensor sample [%d]", rc);
+		LOG_ERR("Failed to read sensor channel [%d]", rc);
 		return rc;
 	}
 
-	rc = sensor_channel_get(sensor, SENSOR_CHAN, &sensor_val);
-	if (rc) {
-		LOG_ERR("Failed to get sensor channel [%d]", rc);
-		return rc;
+	if (!(s.valid & SENSOR_BUS_TEMP)) {
+		LOG_ERR("No valid temperature sample yet");
+		return -EAGAIN;
 	}
 
-	sample->unit = SENSOR_UNIT;
-	sample->value = sensor_value_to_double(&sensor_val);
-	return rc;
+	sample_set_value(sample, s.temp);
+	return 0;
 }
 
 int device_write_led(enum led_id led_idx, enum led_state state)
@@ -115,16 +125,7 @@ bool devices_ready(void)
 {
 	bool rc = true;
 
-	/* Check readiness only if a real sensor device is present */
-	if (sensor != NULL) {
-		if (!device_is_ready(sensor)) {
-			LOG_ERR("Device %s is not ready", sensor->name);
-			rc = false;
-		} else {
-			LOG_INF("Device %s is ready", sensor->name);
-		}
-	}
-
+	/* Sensor readiness is checked by sensor_bus_start() */
 	if (leds != NULL) {
 		if (!device_is_ready(leds)) {
 			LOG_ERR("Device %s is not ready", leds->name);
@@ -7,10 +7,17 @@
 #ifndef __DEVICE_H__
 #define __DEVICE_H__
 
-/** @brief Sensor sample structure */
+#include <zephyr/data/json.h>
+
+/** @brief Sensor sample structure
+ *
+ *  The value is kept as fixed-point decimal text (no float math) and
+ *  emitted verbatim as a JSON number.
+ */
 struct sensor_sample {
 	const char *unit;
-	int value;
+	struct json_obj_token value;
+	char value_buf[16];
 };
 
 /** @brief Available board LEDs */
@@ -12,9 +12,11 @@ LOG_MODULE_REGISTER(app_main, LOG_LEVEL_DBG);
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/net_mgmt.h>
 #include <zephyr/net/conn_mgr_monitor.h>
+#include <zephyr/zbus/zbus.h>
 
 #include "mqtt_client.h"
 #include "device.h"
+#include "sensor_bus.h"
 
 #define NET_L4_EVENT_MASK (NET_EVENT_L4_CONNECTED | NET_EVENT_L4_DISCONNECTED)
 
@@ -26,6 +28,9 @@ struct k_work_delayable mqtt_publish_work;
 
 static struct net_mgmt_event_callback net_l4_mgmt_cb;
 
+/* Publishes are driven by sensor_bus samples; periodic only without one */
+static bool sensor_bus_running;
+
 /* Network connection semaphore */
 K_SEM_DEFINE(net_conn_sem, 0, 1);
 
@@ -57,9 +62,11 @@ void log_mac_addr(struct net_if *iface)
 		mac->addr[3], mac->addr[4], mac->addr[5]);
 }
 
-/** The system work queue is used to handle periodic MQTT publishing.
- *  Work queuing begins when the MQTT connection is established.
- *  Use CONFIG_NET_SAMPLE_MQTT_PUBLISH_INTERVAL to set the publish frequency.
+/** The system work queue is used to handle MQTT publishing.
+ *  The sensor_bus service samples every CONFIG_NET_SAMPLE_MQTT_PUBLISH_INTERVAL
+ *  seconds and each new sample queues one publish, so a slow broker only
+ *  delays (and coalesces) publishes, never the sensor reads.
+ *  Without a sensor the work item re-queues itself at the same interval.
  */
 
 static void publish_work_handler(struct k_work *work)
@@ -71,13 +78,28 @@ static void publish_work_handler(struct k_work *work)
 		if (rc != 0) {
 			LOG_INF("MQTT Publish failed [%d]", rc);
 		}
-		k_work_reschedule(&mqtt_publish_work,
+		if (!sensor_bus_running) {
+			k_work_reschedule(&mqtt_publish_work,
 					K_SECONDS(CONFIG_NET_SAMPLE_MQTT_PUBLISH_INTERVAL));
+		}
 	} else {
 		k_work_cancel_delayable(&mqtt_publish_work);
 	}
 }
 
+/** zbus listener: runs in the acquisition thread, only queues the publish */
+static void sensor_sample_listener(const struct zbus_channel *chan)
+{
+	ARG_UNUSED(chan);
+
+	if (mqtt_connected) {
+		k_work_reschedule(&mqtt_publish_work, K_NO_WAIT);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(mqtt_sample_lis, sensor_sample_listener);
+ZBUS_CHAN_ADD_OBS(sensor_bus_chan, mqtt_sample_lis, 0);
+
 int main(void)
 {
 	int rc;
@@ -85,6 +107,15 @@ int main(void)
 
 	devices_ready();
 
+	/* Initialise MQTT publish work item before the first sample can arrive */
+	k_work_init_delayable(&mqtt_publish_work, publish_work_handler);
+
+	rc = sensor_bus_start(CONFIG_NET_SAMPLE_MQTT_PUBLISH_INTERVAL * MSEC_PER_SEC);
+	sensor_bus_running = (rc == 0);
+	if (rc != 0) {
+		LOG_INF("No sensor available, publishing dummy values [%d]", rc);
+	}
+
 	iface = net_if_get_default();
 	if (iface == NULL) {
 		LOG_ERR("No network interface configured");
@@ -120,17 +151,16 @@ int main(void)
 		return rc;
 	}
 
-	/* Initialise MQTT publish work item */
-	k_work_init_delayable(&mqtt_publish_work, publish_work_handler);
-
 	/* Thread main loop */
 	while (1) {
 		/* Block until MQTT connection is up */
 		app_mqtt_connect(&client_ctx);
 
-		/* We are now connected, begin queueing periodic MQTT publishes */
-		k_work_reschedule(&mqtt_publish_work,
+		/* We are now connected; the next sensor sample queues a publish */
+		if (!sensor_bus_running) {
+			k_work_reschedule(&mqtt_publish_work,
 					K_SECONDS(CONFIG_NET_SAMPLE_MQTT_PUBLISH_INTERVAL));
+		}
 
 		/* Handle MQTT inputs and connection */
 		app_mqtt_run(&client_ctx);